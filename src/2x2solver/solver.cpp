@@ -7,6 +7,7 @@
 #include <string>
 #include <sstream>
 #include <cstdlib>
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
 	postMessage(UTF8ToString(str));
@@ -83,34 +84,16 @@ std::unordered_map<std::string, State> moves = {
 	{"z'", State({1, 5, 6, 2, 0, 4, 7, 3}, {1, 2, 1, 2, 2, 1, 2, 1}, {3, 2, 0, 1, 4, 5})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'", "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<std::vector<int>> rotationMap =
@@ -523,7 +506,8 @@ struct search
 	int index2_tmp;
 	int prune_tmp;
 	std::string tmp;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 
 	search()
 	{
@@ -581,16 +565,16 @@ struct search
 							index2_tmp2 *= 27;
 						}
 					}
-					if (valid)
+					if (valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -629,7 +613,8 @@ struct search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -703,37 +688,13 @@ void buidMoveRestrict(const std::string &restID, std::vector<std::string> &move_
 	}
 }
 
-static std::string get_move_base(const std::string &move)
-{
-	if (move.empty())
-		return "";
-	return move.substr(0, 1);
-}
-
 static bool should_be_checked_by_default(const std::string &prev_move, const std::string &next_move)
 {
 	if (prev_move.empty())
 		return false;
-	const static std::map<std::string, int> y_axis_order = {{"U", 0}, {"D", 1}, {"y", 2}};
-	const static std::map<std::string, int> x_axis_order = {{"L", 0}, {"R", 1}, {"x", 2}};
-	const static std::map<std::string, int> z_axis_order = {{"F", 0}, {"B", 1}, {"z", 2}};
-	const static std::map<std::string, const std::map<std::string, int> *> base_to_axis_map = {
-		{"U", &y_axis_order}, {"D", &y_axis_order}, {"y", &y_axis_order}, {"L", &x_axis_order}, {"R", &x_axis_order}, {"x", &x_axis_order}, {"F", &z_axis_order}, {"B", &z_axis_order}, {"z", &z_axis_order}};
-	std::string prev_base = get_move_base(prev_move);
-	std::string next_base = get_move_base(next_move);
-	if (prev_base == next_base)
-		return true;
-	auto it_prev = base_to_axis_map.find(prev_base);
-	auto it_next = base_to_axis_map.find(next_base);
-	if (it_prev != base_to_axis_map.end() && it_next != base_to_axis_map.end() && it_prev->second == it_next->second)
-	{
-		const auto &axis_map = *it_prev->second;
-		if (axis_map.at(prev_base) > axis_map.at(next_base))
-		{
-			return true;
-		}
-	}
-	return false;
+	int prev = move_codec.id(prev_move.data(), prev_move.size());
+	int next = move_codec.id(next_move.data(), next_move.size());
+	return prev != -1 && next != -1 && move_codec.follows_out_of_order(prev, next);
 }
 
 void buidMA2(const std::string &restID, const std::string &mavString, std::vector<bool> &vector)
@@ -811,6 +772,19 @@ void buidMA2(const std::string &restID, const std::string &mavString, std::vecto
 			}
 		}
 	}
+	if (canonical_mode())
+	{
+		for (const auto &row_move : active_moves)
+		{
+			for (const auto &col_move : active_moves)
+			{
+				if (should_be_checked_by_default(row_move, col_move))
+				{
+					vector[move_to_index_map.at(row_move) * NUM_COLS + move_to_index_map.at(col_move)] = true;
+				}
+			}
+		}
+	}
 }
 
 void buildMoveCountVector(const std::string &restID, const std::string &moveCountString, std::vector<int> &move_count_vector)
@@ -893,4 +867,5 @@ void solve(std::string scramble, std::string rotation, int num, int len, int pru
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("solve", &solve);
+	emscripten::function("set_canonical_mode", &set_canonical_mode);
 }
@@ -8,9 +8,11 @@ const solverPromise = new Promise(resolve => {
 importScripts('solver.js');
 
 self.onmessage = async function (event) {
-	const { scr, rot, num, len, prune, move_restrict, post_alg, ma2, mcString } = event.data;
+	const { scr, rot, num, len, prune, move_restrict, post_alg, ma2, mcString, canonical } = event.data;
 	try {
 		const Module = await solverPromise;
+		// Skip solutions that differ from an earlier one only by commuting moves
+		Module.set_canonical_mode(!!canonical);
 		Module.solve(scr, rot, num, len, prune, move_restrict, post_alg, ma2, mcString);
 	} catch (e) {
 		console.error(e);
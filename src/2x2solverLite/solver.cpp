@@ -11,6 +11,7 @@
 #include <numeric>
 #include <random>
 #include <set>
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
 	postMessage(UTF8ToString(str));
@@ -62,34 +63,16 @@ std::unordered_map<std::string, State> moves = {
 	{"F'", State({0, 1, 6, 2, 4, 5, 7, 3}, {0, 0, 1, 2, 0, 0, 2, 1})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<std::vector<int>> c_array = {{0}, {1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 2, 4, 8, 16, 32}, {1, 3, 9, 27, 81, 243}};
@@ -278,6 +261,54 @@ void create_prune_table(int index, int size, const std::vector<int> &table, std:
 	}
 }
 
+inline int get_distance(const std::vector<unsigned char> &table, int i)
+{
+	return (table[i >> 1] >> ((i & 1) << 2)) & 15;
+}
+
+inline void set_distance(std::vector<unsigned char> &table, int i, int d)
+{
+	int shift = (i & 1) << 2;
+	table[i >> 1] = (table[i >> 1] & ~(15 << shift)) | (d << shift);
+}
+
+// Exact distance of every state with DBL fixed: index = cp_rank * 729 +
+// co_rank, two 4-bit entries per byte (1.8 MB), 15 = not reached. The ranks
+// number the CP / CO indices reachable with U, R and F (5040 / 729);
+// cp_index / co_index map them back.
+void create_distance_table(const std::vector<int> &cp_move_table, const std::vector<int> &co_move_table, const std::vector<int> &cp_rank, const std::vector<int> &co_rank, const std::vector<int> &cp_index, const std::vector<int> &co_index, std::vector<unsigned char> &distance_table)
+{
+	int size2 = co_index.size();
+	int size = cp_index.size() * size2;
+	distance_table = std::vector<unsigned char>((size + 1) / 2, 255);
+	set_distance(distance_table, cp_rank[0] * size2 + co_rank[0], 0);
+	int num = 1;
+	int next_i;
+	int index1_tmp;
+	int index2_tmp;
+	for (int d = 0; num > 0; ++d)
+	{
+		num = 0;
+		for (int i = 0; i < size; ++i)
+		{
+			if (get_distance(distance_table, i) == d)
+			{
+				index1_tmp = cp_index[i / size2] * 9;
+				index2_tmp = co_index[i % size2] * 9;
+				for (int j = 0; j < 9; ++j)
+				{
+					next_i = cp_rank[cp_move_table[index1_tmp + j]] * size2 + co_rank[co_move_table[index2_tmp + j]];
+					if (get_distance(distance_table, next_i) == 15)
+					{
+						set_distance(distance_table, next_i, d + 1);
+						num += 1;
+					}
+				}
+			}
+		}
+	}
+}
+
 const std::map<std::string, int> sticker_indices = {
 	{"U1", 0}, {"U2", 1}, {"U3", 2}, {"U4", 3}, {"R1", 4}, {"R2", 5}, {"R3", 6}, {"R4", 7}, {"F1", 8}, {"F2", 9}, {"F3", 10}, {"F4", 11}, {"D1", 12}, {"D2", 13}, {"D3", 14}, {"D4", 15}, {"L1", 16}, {"L2", 17}, {"L3", 18}, {"L4", 19}, {"B1", 20}, {"B2", 21}, {"B3", 22}, {"B4", 23}};
 
@@ -381,6 +412,13 @@ struct search
 	std::vector<int> co_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> prune_table2;
+	std::vector<unsigned char> distance_table;
+	std::vector<int> cp_rank;
+	std::vector<int> co_rank;
+	std::vector<int> cp_index;
+	std::vector<int> co_index;
+	int sol_num;
+	int count;
 	std::vector<int> alg;
 	int index1;
 	int index2;
@@ -399,10 +437,12 @@ struct search
 	search()
 	{
 		prune_table1 = std::vector<unsigned char>(40320, 255);
+		prune_table2 = std::vector<unsigned char>(2187, 255);
 		single_cp_move_table = create_cp_move_table();
 		cp_move_table = create_multi_move_table(8, 1, 8, 40320, single_cp_move_table);
 		co_move_table = create_co_move_table();
 		create_prune_table(0, 40320, cp_move_table, prune_table1);
+		create_prune_table(0, 2187, co_move_table, prune_table2);
 		std::random_device rd;
 		generator.seed(rd());
 		distribution_CP = std::uniform_int_distribution<>(0, 5039);
@@ -425,13 +465,16 @@ struct search
 				continue;
 			}
 			index2_tmp = co_move_table[arg_index2 + i];
+			if (prune_table2[index2_tmp] >= depth)
+			{
+				continue;
+			}
 			sol.emplace_back(i);
 			if (depth == 1)
 			{
 				if (prune1_tmp == 0 && index2_tmp == 0)
 				{
 					tmp = AlgToString(sol);
-					update(tmp.c_str());
 					return true;
 				}
 			}
@@ -444,6 +487,108 @@ struct search
 		return false;
 	}
 
+	// Reduced index of a state in the distance table
+	int table_index(int arg_index1, int arg_index2)
+	{
+		return cp_rank[arg_index1] * 729 + co_rank[arg_index2];
+	}
+
+	// Builds the exact distance table; solve, solveAll and getScrambles use it
+	// from then on instead of searching
+	void buildDistanceTable()
+	{
+		if (!distance_table.empty())
+		{
+			return;
+		}
+		cp_rank = std::vector<int>(40320, -1);
+		co_rank = std::vector<int>(2187, -1);
+		for (int i = 0; i < 40320; ++i)
+		{
+			if (prune_table1[i] != 255)
+			{
+				cp_rank[i] = cp_index.size();
+				cp_index.emplace_back(i);
+			}
+		}
+		for (int i = 0; i < 2187; ++i)
+		{
+			if (prune_table2[i] != 255)
+			{
+				co_rank[i] = co_index.size();
+				co_index.emplace_back(i);
+			}
+		}
+		create_distance_table(cp_move_table, co_move_table, cp_rank, co_rank, cp_index, co_index, distance_table);
+	}
+
+	// Optimal solution by descent: each step takes the first move that lowers
+	// the distance, which gives the same solution as the IDA* search
+	void table_descent(int arg_index1, int arg_index2)
+	{
+		sol.clear();
+		int d = get_distance(distance_table, table_index(arg_index1, arg_index2));
+		int prev = 3;
+		while (d > 0)
+		{
+			for (int i = 0; i < 9; ++i)
+			{
+				if (prev < 3 && i / 3 == prev)
+				{
+					continue;
+				}
+				index1_tmp = cp_move_table[arg_index1 * 9 + i];
+				index2_tmp = co_move_table[arg_index2 * 9 + i];
+				if (get_distance(distance_table, table_index(index1_tmp, index2_tmp)) == d - 1)
+				{
+					sol.emplace_back(i);
+					arg_index1 = index1_tmp;
+					arg_index2 = index2_tmp;
+					prev = i / 3;
+					d--;
+					break;
+				}
+			}
+		}
+		tmp = AlgToString(sol);
+	}
+
+	// Every solution of exactly depth moves, bounded by the exact distances
+	bool table_search(int arg_index1, int arg_index2, int depth, int prev)
+	{
+		for (int i = 0; i < 9; ++i)
+		{
+			if (prev < 3 && i / 3 == prev)
+			{
+				continue;
+			}
+			index1_tmp = cp_move_table[arg_index1 * 9 + i];
+			index2_tmp = co_move_table[arg_index2 * 9 + i];
+			int d = get_distance(distance_table, table_index(index1_tmp, index2_tmp));
+			if (d >= depth)
+			{
+				continue;
+			}
+			sol.emplace_back(i);
+			if (depth == 1)
+			{
+				count += 1;
+				tmp = AlgToString(sol);
+				update(tmp.c_str());
+				if (count == sol_num)
+				{
+					return true;
+				}
+			}
+			else if (table_search(index1_tmp, index2_tmp, depth - 1, i / 3))
+			{
+				return true;
+			}
+			sol.pop_back();
+		}
+		return false;
+	}
+
 	void start_search(int arg_index1, int arg_index2)
 	{
 		sol.clear();
@@ -455,6 +600,11 @@ struct search
 		{
 			update("Solved");
 		}
+		else if (!distance_table.empty() && cp_rank[index1] != -1 && co_rank[index2] != -1)
+		{
+			table_descent(index1, index2);
+			update(tmp.c_str());
+		}
 		else
 		{
 			index1 *= 9;
@@ -463,6 +613,7 @@ struct search
 			{
 				if (depth_limited_search(index1, index2, d, 3))
 				{
+					update(tmp.c_str());
 					break;
 				}
 			}
@@ -486,42 +637,80 @@ struct search
 		}
 	}
 
-	void getScramble()
+	// Up to arg_sol_num solutions of at most arg_max_length moves, shortest
+	// first, walking the distance table (built on first use)
+	void solveAll(std::string defString, int arg_sol_num, int arg_max_length)
 	{
+		buildDistanceTable();
+		cp.resize(8);
+		co.resize(8);
+		getStateVector(defString, cp, co);
+		index1 = array_to_index(cp, 8, 1, 8);
+		index2 = o_to_index(co, 3, 8);
+		if (!isSolvable(co) || cp_rank[index1] == -1 || co_rank[index2] == -1)
+		{
+			update("Error");
+			return;
+		}
+		if (index1 == 0 && index2 == 0)
+		{
+			update("Solved");
+			return;
+		}
 		sol.clear();
-		while (true)
+		sol_num = arg_sol_num;
+		count = 0;
+		for (int d = get_distance(distance_table, table_index(index1, index2)); d <= arg_max_length; d++)
 		{
-			int index1_tmp2 = distribution_CP(generator);
-			int index2_tmp2 = distribution_CO(generator);
-			cp.resize(7);
-			index_to_array(cp, index1_tmp2, 7, 1, 8);
-			for (int i = 0; i < 7; ++i)
+			if (table_search(index1, index2, d, 3))
 			{
-				cp[i] /= 9;
-			}
-			std::set<int> currentSet(cp.begin(), cp.end());
-			std::vector<int> missing;
-			std::set_difference(fullSet.begin(), fullSet.end(), currentSet.begin(), currentSet.end(), std::back_inserter(missing));
-			auto it = std::find(cp.begin(), cp.end(), 4);
-			if (it == cp.end())
-			{
-				cp.insert(cp.begin() + 4, 4);
+				break;
 			}
-			else
+		}
+	}
+
+	// Uniform random state with DBL fixed, into index1 / index2
+	void random_state()
+	{
+		int index1_tmp2 = distribution_CP(generator);
+		int index2_tmp2 = distribution_CO(generator);
+		cp.resize(7);
+		index_to_array(cp, index1_tmp2, 7, 1, 8);
+		for (int i = 0; i < 7; ++i)
+		{
+			cp[i] /= 9;
+		}
+		std::set<int> currentSet(cp.begin(), cp.end());
+		std::vector<int> missing;
+		std::set_difference(fullSet.begin(), fullSet.end(), currentSet.begin(), currentSet.end(), std::back_inserter(missing));
+		auto it = std::find(cp.begin(), cp.end(), 4);
+		if (it == cp.end())
+		{
+			cp.insert(cp.begin() + 4, 4);
+		}
+		else
+		{
+			int index = std::distance(cp.begin(), it);
+			cp.erase(it);
+			if (!missing.empty())
 			{
-				int index = std::distance(cp.begin(), it);
-				cp.erase(it);
-				if (!missing.empty())
-				{
-					cp.insert(cp.begin() + index, missing[0]);
-				}
-				cp.insert(cp.begin() + 4, 4);
+				cp.insert(cp.begin() + index, missing[0]);
 			}
-			co.resize(7);
-			index_to_o(co, index2_tmp2, 3, 7);
-			co.insert(co.begin() + 4, 0);
-			index1 = array_to_index(cp, 8, 1, 8);
-			index2 = o_to_index(co, 3, 8);
+			cp.insert(cp.begin() + 4, 4);
+		}
+		co.resize(7);
+		index_to_o(co, index2_tmp2, 3, 7);
+		co.insert(co.begin() + 4, 0);
+		index1 = array_to_index(cp, 8, 1, 8);
+		index2 = o_to_index(co, 3, 8);
+	}
+
+	void getScramble()
+	{
+		sol.clear();
+		while (true)
+		{
+			random_state();
 			prune1_tmp = prune_table1[index1];
 			if (prune1_tmp == 0 && index2 == 0)
 			{
@@ -532,16 +721,83 @@ struct search
 				break;
 			}
 		}
+		if (!distance_table.empty())
+		{
+			table_descent(index1, index2);
+			update(tmp.c_str());
+			return;
+		}
 		index1 *= 9;
 		index2 *= 9;
 		for (int d = prune1_tmp; d <= 11; d++)
 		{
 			if (depth_limited_search(index1, index2, d, 3))
 			{
+				update(tmp.c_str());
 				break;
 			}
 		}
 	}
+
+	// count random-state scrambles whose optimal length is within
+	// [min_length, max_length], one per line. States whose CP / CO prune
+	// bound already exceeds max_length are rejected before any search; the
+	// rest are searched only up to max_length. With the distance table a draw
+	// is a random table entry (one lookup) and a hit one descent. Stops after
+	// count * 10000 draws, so a range that is (nearly) empty returns fewer
+	// lines.
+	std::string getScrambles(int count, int min_length, int max_length)
+	{
+		std::string ret;
+		min_length = std::max(min_length, 1);
+		max_length = std::min(max_length, 11);
+		if (count <= 0 || min_length > max_length)
+		{
+			return ret;
+		}
+		int made = 0;
+		long long draws = static_cast<long long>(count) * 10000;
+		std::uniform_int_distribution<> distribution_table(0, 5040 * 729 - 1);
+		while (made < count && draws-- > 0)
+		{
+			if (!distance_table.empty())
+			{
+				int i = distribution_table(generator);
+				int d = get_distance(distance_table, i);
+				if (d >= min_length && d <= max_length)
+				{
+					table_descent(cp_index[i / 729], co_index[i % 729]);
+					ret += tmp + "\n";
+					made++;
+				}
+				continue;
+			}
+			random_state();
+			if (index1 == 0 && index2 == 0)
+			{
+				continue;
+			}
+			int lower = std::max(prune_table1[index1], prune_table2[index2]);
+			if (lower > max_length)
+			{
+				continue;
+			}
+			for (int d = lower; d <= max_length; d++)
+			{
+				sol.clear();
+				if (depth_limited_search(index1 * 9, index2 * 9, d, 3))
+				{
+					if (d >= min_length)
+					{
+						ret += tmp + "\n";
+						made++;
+					}
+					break;
+				}
+			}
+		}
+		return ret;
+	}
 };
 
 EMSCRIPTEN_BINDINGS(my_module)
@@ -549,5 +805,8 @@ EMSCRIPTEN_BINDINGS(my_module)
 	emscripten::class_<search>("search")
 		.constructor<>()
 		.function("solve", &search::solve)
-		.function("getScramble", &search::getScramble);
+		.function("getScramble", &search::getScramble)
+		.function("getScrambles", &search::getScrambles)
+		.function("buildDistanceTable", &search::buildDistanceTable)
+		.function("solveAll", &search::solveAll);
 }
\ No newline at end of file
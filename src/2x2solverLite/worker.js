@@ -16,12 +16,25 @@ const initPromise = new Promise((resolve, reject) => {
 
 importScripts('solver.js');
 
+// { defString }: one optimal solution. { defString, solNum, maxLength }:
+// up to solNum solutions, shortest first, from the exact distance table.
+// { useTable: true } builds the table, after which every solve is a lookup.
 self.onmessage = async function (event) {
-	const { defString } = event.data;
+	const { defString, solNum, maxLength, useTable } = event.data;
 	try {
 		await initPromise;
 		if (searchInstance) {
-			ret = searchInstance.solve(defString);
+			if (useTable) {
+				searchInstance.buildDistanceTable();
+			}
+			if (defString === undefined) {
+				return;
+			}
+			if (solNum) {
+				ret = searchInstance.solveAll(defString, solNum, maxLength || 11);
+			} else {
+				ret = searchInstance.solve(defString);
+			}
 		}
 	} catch (e) {
 		console.error(e);
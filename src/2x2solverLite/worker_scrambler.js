@@ -16,11 +16,18 @@ const initPromise = new Promise((resolve, reject) => {
 
 importScripts('solver.js');
 
+// No data: one scramble, posted by the module. { count, min, max }: count
+// scrambles with optimal length in [min, max], posted as one string, one per line.
 self.onmessage = async function (event) {
 	try {
 		await initPromise;
 		if (searchInstance) {
-			ret = searchInstance.getScramble();
+			const { count, min, max } = event.data || {};
+			if (count) {
+				self.postMessage(searchInstance.getScrambles(count, min || 1, max || 11));
+			} else {
+				ret = searchInstance.getScramble();
+			}
 		}
 	} catch (e) {
 		console.error(e);
@@ -9,6 +9,12 @@
 #include <cstdlib>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
+#include "../corpus_stats.h"
+#include "../twophase/two_phase.h"
 
 int analyzer_count = 0;
 
@@ -94,34 +100,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -590,6 +578,31 @@ std::vector<bool> create_ma_table()
 	return ma;
 }
 
+// Corpus mode (analyze_corpus / analyze_random / analyze_random_moves, see
+// ../corpus_stats.h):
+// while corpus is set, rows are aggregated there instead of being posted.
+corpus_stats *corpus = nullptr;
+
+void post(const char *str)
+{
+	if (!corpus)
+	{
+		update(str);
+	}
+}
+
+void emit_row(const std::string &slot, const std::string &result, const std::vector<double> &lengths)
+{
+	if (corpus)
+	{
+		corpus->record(slot, lengths);
+	}
+	else
+	{
+		update((result + "</tr>").c_str());
+	}
+}
+
 struct cross_analyzer
 {
 	std::vector<int> sol;
@@ -598,9 +611,9 @@ struct cross_analyzer
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
+	TableRef<int> edge_move_table;
 	std::vector<int> eo_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
@@ -619,8 +632,11 @@ struct cross_analyzer
 
 	cross_analyzer()
 	{
-		edge_move_table = create_edge_move_table();
-		multi_move_table = create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table/2", [&]()
+		{
+			return create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		});
 		index1 = 416;
 		index2 = 520;
 		prune_table = create_prune_table(index1, index2, 24 * 22, 24 * 22, 10, multi_move_table, multi_move_table);
@@ -630,6 +646,10 @@ struct cross_analyzer
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index_eo, int depth, int prev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -722,6 +742,8 @@ struct cross_analyzer
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">None</th>";
+		std::string label = "None";
+		std::vector<double> lengths;
 		move_restrict.clear();
 		for (std::string name : restrict)
 		{
@@ -748,6 +770,7 @@ struct cross_analyzer
 			prune_tmp = prune_table[index1 * 528 + index2];
 			if (prune_tmp == 0 && index_eo == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -763,6 +786,11 @@ struct cross_analyzer
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -775,7 +803,7 @@ struct cross_analyzer
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 };
 
@@ -790,16 +818,22 @@ struct xcross_analyzer2
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
+	TableRef<int> edge_move_table;
 	std::vector<int> dep_move_table;
 	std::vector<int> eo_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> prune_table2;
 	std::vector<unsigned char> prune_table3;
 	std::vector<unsigned char> prune_table4;
 	std::vector<unsigned char> prune_table_dep_eo;
+	std::vector<int> pair_move_table;
+	std::vector<std::vector<unsigned char>> prune_table_slot_eo;
+	bool use_slot_eo;
+	const unsigned char *slot_eo1;
+	const unsigned char *slot_eo2;
+	const unsigned char *slot_eo3;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -833,15 +867,19 @@ struct xcross_analyzer2
 	int prune2_tmp;
 	int prune3_tmp;
 	int prune_dep_eo_tmp;
+	int prune_slot_eo_tmp;
 	int total_length;
 	std::vector<int> sol_len;
 	int current_max_depth;
 
 	xcross_analyzer2()
 	{
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("analyzer/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table2/4", [&]()
+		{
+			return create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		});
 		ma = create_ma_table();
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -860,10 +898,57 @@ struct xcross_analyzer2
 		index_eo = 0;
 		prune_table_dep_eo = std::vector<unsigned char>(12 * 11 * 10 * 9 * 2048, 255);
 		create_prune_table3(index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 11, dep_move_table, eo_move_table, prune_table_dep_eo);
+		use_slot_eo = false;
+		slot_eo1 = nullptr;
+		slot_eo2 = nullptr;
+		slot_eo3 = nullptr;
+	}
+
+	// Composite EO + slot heuristic: slot edge (24) x slot corner (24) x EO
+	// (2048) for each slot. The tables are built the first time it is enabled.
+	void enable_slot_eo(bool enable)
+	{
+		use_slot_eo = enable;
+		if (!enable || !prune_table_slot_eo.empty())
+		{
+			return;
+		}
+		pair_move_table = std::vector<int>(24 * 24 * 18);
+		for (int e = 0; e < 24; ++e)
+		{
+			for (int c = 0; c < 24; ++c)
+			{
+				for (int j = 0; j < 18; ++j)
+				{
+					pair_move_table[(e * 24 + c) * 18 + j] = edge_move_table[e * 18 + j] * 24 + corner_move_table[c * 18 + j];
+				}
+			}
+		}
+		std::vector<int> single_edge_index = {0, 2, 4, 6};
+		std::vector<int> corner_index = {12, 15, 18, 21};
+		prune_table_slot_eo.assign(4, std::vector<unsigned char>(24 * 24 * 2048, 255));
+		for (int slot = 0; slot < 4; ++slot)
+		{
+			create_prune_table3(single_edge_index[slot] * 24 + corner_index[slot], 0, 24 * 24, 2048, 12, pair_move_table, eo_move_table, prune_table_slot_eo[slot]);
+		}
+	}
+
+	const unsigned char *slot_eo_table(int slot)
+	{
+		return use_slot_eo ? prune_table_slot_eo[slot].data() : nullptr;
+	}
+
+	static int slot_eo_prune(const unsigned char *table, int edge, int corner, int eo)
+	{
+		return table ? table[(edge * 24 + corner) * 2048 + eo] : 0;
 	}
 
 	bool depth_limited_search_1(int arg_index1, int arg_index2, int arg_index3, int arg_index_dep, int arg_index_eo, int depth, int prev, std::vector<unsigned char> &prune1)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -885,6 +970,10 @@ struct xcross_analyzer2
 			{
 				continue;
 			}
+			if (slot_eo1 && slot_eo1[(index3_tmp * 24 + index2_tmp) * 2048 + index_eo_tmp] >= depth)
+			{
+				continue;
+			}
 			sol[current_max_depth - depth] = i;
 			if (depth == 1)
 			{
@@ -965,12 +1054,15 @@ struct xcross_analyzer2
 		move_restrict.clear();
 		scramble = arg_scramble;
 		slot1 = arg_slot1;
+		slot_eo1 = slot_eo_table(slot1);
 		max_length = 20;
 		sol_num = arg_sol_num;
 		restrict = move_names;
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1003,8 +1095,10 @@ struct xcross_analyzer2
 			}
 			prune1_tmp = prune1[index1 + index2];
 			prune_dep_eo_tmp = prune_table_dep_eo[index_dep * 2048 + index_eo];
+			prune_slot_eo_tmp = slot_eo_prune(slot_eo1, index3, index2, index_eo);
 			if (prune1_tmp == 0 && index3 == edge_solved1 && prune_dep_eo_tmp == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1013,7 +1107,7 @@ struct xcross_analyzer2
 				index3 *= 18;
 				index_dep *= 18;
 				index_eo *= 18;
-				for (int d = std::max(prune1_tmp, prune_dep_eo_tmp); d <= max_length; d++)
+				for (int d = std::max(std::max(prune1_tmp, prune_dep_eo_tmp), prune_slot_eo_tmp); d <= max_length; d++)
 				{
 					current_max_depth = d;
 					sol.resize(d);
@@ -1022,6 +1116,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1034,7 +1133,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1047,6 +1146,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_2(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int arg_index_dep, int arg_index_eo, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1075,6 +1178,10 @@ struct xcross_analyzer2
 			{
 				continue;
 			}
+			if (slot_eo1 && (slot_eo1[(index5_tmp * 24 + index2_tmp) * 2048 + index_eo_tmp] >= depth || slot_eo2[(index6_tmp * 24 + index4_tmp) * 2048 + index_eo_tmp] >= depth))
+			{
+				continue;
+			}
 			sol[current_max_depth - depth] = i;
 			if (depth == 1)
 			{
@@ -1146,12 +1253,16 @@ struct xcross_analyzer2
 		scramble = arg_scramble;
 		slot1 = arg_slot1;
 		slot2 = arg_slot2;
+		slot_eo1 = slot_eo_table(slot1);
+		slot_eo2 = slot_eo_table(slot2);
 		max_length = 20;
 		sol_num = arg_sol_num;
 		restrict = move_names;
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1190,8 +1301,10 @@ struct xcross_analyzer2
 			prune1_tmp = prune1[index1 + index2];
 			prune2_tmp = prune2[index1 + index4];
 			prune_dep_eo_tmp = prune_table_dep_eo[index_dep * 2048 + index_eo];
+			prune_slot_eo_tmp = std::max(slot_eo_prune(slot_eo1, index5, index2, index_eo), slot_eo_prune(slot_eo2, index6, index4, index_eo));
 			if (prune1_tmp == 0 && prune2_tmp == 0 && index5 == edge_solved1 && index6 == edge_solved2 && prune_dep_eo_tmp == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1202,7 +1315,7 @@ struct xcross_analyzer2
 				index6 *= 18;
 				index_dep *= 18;
 				index_eo *= 18;
-				for (int d = std::max(prune1_tmp, std::max(prune2_tmp, prune_dep_eo_tmp)); d <= max_length; d++)
+				for (int d = std::max(std::max(prune1_tmp, std::max(prune2_tmp, prune_dep_eo_tmp)), prune_slot_eo_tmp); d <= max_length; d++)
 				{
 					current_max_depth = d;
 					sol.resize(d);
@@ -1211,6 +1324,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1223,7 +1341,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1238,6 +1356,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_3(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int arg_index_dep, int arg_index_eo, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &prune3)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1273,6 +1395,10 @@ struct xcross_analyzer2
 			{
 				continue;
 			}
+			if (slot_eo1 && (slot_eo1[(index7_tmp * 24 + index2_tmp) * 2048 + index_eo_tmp] >= depth || slot_eo2[(index8_tmp * 24 + index4_tmp) * 2048 + index_eo_tmp] >= depth || slot_eo3[(index9_tmp * 24 + index6_tmp) * 2048 + index_eo_tmp] >= depth))
+			{
+				continue;
+			}
 			sol[current_max_depth - depth] = i;
 			if (depth == 1)
 			{
@@ -1351,12 +1477,17 @@ struct xcross_analyzer2
 		slot1 = arg_slot1;
 		slot2 = arg_slot2;
 		slot3 = arg_slot3;
+		slot_eo1 = slot_eo_table(slot1);
+		slot_eo2 = slot_eo_table(slot2);
+		slot_eo3 = slot_eo_table(slot3);
 		max_length = 20;
 		sol_num = arg_sol_num;
 		restrict = move_names;
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1401,8 +1532,10 @@ struct xcross_analyzer2
 			prune2_tmp = prune2[index1 + index4];
 			prune3_tmp = prune3[index1 + index6];
 			prune_dep_eo_tmp = prune_table_dep_eo[index_dep * 2048 + index_eo];
+			prune_slot_eo_tmp = std::max(slot_eo_prune(slot_eo1, index7, index2, index_eo), std::max(slot_eo_prune(slot_eo2, index8, index4, index_eo), slot_eo_prune(slot_eo3, index9, index6, index_eo)));
 			if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && index7 == edge_solved1 && index8 == edge_solved2 && index9 == edge_solved3 && prune_dep_eo_tmp == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1415,7 +1548,7 @@ struct xcross_analyzer2
 				index9 *= 18;
 				index_dep *= 18;
 				index_eo *= 18;
-				for (int d = std::max(prune1_tmp, std::max(prune2_tmp, prune3_tmp)); d <= max_length; d++)
+				for (int d = std::max(std::max(prune1_tmp, std::max(prune2_tmp, prune3_tmp)), prune_slot_eo_tmp); d <= max_length; d++)
 				{
 					current_max_depth = d;
 					sol.resize(d);
@@ -1424,6 +1557,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1436,7 +1574,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xxxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1448,8 +1586,39 @@ struct xcross_analyzer2
 	}
 };
 
-void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+// Keeps the move and prune tables between analyze() calls. Each analyzer is
+// built by the first call that requests its rows (cross / x, xx, xxx), so
+// later scrambles only pay for the searches.
+struct analyzer_session
+{
+	std::unique_ptr<cross_analyzer> cs;
+	std::unique_ptr<xcross_analyzer2> xcs;
+	bool eo_slot_pruning = true;
+
+	// x / xx / xxx rows: also prune with the EO + slot tables (about 4.7 MB,
+	// built on first use)
+	void set_eo_slot_pruning(bool enable)
+	{
+		eo_slot_pruning = enable;
+		if (xcs)
+		{
+			xcs->enable_slot_eo(enable);
+		}
+	}
+
+	void analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+};
+
+void analyzer_session::analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
 {
+	// A corpus run is one request; its budget starts in analyze_corpus
+	if (!corpus)
+	{
+		SearchBudget::instance().begin();
+	}
 	std::vector<std::string> rotations;
 	std::string table = "<br><table border=\"2\" id=\"eo_analyzer_result\" translate=\"no\"><thead><tr><th class=\"sort\" data-sort=\"No\">No</th><th class=\"sort\" data-sort=\"slot\">slot</th>";
 	for (char c_tmp : rot_set)
@@ -1500,7 +1669,11 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	}
 	table += "</tr></thead><tbody class=\"list\"></tbody></table>";
 
-	update(table.c_str());
+	if (corpus)
+	{
+		corpus->set_rotations(rotations);
+	}
+	post(table.c_str());
 	int sol_num = std::stoi(num);
 	int count = 0;
 	if (cross)
@@ -1519,32 +1692,85 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	{
 		count += 4;
 	}
-	update((std::to_string(count)).c_str());
+	post((std::to_string(count)).c_str());
 	if (cross)
 	{
-		cross_analyzer cs;
-		cs.start_search(scramble, "", sol_num, rotations);
+		if (!cs)
+		{
+			cs.reset(new cross_analyzer());
+		}
+		cs->start_search(scramble, "", sol_num, rotations);
 	}
 	if (x || xx || xxx)
 	{
-		xcross_analyzer2 xcs;
+		if (!xcs)
+		{
+			xcs.reset(new xcross_analyzer2());
+		}
+		xcs->enable_slot_eo(eo_slot_pruning);
 		if (x)
 		{
-			xcs.xcross_analyze(scramble, sol_num, rotations);
+			xcs->xcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xx)
 		{
-			xcs.xxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xxx)
 		{
-			xcs.xxxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxxcross_analyze(scramble, sol_num, rotations);
 		}
 	}
-	update("Finished.");
+	if (SearchBudget::instance().stopped())
+	{
+		post(SearchBudget::instance().stop_message());
+	}
+	post("Finished.");
+}
+
+// Batch mode: one scramble per line. Nothing is posted; the aggregated
+// per-slot / per-orientation statistics are returned as JSON.
+std::string analyzer_session::analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	int saved_count = analyzer_count;
+	std::string json = run_corpus(scrambles, std::stoi(num), corpus, [&](const std::string &scramble)
+	{
+		analyze(scramble, cross, x, xx, xxx, num, rot_set);
+	});
+	analyzer_count = saved_count;
+	return json;
+}
+
+// Batch mode over count random-state scrambles from seed, solved two-phase
+// (see twophase::random_state_scrambles): a uniform sample of cube states.
+std::string analyzer_session::analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(twophase::random_state_scrambles(seed, count), cross, x, xx, xxx, num, rot_set);
+}
+
+// Extra batch mode over count random-move scrambles (25 moves) from seed,
+// e.g. to compare with results from other tools. Their states are only
+// approximately uniform; see random_move_scrambles.
+std::string analyzer_session::analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(random_move_scrambles(seed, count, 25), cross, x, xx, xxx, num, rot_set);
+}
+
+void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	analyzer_session session;
+	session.analyze(scramble, cross, x, xx, xxx, num, rot_set);
 }
 
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("analyze", &analyzer);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::class_<analyzer_session>("Analyzer")
+		.constructor<>()
+		.function("analyze", &analyzer_session::analyze)
+		.function("analyze_corpus", &analyzer_session::analyze_corpus)
+		.function("analyze_random", &analyzer_session::analyze_random)
+		.function("analyze_random_moves", &analyzer_session::analyze_random_moves)
+		.function("set_eo_slot_pruning", &analyzer_session::set_eo_slot_pruning);
 }
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include <sstream>
 #include <cstdlib>
 #include <bitset>
+#include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
     postMessage(UTF8ToString(str));
@@ -209,36 +214,18 @@ std::vector<std::vector<int>> index_to_center =
         {4, 5, 0, 1, 2, 3}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'", "u", "u2", "u'", "d", "d2", "d'", "l", "l2", "l'", "r", "r2", "r'", "f", "f2", "f'", "b", "b2", "b'", "M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'", "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
+MoveCodec move_codec(move_names);
 
 std::vector<std::string> rotation_names = {"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
 
 std::string AlgToString(std::vector<int> &alg)
 {
-    std::string result = "";
-    for (int i : alg)
-    {
-        result += move_names[i] + " ";
-    }
-    return result;
+    return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-    std::vector<int> alg;
-    std::istringstream iss(str);
-    std::string name;
-    while (iss >> name)
-    {
-        if (!name.empty())
-        {
-            auto it = std::find(move_names.begin(), move_names.end(), name);
-            if (it != move_names.end())
-            {
-                alg.emplace_back(std::distance(move_names.begin(), it));
-            }
-        }
-    }
-    return alg;
+    return move_codec.parse(str);
 }
 
 std::vector<std::vector<int>> rotationMap =
@@ -715,6 +702,25 @@ void create_prune_table(int index1, int index2, int size1, int size2, int depth,
     }
 }
 
+// create_prune_table() through cache: searches sharing the cache get one
+// table per set of arguments (move tables are told apart by address)
+TableRef<unsigned char> cached_prune_table(TableCache<unsigned char> &cache, int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<int> &move_restrict, std::vector<std::vector<int>> &center_move_table)
+{
+    std::ostringstream key;
+    key << index1 << ' ' << index2 << ' ' << size1 << ' ' << size2 << ' ' << depth << ' ' << table1.data() << ' ' << table2.data();
+    for (int m : move_restrict)
+    {
+        key << ' ' << m;
+    }
+    return cache.acquire(key.str(), [&]()
+    {
+        std::vector<unsigned char> prune_table(size1 * size2, 255);
+        std::vector<unsigned char> tmp_array;
+        create_prune_table(index1, index2, size1, size2, depth, table1, table2, prune_table, move_restrict, tmp_array, center_move_table);
+        return prune_table;
+    });
+}
+
 std::vector<bool> create_ma_table()
 {
     std::vector<bool> ma(28 * 27, false);
@@ -750,11 +756,10 @@ struct cross_search
     int sol_num;
     int count;
     std::vector<std::vector<int>> center_move_table;
-    std::vector<unsigned char> tmp_array;
-    std::vector<int> edge_move_table;
+    TableRef<int> edge_move_table;
     std::vector<int> eo_move_table;
-    std::vector<int> multi_move_table;
-    std::vector<unsigned char> prune_table;
+    TableRef<int> multi_move_table;
+    TableRef<unsigned char> prune_table;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -776,23 +781,38 @@ struct cross_search
     int m_tmp;
     std::vector<int> center_offset;
     int max_rot_count;
-    std::string post_moves;
+    std::vector<int> post_sequence;
+    SolutionSet solutions;
     int initial_center;
+    // Set by prepare() for search_depth(); start_depth 0 = already solved.
+    // label prefixes the emitted solutions and the prune tables come from
+    // prune_tables, shared by the combinations of solve_F2L_interleaved
+    int aprev_start;
+    int start_depth;
+    std::string label;
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
     cross_search()
     {
         center_move_table = create_center_move_table();
-        edge_move_table = create_edge_move_table();
-        multi_move_table = std::vector<int>(24 * 22 * 27, -1);
-        create_multi_move_table(2, 2, 12, 24 * 22, multi_move_table, edge_move_table);
+        edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+        multi_move_table = shared_table<int>("solver/multi_move_table/2", [&]()
+        {
+            std::vector<int> table(24 * 22 * 27, -1);
+            create_multi_move_table(2, 2, 12, 24 * 22, table, edge_move_table);
+            return table;
+        });
         index1 = 416;
         index2 = 520;
         eo_move_table = create_eo_move_table();
-        prune_table = std::vector<unsigned char>(24 * 22 * 24 * 22, 255);
     }
 
     bool depth_limited_search(int arg_index1, int arg_index2, int arg_index_eo, int depth, int center, int rot_count, int aprev)
     {
+        if (SearchBudget::instance().expired())
+        {
+            return true;
+        }
         for (int i : move_restrict_move)
         {
             if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -885,18 +905,18 @@ struct cross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1006,18 +1026,18 @@ struct cross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1035,7 +1055,7 @@ struct cross_search
         return false;
     }
 
-    void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 8, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+    void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 8, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
     {
         scramble = arg_scramble;
         rotation = arg_rotation;
@@ -1065,7 +1085,8 @@ struct cross_search
         std::vector<int> rotation_alg = StringToAlg(rotation);
         std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
         std::vector<int> post_alg = StringToAlg(arg_post_alg);
-        post_moves = AlgToString(post_alg);
+        post_sequence = post_alg;
+        solutions.clear();
         std::vector<int> move_restrict_tmp = move_restrict;
         int tc = 0;
         for (int i : post_alg)
@@ -1080,10 +1101,10 @@ struct cross_search
         center_offset = arg_center_offset;
         index1 = 416;
         index2 = 520;
-        create_prune_table(index1, index2, 24 * 22, 24 * 22, 20, multi_move_table, multi_move_table, prune_table, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table = cached_prune_table(*prune_tables, index1, index2, 24 * 22, 24 * 22, 20, multi_move_table, multi_move_table, move_restrict_tmp, center_move_table);
         index_eo = 0;
         count = 0;
-        int aprev_tmp = 54;
+        aprev_start = 54;
         for (int m : alg)
         {
             index1 = multi_move_table[index1 * 27 + m];
@@ -1093,7 +1114,7 @@ struct cross_search
         initial_center = 0;
         for (int m_tmp : post_alg)
         {
-            aprev_tmp = m_tmp;
+            aprev_start = m_tmp;
             if (m_tmp >= 45)
             {
                 initial_center = center_move_table[initial_center][m_tmp];
@@ -1105,37 +1126,57 @@ struct cross_search
             index2 = multi_move_table[index2 * 27 + m];
             index_eo = eo_move_table[index_eo * 27 + m];
         }
-        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
         if (it == move_restrict.end())
         {
-            aprev_tmp = 54;
+            aprev_start = 54;
         }
         prune_tmp = prune_table[index1 * 528 + index2];
         if (prune_tmp == 0 && index_eo == 0)
+        {
+            start_depth = 0;
+            return;
+        }
+        index1 *= 27;
+        index2 *= 27;
+        index_eo *= 27;
+        start_depth = prune_tmp;
+        if (start_depth == 255)
+        {
+            start_depth = 1;
+        }
+    }
+
+    bool search_depth(int d)
+    {
+        return depth_limited_search(index1, index2, index_eo, d, initial_center, 0, aprev_start * 54);
+    }
+
+    // Full search: prepare() (same arguments and defaults), then every depth
+    // from start_depth to max_length
+    template <class... Args>
+    void start_search(Args &&...args)
+    {
+        prepare(std::forward<Args>(args)...);
+        if (start_depth == 0)
         {
             update("Already solved.");
+            return;
         }
-        else
+        for (int d = start_depth; d <= max_length; d++)
         {
-            index1 *= 27;
-            index2 *= 27;
-            index_eo *= 27;
-            int d_min = prune_tmp;
-            if (d_min == 255)
-            {
-                d_min = 1;
-            }
-            for (int d = d_min; d <= max_length; d++)
+            tmp = "depth=" + std::to_string(d);
+            update(tmp.c_str());
+            if (search_depth(d))
             {
-                tmp = "depth=" + std::to_string(d);
-                update(tmp.c_str());
-                if (depth_limited_search(index1, index2, index_eo, d, initial_center, 0, aprev_tmp * 54))
-                {
-                    break;
-                }
+                break;
             }
-            update("Search finished.");
         }
+        if (SearchBudget::instance().stopped())
+        {
+            update(SearchBudget::instance().stop_message());
+        }
+        update("Search finished.");
     }
 };
 
@@ -1149,12 +1190,11 @@ struct xcross_search
     int sol_num;
     int count;
     std::vector<std::vector<int>> center_move_table;
-    std::vector<unsigned char> tmp_array;
-    std::vector<int> edge_move_table;
+    TableRef<int> edge_move_table;
     std::vector<int> eo_move_table;
-    std::vector<int> corner_move_table;
-    std::vector<int> multi_move_table;
-    std::vector<unsigned char> prune_table1;
+    TableRef<int> corner_move_table;
+    TableRef<int> multi_move_table;
+    TableRef<unsigned char> prune_table1;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -1179,22 +1219,37 @@ struct xcross_search
     int m_tmp;
     std::vector<int> center_offset;
     int max_rot_count;
-    std::string post_moves;
+    std::vector<int> post_sequence;
+    SolutionSet solutions;
     int initial_center;
+    // Set by prepare() for search_depth(); start_depth 0 = already solved.
+    // label prefixes the emitted solutions and the prune tables come from
+    // prune_tables, shared by the combinations of solve_F2L_interleaved
+    int aprev_start;
+    int start_depth;
+    std::string label;
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
     xcross_search()
     {
         center_move_table = create_center_move_table();
-        edge_move_table = create_edge_move_table();
-        corner_move_table = create_corner_move_table();
-        multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-        create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
-        prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
+        edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+        corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+        multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+        {
+            std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+            create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+            return table;
+        });
         eo_move_table = create_eo_move_table();
     }
 
     bool depth_limited_search(int arg_index1, int arg_index2, int arg_index3, int arg_index_eo, int depth, int center, int rot_count, int aprev)
     {
+        if (SearchBudget::instance().expired())
+        {
+            return true;
+        }
         for (int i : move_restrict_move)
         {
             if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1291,18 +1346,18 @@ struct xcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1416,18 +1471,18 @@ struct xcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1445,7 +1500,7 @@ struct xcross_search
         return false;
     }
 
-    void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_sol_num = 100, int arg_max_length = 10, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+    void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_sol_num = 100, int arg_max_length = 10, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
     {
         scramble = arg_scramble;
         rotation = arg_rotation;
@@ -1476,7 +1531,8 @@ struct xcross_search
         std::vector<int> rotation_alg = StringToAlg(rotation);
         std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
         std::vector<int> post_alg = StringToAlg(arg_post_alg);
-        post_moves = AlgToString(post_alg);
+        post_sequence = post_alg;
+        solutions.clear();
         std::vector<int> move_restrict_tmp = move_restrict;
         int tc = 0;
         for (int i : post_alg)
@@ -1496,10 +1552,10 @@ struct xcross_search
         index2 = corner_index[slot1];
         index3 = single_edge_index[slot1];
         edge_solved1 = index3;
-        create_prune_table(index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table1 = cached_prune_table(*prune_tables, index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index_eo = 0;
         count = 0;
-        int aprev_tmp = 54;
+        aprev_start = 54;
         for (int m : alg)
         {
             index1 = multi_move_table[index1 * 27 + m];
@@ -1510,7 +1566,7 @@ struct xcross_search
         initial_center = 0;
         for (int m_tmp : post_alg)
         {
-            aprev_tmp = m_tmp;
+            aprev_start = m_tmp;
             if (m_tmp >= 45)
             {
                 initial_center = center_move_table[initial_center][m_tmp];
@@ -1523,38 +1579,58 @@ struct xcross_search
             index3 = edge_move_table[index3 * 27 + m];
             index_eo = eo_move_table[index_eo * 27 + m];
         }
-        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
         if (it == move_restrict.end())
         {
-            aprev_tmp = 54;
+            aprev_start = 54;
         }
         prune1_tmp = prune_table1[index1 * 24 + index2];
         if (prune1_tmp == 0 && index3 == edge_solved1 && index_eo == 0)
+        {
+            start_depth = 0;
+            return;
+        }
+        index1 *= 27;
+        index2 *= 27;
+        index3 *= 27;
+        index_eo *= 27;
+        start_depth = prune1_tmp;
+        if (start_depth == 255)
+        {
+            start_depth = 1;
+        }
+    }
+
+    bool search_depth(int d)
+    {
+        return depth_limited_search(index1, index2, index3, index_eo, d, initial_center, 0, aprev_start * 54);
+    }
+
+    // Full search: prepare() (same arguments and defaults), then every depth
+    // from start_depth to max_length
+    template <class... Args>
+    void start_search(Args &&...args)
+    {
+        prepare(std::forward<Args>(args)...);
+        if (start_depth == 0)
         {
             update("Already solved.");
+            return;
         }
-        else
+        for (int d = start_depth; d <= max_length; d++)
         {
-            index1 *= 27;
-            index2 *= 27;
-            index3 *= 27;
-            index_eo *= 27;
-            int d_min = prune1_tmp;
-            if (d_min == 255)
+            tmp = "depth=" + std::to_string(d);
+            update(tmp.c_str());
+            if (search_depth(d))
             {
-                d_min = 1;
-            }
-            for (int d = d_min; d <= max_length; d++)
-            {
-                tmp = "depth=" + std::to_string(d);
-                update(tmp.c_str());
-                if (depth_limited_search(index1, index2, index3, index_eo, d, initial_center, 0, aprev_tmp * 54))
-                {
-                    break;
-                }
+                break;
             }
-            update("Search finished.");
         }
+        if (SearchBudget::instance().stopped())
+        {
+            update(SearchBudget::instance().stop_message());
+        }
+        update("Search finished.");
     }
 };
 
@@ -1569,13 +1645,12 @@ struct xxcross_search
     int sol_num;
     int count;
     std::vector<std::vector<int>> center_move_table;
-    std::vector<unsigned char> tmp_array;
-    std::vector<int> edge_move_table;
+    TableRef<int> edge_move_table;
     std::vector<int> eo_move_table;
-    std::vector<int> corner_move_table;
-    std::vector<int> multi_move_table;
-    std::vector<unsigned char> prune_table1;
-    std::vector<unsigned char> prune_table2;
+    TableRef<int> corner_move_table;
+    TableRef<int> multi_move_table;
+    TableRef<unsigned char> prune_table1;
+    TableRef<unsigned char> prune_table2;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -1608,23 +1683,37 @@ struct xxcross_search
     int m_tmp;
     std::vector<int> center_offset;
     int max_rot_count;
-    std::string post_moves;
+    std::vector<int> post_sequence;
+    SolutionSet solutions;
     int initial_center;
+    // Set by prepare() for search_depth(); start_depth 0 = already solved.
+    // label prefixes the emitted solutions and the prune tables come from
+    // prune_tables, shared by the combinations of solve_F2L_interleaved
+    int aprev_start;
+    int start_depth;
+    std::string label;
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
     xxcross_search()
     {
         center_move_table = create_center_move_table();
-        edge_move_table = create_edge_move_table();
-        corner_move_table = create_corner_move_table();
-        multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-        create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
-        prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
+        edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+        corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+        multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+        {
+            std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+            create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+            return table;
+        });
         eo_move_table = create_eo_move_table();
     }
 
     bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int arg_index_eo, int depth, int center, int rot_count, int aprev)
     {
+        if (SearchBudget::instance().expired())
+        {
+            return true;
+        }
         for (int i : move_restrict_move)
         {
             if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1734,18 +1823,18 @@ struct xxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1872,18 +1961,18 @@ struct xxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -1901,7 +1990,7 @@ struct xxcross_search
         return false;
     }
 
-    void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_sol_num = 100, int arg_max_length = 12, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+    void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_sol_num = 100, int arg_max_length = 12, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
     {
         scramble = arg_scramble;
         rotation = arg_rotation;
@@ -1933,7 +2022,8 @@ struct xxcross_search
         std::vector<int> rotation_alg = StringToAlg(rotation);
         std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
         std::vector<int> post_alg = StringToAlg(arg_post_alg);
-        post_moves = AlgToString(post_alg);
+        post_sequence = post_alg;
+        solutions.clear();
         std::vector<int> move_restrict_tmp = move_restrict;
         int tc = 0;
         for (int i : post_alg)
@@ -1953,15 +2043,15 @@ struct xxcross_search
         index2 = corner_index[slot1];
         index5 = single_edge_index[slot1];
         edge_solved1 = index5;
-        create_prune_table(index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table1 = cached_prune_table(*prune_tables, index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index3 = edge_index[slot2];
         index4 = corner_index[slot2];
         index6 = single_edge_index[slot2];
         edge_solved2 = index6;
-        create_prune_table(index3, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table2, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table2 = cached_prune_table(*prune_tables, index3, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index_eo = 0;
         count = 0;
-        int aprev_tmp = 54;
+        aprev_start = 54;
         for (int m : alg)
         {
             index1 = multi_move_table[index1 * 27 + m];
@@ -1974,7 +2064,7 @@ struct xxcross_search
         initial_center = 0;
         for (int m_tmp : post_alg)
         {
-            aprev_tmp = m_tmp;
+            aprev_start = m_tmp;
             if (m_tmp >= 45)
             {
                 initial_center = center_move_table[initial_center][m_tmp];
@@ -1989,41 +2079,61 @@ struct xxcross_search
             index6 = edge_move_table[index6 * 27 + m];
             index_eo = eo_move_table[index_eo * 27 + m];
         }
-        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
         if (it == move_restrict.end())
         {
-            aprev_tmp = 54;
+            aprev_start = 54;
         }
         prune1_tmp = prune_table1[index1 * 24 + index2];
         prune2_tmp = prune_table2[index1 * 24 + index4];
         if (prune1_tmp == 0 && prune2_tmp == 0 && index5 == edge_solved1 && index6 == edge_solved2 && index_eo == 0)
+        {
+            start_depth = 0;
+            return;
+        }
+        index1 *= 27;
+        index2 *= 27;
+        index4 *= 27;
+        index5 *= 27;
+        index6 *= 27;
+        index_eo *= 27;
+        start_depth = std::max(prune1_tmp, prune2_tmp);
+        if (start_depth == 255)
+        {
+            start_depth = 1;
+        }
+    }
+
+    bool search_depth(int d)
+    {
+        return depth_limited_search(index1, index2, index4, index5, index6, index_eo, d, initial_center, 0, aprev_start * 54);
+    }
+
+    // Full search: prepare() (same arguments and defaults), then every depth
+    // from start_depth to max_length
+    template <class... Args>
+    void start_search(Args &&...args)
+    {
+        prepare(std::forward<Args>(args)...);
+        if (start_depth == 0)
         {
             update("Already solved.");
+            return;
         }
-        else
+        for (int d = start_depth; d <= max_length; d++)
         {
-            index1 *= 27;
-            index2 *= 27;
-            index4 *= 27;
-            index5 *= 27;
-            index6 *= 27;
-            index_eo *= 27;
-            int d_min = std::max(prune1_tmp, prune2_tmp);
-            if (d_min == 255)
+            tmp = "depth=" + std::to_string(d);
+            update(tmp.c_str());
+            if (search_depth(d))
             {
-                d_min = 1;
+                break;
             }
-            for (int d = d_min; d <= max_length; d++)
-            {
-                tmp = "depth=" + std::to_string(d);
-                update(tmp.c_str());
-                if (depth_limited_search(index1, index2, index4, index5, index6, index_eo, d, initial_center, 0, aprev_tmp * 54))
-                {
-                    break;
-                }
-            }
-            update("Search finished.");
         }
+        if (SearchBudget::instance().stopped())
+        {
+            update(SearchBudget::instance().stop_message());
+        }
+        update("Search finished.");
     }
 };
 
@@ -2039,16 +2149,15 @@ struct xxxcross_search
     int sol_num;
     int count;
     std::vector<std::vector<int>> center_move_table;
-    std::vector<unsigned char> tmp_array;
-    std::vector<int> edge_move_table;
+    TableRef<int> edge_move_table;
     std::vector<int> dep_move_table;
     std::vector<int> eo_move_table;
-    std::vector<int> corner_move_table;
-    std::vector<int> multi_move_table;
-    std::vector<unsigned char> prune_table1;
-    std::vector<unsigned char> prune_table2;
-    std::vector<unsigned char> prune_table3;
-    std::vector<unsigned char> prune_table_dep_eo;
+    TableRef<int> corner_move_table;
+    TableRef<int> multi_move_table;
+    TableRef<unsigned char> prune_table1;
+    TableRef<unsigned char> prune_table2;
+    TableRef<unsigned char> prune_table3;
+    TableRef<unsigned char> prune_table_dep_eo;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -2092,30 +2201,42 @@ struct xxxcross_search
     int m_tmp;
     std::vector<int> center_offset;
     int max_rot_count;
-    std::string post_moves;
+    std::vector<int> post_sequence;
+    SolutionSet solutions;
     int initial_center;
+    // Set by prepare() for search_depth(); start_depth 0 = already solved.
+    // label prefixes the emitted solutions and the prune tables come from
+    // prune_tables, shared by the combinations of solve_F2L_interleaved
+    int aprev_start;
+    int start_depth;
+    std::string label;
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
     xxxcross_search()
     {
         center_move_table = create_center_move_table();
-        edge_move_table = create_edge_move_table();
-        corner_move_table = create_corner_move_table();
-        multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-        create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
-        prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table3 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
+        edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+        corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+        multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+        {
+            std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+            create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+            return table;
+        });
         std::vector<int> single_ep_move_table = create_ep_move_table();
         eo_move_table = create_eo_move_table();
         dep_move_table = std::vector<int>(12 * 11 * 10 * 9 * 27, -1);
         create_multi_move_table(4, 1, 12, 12 * 11 * 10 * 9, dep_move_table, single_ep_move_table);
         index_dep = 11720;
         index_eo = 0;
-        prune_table_dep_eo = std::vector<unsigned char>(12 * 11 * 10 * 9 * 2048, 255);
     }
 
     bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int arg_index_dep, int arg_index_eo, int depth, int center, int rot_count, int aprev)
     {
+        if (SearchBudget::instance().expired())
+        {
+            return true;
+        }
         for (int i : move_restrict_move)
         {
             if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -2247,18 +2368,18 @@ struct xxxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -2407,18 +2528,18 @@ struct xxxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -2436,7 +2557,7 @@ struct xxxcross_search
         return false;
     }
 
-    void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_slot3 = 1, int arg_sol_num = 100, int arg_max_length = 14, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+    void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_slot3 = 1, int arg_sol_num = 100, int arg_max_length = 14, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
     {
         scramble = arg_scramble;
         rotation = arg_rotation;
@@ -2469,7 +2590,8 @@ struct xxxcross_search
         std::vector<int> rotation_alg = StringToAlg(rotation);
         std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
         std::vector<int> post_alg = StringToAlg(arg_post_alg);
-        post_moves = AlgToString(post_alg);
+        post_sequence = post_alg;
+        solutions.clear();
         std::vector<int> move_restrict_tmp = move_restrict;
         int tc = 0;
         for (int i : post_alg)
@@ -2485,24 +2607,24 @@ struct xxxcross_search
         std::vector<int> edge_index = {187520, 187520, 187520, 187520};
         std::vector<int> single_edge_index = {0, 2, 4, 6};
         std::vector<int> corner_index = {12, 15, 18, 21};
-        create_prune_table(index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 20, dep_move_table, eo_move_table, prune_table_dep_eo, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table_dep_eo = cached_prune_table(*prune_tables, index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 20, dep_move_table, eo_move_table, move_restrict_tmp, center_move_table);
         index1 = edge_index[slot1];
         index2 = corner_index[slot1];
         index7 = single_edge_index[slot1];
         edge_solved1 = index7;
-        create_prune_table(index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table1 = cached_prune_table(*prune_tables, index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index4 = corner_index[slot2];
         index8 = single_edge_index[slot2];
         edge_solved2 = index8;
-        create_prune_table(index1, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table2, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table2 = cached_prune_table(*prune_tables, index1, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index6 = corner_index[slot3];
         index9 = single_edge_index[slot3];
         edge_solved3 = index9;
-        create_prune_table(index1, index6, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table3, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table3 = cached_prune_table(*prune_tables, index1, index6, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index_dep = 11720;
         index_eo = 0;
         count = 0;
-        int aprev_tmp = 54;
+        aprev_start = 54;
 
         for (int m : alg)
         {
@@ -2519,7 +2641,7 @@ struct xxxcross_search
         initial_center = 0;
         for (int m_tmp : post_alg)
         {
-            aprev_tmp = m_tmp;
+            aprev_start = m_tmp;
             if (m_tmp >= 45)
             {
                 initial_center = center_move_table[initial_center][m_tmp];
@@ -2537,46 +2659,66 @@ struct xxxcross_search
             index_dep = dep_move_table[index_dep * 27 + m];
             index_eo = eo_move_table[index_eo * 27 + m];
         }
-        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
         if (it == move_restrict.end())
         {
-            aprev_tmp = 54;
+            aprev_start = 54;
         }
         prune1_tmp = prune_table1[index1 * 24 + index2];
         prune2_tmp = prune_table2[index1 * 24 + index4];
         prune3_tmp = prune_table3[index1 * 24 + index6];
         prune_dep_eo_tmp = prune_table_dep_eo[index_dep * 2048 + index_eo];
         if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && index7 == edge_solved1 && index8 == edge_solved2 && index9 == edge_solved3 && prune_dep_eo_tmp == 0)
+        {
+            start_depth = 0;
+            return;
+        }
+        index1 *= 27;
+        index2 *= 27;
+        index4 *= 27;
+        index6 *= 27;
+        index7 *= 27;
+        index8 *= 27;
+        index9 *= 27;
+        index_dep *= 27;
+        index_eo *= 27;
+        start_depth = std::max(prune1_tmp, std::max(prune2_tmp, std::max(prune3_tmp, prune_dep_eo_tmp)));
+        if (start_depth == 255)
+        {
+            start_depth = 1;
+        }
+    }
+
+    bool search_depth(int d)
+    {
+        return depth_limited_search(index1, index2, index4, index6, index7, index8, index9, index_dep, index_eo, d, initial_center, 0, aprev_start * 54);
+    }
+
+    // Full search: prepare() (same arguments and defaults), then every depth
+    // from start_depth to max_length
+    template <class... Args>
+    void start_search(Args &&...args)
+    {
+        prepare(std::forward<Args>(args)...);
+        if (start_depth == 0)
         {
             update("Already solved.");
+            return;
         }
-        else
+        for (int d = start_depth; d <= max_length; d++)
         {
-            index1 *= 27;
-            index2 *= 27;
-            index4 *= 27;
-            index6 *= 27;
-            index7 *= 27;
-            index8 *= 27;
-            index9 *= 27;
-            index_dep *= 27;
-            index_eo *= 27;
-            int d_min = std::max(prune1_tmp, std::max(prune2_tmp, std::max(prune3_tmp, prune_dep_eo_tmp)));
-            if (d_min == 255)
-            {
-                d_min = 1;
-            }
-            for (int d = d_min; d <= max_length; d++)
-            {
-                tmp = "depth=" + std::to_string(d);
-                update(tmp.c_str());
-                if (depth_limited_search(index1, index2, index4, index6, index7, index8, index9, index_dep, index_eo, d, initial_center, 0, aprev_tmp * 54))
-                {
-                    break;
-                }
+            tmp = "depth=" + std::to_string(d);
+            update(tmp.c_str());
+            if (search_depth(d))
+            {
+                break;
             }
-            update("Search finished.");
         }
+        if (SearchBudget::instance().stopped())
+        {
+            update(SearchBudget::instance().stop_message());
+        }
+        update("Search finished.");
     }
 };
 
@@ -2589,17 +2731,16 @@ struct xxxxcross_search
     int sol_num;
     int count;
     std::vector<std::vector<int>> center_move_table;
-    std::vector<unsigned char> tmp_array;
-    std::vector<int> edge_move_table;
+    TableRef<int> edge_move_table;
     std::vector<int> dep_move_table;
     std::vector<int> eo_move_table;
-    std::vector<int> corner_move_table;
-    std::vector<int> multi_move_table;
-    std::vector<unsigned char> prune_table1;
-    std::vector<unsigned char> prune_table2;
-    std::vector<unsigned char> prune_table3;
-    std::vector<unsigned char> prune_table4;
-    std::vector<unsigned char> prune_table_dep_eo;
+    TableRef<int> corner_move_table;
+    TableRef<int> multi_move_table;
+    TableRef<unsigned char> prune_table1;
+    TableRef<unsigned char> prune_table2;
+    TableRef<unsigned char> prune_table3;
+    TableRef<unsigned char> prune_table4;
+    TableRef<unsigned char> prune_table_dep_eo;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -2647,31 +2788,42 @@ struct xxxxcross_search
     int m_tmp;
     std::vector<int> center_offset;
     int max_rot_count;
-    std::string post_moves;
+    std::vector<int> post_sequence;
+    SolutionSet solutions;
     int initial_center;
+    // Set by prepare() for search_depth(); start_depth 0 = already solved.
+    // label prefixes the emitted solutions and the prune tables come from
+    // prune_tables, shared by the combinations of solve_F2L_interleaved
+    int aprev_start;
+    int start_depth;
+    std::string label;
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
     xxxxcross_search()
     {
         center_move_table = create_center_move_table();
-        edge_move_table = create_edge_move_table();
-        corner_move_table = create_corner_move_table();
-        multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-        create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
-        prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table3 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-        prune_table4 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
+        edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+        corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+        multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+        {
+            std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+            create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+            return table;
+        });
         std::vector<int> single_ep_move_table = create_ep_move_table();
         eo_move_table = create_eo_move_table();
         dep_move_table = std::vector<int>(12 * 11 * 10 * 9 * 27, -1);
         create_multi_move_table(4, 1, 12, 12 * 11 * 10 * 9, dep_move_table, single_ep_move_table);
         index_dep = 11720;
         index_eo = 0;
-        prune_table_dep_eo = std::vector<unsigned char>(12 * 11 * 10 * 9 * 2048, 255);
     }
 
     bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index8, int arg_index9, int arg_index10, int arg_index11, int arg_index12, int arg_index_dep, int arg_index_eo, int depth, int center, int rot_count, int aprev)
     {
+        if (SearchBudget::instance().expired())
+        {
+            return true;
+        }
         for (int i : move_restrict_move)
         {
             if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -2816,18 +2968,18 @@ struct xxxxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -2989,18 +3141,18 @@ struct xxxxcross_search
                             index_eo_tmp2 *= 27;
                         }
                     }
-                    if (valid && center_valid)
+                    if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
                     {
                         count += 1;
                         if (rotation == "")
                         {
-                            tmp = post_moves + AlgToString(sol);
+                            tmp = move_codec.join(post_sequence, sol);
                         }
                         else
                         {
-                            tmp = rotation + " " + post_moves + AlgToString(sol);
+                            tmp = rotation + " " + move_codec.join(post_sequence, sol);
                         }
-                        update(tmp.c_str());
+                        update((label + tmp).c_str());
                         if (count == sol_num)
                         {
                             return true;
@@ -3018,7 +3170,7 @@ struct xxxxcross_search
         return false;
     }
 
-    void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 16, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+    void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 16, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
     {
         scramble = arg_scramble;
         rotation = arg_rotation;
@@ -3048,7 +3200,8 @@ struct xxxxcross_search
         std::vector<int> rotation_alg = StringToAlg(rotation);
         std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
         std::vector<int> post_alg = StringToAlg(arg_post_alg);
-        post_moves = AlgToString(post_alg);
+        post_sequence = post_alg;
+        solutions.clear();
         std::vector<int> move_restrict_tmp = move_restrict;
         int tc = 0;
         for (int i : post_alg)
@@ -3061,27 +3214,27 @@ struct xxxxcross_search
         }
         max_rot_count = arg_max_rot_count;
         center_offset = arg_center_offset;
-        create_prune_table(index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 20, dep_move_table, eo_move_table, prune_table_dep_eo, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table_dep_eo = cached_prune_table(*prune_tables, index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 20, dep_move_table, eo_move_table, move_restrict_tmp, center_move_table);
         std::vector<int> edge_index = {187520, 187520, 187520, 187520};
         std::vector<int> single_edge_index = {0, 2, 4, 6};
         std::vector<int> corner_index = {12, 15, 18, 21};
         index1 = edge_index[0];
         index2 = corner_index[0];
         index9 = single_edge_index[0];
-        create_prune_table(index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table1 = cached_prune_table(*prune_tables, index1, index2, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index4 = corner_index[1];
         index10 = single_edge_index[1];
-        create_prune_table(index1, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table2, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table2 = cached_prune_table(*prune_tables, index1, index4, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index6 = corner_index[2];
         index11 = single_edge_index[2];
-        create_prune_table(index1, index6, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table3, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table3 = cached_prune_table(*prune_tables, index1, index6, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index8 = corner_index[3];
         index12 = single_edge_index[3];
-        create_prune_table(index1, index8, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, prune_table4, move_restrict_tmp, tmp_array, center_move_table);
+        prune_table4 = cached_prune_table(*prune_tables, index1, index8, 24 * 22 * 20 * 18, 24, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         index_dep = 11720;
         index_eo = 0;
         count = 0;
-        int aprev_tmp = 54;
+        aprev_start = 54;
 
         for (int m : alg)
         {
@@ -3100,7 +3253,7 @@ struct xxxxcross_search
         initial_center = 0;
         for (int m_tmp : post_alg)
         {
-            aprev_tmp = m_tmp;
+            aprev_start = m_tmp;
             if (m_tmp >= 45)
             {
                 initial_center = center_move_table[initial_center][m_tmp];
@@ -3120,10 +3273,10 @@ struct xxxxcross_search
             index_dep = dep_move_table[index_dep * 27 + m];
             index_eo = eo_move_table[index_eo * 27 + m];
         }
-        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+        auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
         if (it == move_restrict.end())
         {
-            aprev_tmp = 54;
+            aprev_start = 54;
         }
         prune1_tmp = prune_table1[index1 * 24 + index2];
         prune2_tmp = prune_table2[index1 * 24 + index4];
@@ -3131,38 +3284,58 @@ struct xxxxcross_search
         prune4_tmp = prune_table4[index1 * 24 + index8];
         prune_dep_eo_tmp = prune_table_dep_eo[index_dep * 2048 + index_eo];
         if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && prune4_tmp == 0 && index9 == 0 && index10 == 2 && index11 == 4 && index12 == 6 && prune_dep_eo_tmp == 0)
+        {
+            start_depth = 0;
+            return;
+        }
+        index1 *= 27;
+        index2 *= 27;
+        index4 *= 27;
+        index6 *= 27;
+        index8 *= 27;
+        index9 *= 27;
+        index10 *= 27;
+        index11 *= 27;
+        index12 *= 27;
+        index_dep *= 27;
+        index_eo *= 27;
+        start_depth = std::max(prune1_tmp, std::max(prune2_tmp, std::max(prune3_tmp, prune4_tmp)));
+        if (start_depth == 255)
+        {
+            start_depth = 1;
+        }
+    }
+
+    bool search_depth(int d)
+    {
+        return depth_limited_search(index1, index2, index4, index6, index8, index9, index10, index11, index12, index_dep, index_eo, d, initial_center, 0, aprev_start * 54);
+    }
+
+    // Full search: prepare() (same arguments and defaults), then every depth
+    // from start_depth to max_length
+    template <class... Args>
+    void start_search(Args &&...args)
+    {
+        prepare(std::forward<Args>(args)...);
+        if (start_depth == 0)
         {
             update("Already solved.");
+            return;
         }
-        else
+        for (int d = start_depth; d <= max_length; d++)
         {
-            index1 *= 27;
-            index2 *= 27;
-            index4 *= 27;
-            index6 *= 27;
-            index8 *= 27;
-            index9 *= 27;
-            index10 *= 27;
-            index11 *= 27;
-            index12 *= 27;
-            index_dep *= 27;
-            index_eo *= 27;
-            int d_min = std::max(prune1_tmp, std::max(prune2_tmp, std::max(prune3_tmp, prune4_tmp)));
-            if (d_min == 255)
-            {
-                d_min = 1;
-            }
-            for (int d = d_min; d <= max_length; d++)
-            {
-                tmp = "depth=" + std::to_string(d);
-                update(tmp.c_str());
-                if (depth_limited_search(index1, index2, index4, index6, index8, index9, index10, index11, index12, index_dep, index_eo, d, initial_center, 0, aprev_tmp * 54))
-                {
-                    break;
-                }
+            tmp = "depth=" + std::to_string(d);
+            update(tmp.c_str());
+            if (search_depth(d))
+            {
+                break;
             }
-            update("Search finished.");
         }
+        if (SearchBudget::instance().stopped())
+        {
+            update(SearchBudget::instance().stop_message());
+        }
+        update("Search finished.");
     }
 };
 
@@ -3194,8 +3367,121 @@ std::vector<bool> F2L_option_array(const std::string &input)
     return result;
 }
 
+// One slot combination of the interleaved mode
+struct F2L_combination
+{
+    std::string label;
+    int start_depth;
+    std::function<int(int, int)> search_depth; // (depth, solutions left) -> solutions found
+};
+
+template <class Search, class... Args>
+F2L_combination make_F2L_combination(const std::string &label, const std::shared_ptr<TableCache<unsigned char>> &prune_tables, Args &&...args)
+{
+    std::shared_ptr<Search> search = std::make_shared<Search>();
+    search->label = "[" + label + "] ";
+    search->prune_tables = prune_tables;
+    search->prepare(std::forward<Args>(args)...);
+    F2L_combination combination;
+    combination.label = label;
+    combination.start_depth = search->start_depth;
+    combination.search_depth = [search](int depth, int left)
+    {
+        search->count = 0;
+        search->sol_num = left;
+        search->search_depth(depth);
+        return search->count;
+    };
+    return combination;
+}
+
+// Interleaved mode: option lists slot combinations separated by '|'
+// ("BL|BR|FR|FL", "BL BR|FR FL", "|BL" = cross or BL xcross). Every
+// combination is searched at depth d before any is searched at d + 1, so
+// solutions are emitted in nondecreasing length, each prefixed with its
+// combination ("[BL] ..."), and the search ends after sol_num solutions in
+// total instead of sol_num per combination.
+void solve_F2L_interleaved(std::string scramble, std::string rotation, std::string option, int sol_num, int max_length, const std::vector<std::string> &move_restrict, std::string post_alg, const std::vector<int> &center_offset, int max_rot_count, const std::vector<bool> &ma2, const std::vector<int> &mc)
+{
+    std::vector<std::string> names = {"BL", "BR", "FR", "FL"};
+    std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
+    std::vector<F2L_combination> combinations;
+    int found = 0;
+    std::istringstream iss(option);
+    std::string part;
+    while (std::getline(iss, part, '|'))
+    {
+        std::vector<bool> option_list = F2L_option_array(part);
+        std::vector<int> slot;
+        std::string label;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (option_list[i])
+            {
+                slot.emplace_back(i);
+                label += (label.empty() ? "" : " ") + names[i];
+            }
+        }
+        if (slot.size() == 0)
+        {
+            combinations.emplace_back(make_F2L_combination<cross_search>("None", prune_tables, scramble, rotation, sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+        }
+        else if (slot.size() == 1)
+        {
+            combinations.emplace_back(make_F2L_combination<xcross_search>(label, prune_tables, scramble, rotation, slot[0], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+        }
+        else if (slot.size() == 2)
+        {
+            combinations.emplace_back(make_F2L_combination<xxcross_search>(label, prune_tables, scramble, rotation, slot[0], slot[1], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+        }
+        else if (slot.size() == 3)
+        {
+            combinations.emplace_back(make_F2L_combination<xxxcross_search>(label, prune_tables, scramble, rotation, slot[0], slot[1], slot[2], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+        }
+        else
+        {
+            combinations.emplace_back(make_F2L_combination<xxxxcross_search>(label, prune_tables, scramble, rotation, sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+        }
+        if (combinations.back().start_depth == 0)
+        {
+            update(("[" + combinations.back().label + "] Already solved.").c_str());
+            found++;
+        }
+    }
+    int d_min = max_length + 1;
+    for (const F2L_combination &combination : combinations)
+    {
+        if (combination.start_depth > 0)
+        {
+            d_min = std::min(d_min, combination.start_depth);
+        }
+    }
+    for (int d = d_min; d <= max_length && found < sol_num && !SearchBudget::instance().stopped(); d++)
+    {
+        update(("depth=" + std::to_string(d)).c_str());
+        for (F2L_combination &combination : combinations)
+        {
+            if (combination.start_depth == 0 || combination.start_depth > d || found >= sol_num || SearchBudget::instance().stopped())
+            {
+                continue;
+            }
+            found += combination.search_depth(d, sol_num - found);
+        }
+    }
+    if (SearchBudget::instance().stopped())
+    {
+        update(SearchBudget::instance().stop_message());
+    }
+    update("Search finished.");
+}
+
 void solve_F2L(std::string scramble, std::string rotation, std::string option, int sol_num, int max_length, const std::vector<std::string> &move_restrict, std::string post_alg, const std::vector<int> &center_offset, int max_rot_count, const std::vector<bool> &ma2, const std::vector<int> &mc)
 {
+    if (option.find('|') != std::string::npos)
+    {
+        solve_F2L_interleaved(scramble, rotation, option, sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc);
+        return;
+    }
     std::vector<bool> option_list = F2L_option_array(option);
     int count = 0;
     std::vector<int> slot;
@@ -3311,37 +3597,13 @@ void buidMoveRestrict(const std::string &restID, std::vector<std::string> &move_
     }
 }
 
-static std::string get_move_base(const std::string &move)
-{
-    if (move.empty())
-        return "";
-    return move.substr(0, 1);
-}
-
 static bool should_be_checked_by_default(const std::string &prev_move, const std::string &next_move)
 {
     if (prev_move.empty())
         return false;
-    const static std::map<std::string, int> y_axis_order = {{"U", 0}, {"D", 1}, {"E", 2}, {"u", 3}, {"d", 4}, {"y", 5}};
-    const static std::map<std::string, int> x_axis_order = {{"L", 0}, {"R", 1}, {"M", 2}, {"l", 3}, {"r", 4}, {"x", 5}};
-    const static std::map<std::string, int> z_axis_order = {{"F", 0}, {"B", 1}, {"S", 2}, {"f", 3}, {"b", 4}, {"z", 5}};
-    const static std::map<std::string, const std::map<std::string, int> *> base_to_axis_map = {
-        {"U", &y_axis_order}, {"D", &y_axis_order}, {"E", &y_axis_order}, {"u", &y_axis_order}, {"d", &y_axis_order}, {"y", &y_axis_order}, {"L", &x_axis_order}, {"R", &x_axis_order}, {"M", &x_axis_order}, {"l", &x_axis_order}, {"r", &x_axis_order}, {"x", &x_axis_order}, {"F", &z_axis_order}, {"B", &z_axis_order}, {"S", &z_axis_order}, {"f", &z_axis_order}, {"b", &z_axis_order}, {"z", &z_axis_order}};
-    std::string prev_base = get_move_base(prev_move);
-    std::string next_base = get_move_base(next_move);
-    if (prev_base == next_base)
-        return true;
-    auto it_prev = base_to_axis_map.find(prev_base);
-    auto it_next = base_to_axis_map.find(next_base);
-    if (it_prev != base_to_axis_map.end() && it_next != base_to_axis_map.end() && it_prev->second == it_next->second)
-    {
-        const auto &axis_map = *it_prev->second;
-        if (axis_map.at(prev_base) > axis_map.at(next_base))
-        {
-            return true;
-        }
-    }
-    return false;
+    int prev = move_codec.id(prev_move.data(), prev_move.size());
+    int next = move_codec.id(next_move.data(), next_move.size());
+    return prev != -1 && next != -1 && move_codec.follows_out_of_order(prev, next);
 }
 
 void buidMA2(const std::string &restID, const std::string &mavString, std::vector<bool> &vector)
@@ -3419,6 +3681,19 @@ void buidMA2(const std::string &restID, const std::string &mavString, std::vecto
             }
         }
     }
+    if (canonical_mode())
+    {
+        for (const auto &row_move : active_moves)
+        {
+            for (const auto &col_move : active_moves)
+            {
+                if (should_be_checked_by_default(row_move, col_move))
+                {
+                    vector[move_to_index_map.at(row_move) * NUM_COLS + move_to_index_map.at(col_move)] = true;
+                }
+            }
+        }
+    }
 }
 
 void buildMoveCountVector(const std::string &restID, const std::string &moveCountString, std::vector<int> &move_count_vector)
@@ -3488,6 +3763,7 @@ void buildMoveCountVector(const std::string &restID, const std::string &moveCoun
 
 void controller(std::string scr, std::string rot, std::string slot, int num, int len, std::string move_restrict_string, std::string post_alg, std::string center_offset_string, int max_rot_count, std::string ma2_string, std::string mcString)
 {
+    SearchBudget::instance().begin();
     std::vector<int> center_offset;
     std::vector<bool> ma2;
     std::vector<int> mc;
@@ -3502,4 +3778,6 @@ void controller(std::string scr, std::string rot, std::string slot, int num, int
 EMSCRIPTEN_BINDINGS(my_module)
 {
     emscripten::function("solve", &controller);
+    emscripten::function("set_search_limits", &set_search_limits);
+    emscripten::function("set_canonical_mode", &set_canonical_mode);
 }
\ No newline at end of file
@@ -8,9 +8,24 @@ const solverPromise = new Promise(resolve => {
 importScripts('pairing_solver.js');
 
 self.onmessage = async function (event) {
-	const { scr, rot, slot, pslot, num, len, move_restrict, post_alg, center_offset, max_rot_count, ma2, mcString } = event.data;
+	const { scr, rot, slot, pslot, num, len, move_restrict, post_alg, center_offset, max_rot_count, ma2, mcString, time_limit_ms, node_limit, cancel_buffer, canonical } = event.data;
 	try {
 		const Module = await solverPromise;
+		if (cancel_buffer !== undefined) {
+			// Int32Array over a SharedArrayBuffer; the page sets [0] to 1 to stop the running search
+			Module.searchCancel = new Int32Array(cancel_buffer);
+		}
+		if (Module.searchCancel) {
+			Atomics.store(Module.searchCancel, 0, 0);
+		}
+		if (Module.set_search_limits) {
+			// 0 = no limit; a stopped search posts its reason, results found so far are kept
+			Module.set_search_limits(time_limit_ms || 0, node_limit || 0);
+		}
+		if (Module.set_canonical_mode) {
+			// Skip solutions that differ from an earlier one only by commuting moves
+			Module.set_canonical_mode(!!canonical);
+		}
 		Module.solve(scr, rot, slot, pslot, num, len, move_restrict, post_alg, center_offset, max_rot_count, ma2, mcString);
 	} catch (e) {
 		self.postMessage("Error");
@@ -0,0 +1,93 @@
+#ifndef APPL_SEEDS_H
+#define APPL_SEEDS_H
+
+// =============================================================================
+// APPL Seeds
+// =============================================================================
+//
+// Extra depth-0 entries of the pairing trainers' prune tables: the states one
+// last insert (optionally followed by an AUF / ADF) away from solved. Each
+// seed is its table index plus the ids of the insert algorithm and of the U
+// and D adjustments, 8 bytes per seed. text() puts the solution together only
+// when a scramble is emitted.
+//
+// Insert algorithms are held once in algs(); further sets can be appended
+// with add_alg() before the prune table is rebuilt, up to MAX_ALGS in total
+// (ids are 16-bit).
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ApplSeeds {
+public:
+    static const int MAX_ALGS = 65536;  // Including id 0
+
+    // Replaces the insert algorithms and drops every seed
+    void set_algs(const std::vector<std::string>& algs) {
+        algs_ = {""};
+        algs_.insert(algs_.end(), algs.begin(), algs.end());
+        seeds_.clear();
+    }
+
+    // Id of alg, appended if new; -1 if it is new and MAX_ALGS are held
+    int add_alg(const std::string& alg) {
+        auto it = std::find(algs_.begin(), algs_.end(), alg);
+        if (it != algs_.end()) return static_cast<int>(it - algs_.begin());
+        if (static_cast<int>(algs_.size()) >= MAX_ALGS) return -1;
+        algs_.push_back(alg);
+        return static_cast<int>(algs_.size()) - 1;
+    }
+
+    // Insert algorithms by id; id 0 is "no insert"
+    const std::vector<std::string>& algs() const { return algs_; }
+
+    // alg: an id from algs(). auf / adf: 0 none, 1-3 U / U2 / U' (D / D2 /
+    // D'). Of the seeds added for one index, finalize() keeps the last.
+    void add(int index, int alg, int auf = 0, int adf = 0) {
+        seeds_.push_back(Seed{index, static_cast<uint16_t>(alg),
+                              static_cast<unsigned char>(auf), static_cast<unsigned char>(adf)});
+    }
+
+    // Sorts the seeds by index for text(); call after the last add()
+    void finalize() {
+        std::stable_sort(seeds_.begin(), seeds_.end(),
+                         [](const Seed& a, const Seed& b) { return a.index < b.index; });
+        std::vector<Seed> unique;
+        for (const Seed& seed : seeds_) {
+            if (!unique.empty() && unique.back().index == seed.index) {
+                unique.back() = seed;
+            } else {
+                unique.push_back(seed);
+            }
+        }
+        seeds_.swap(unique);
+    }
+
+    // Solution of a seed, " " for the solved state, "" for other indices
+    std::string text(int index) const {
+        auto it = std::lower_bound(seeds_.begin(), seeds_.end(), index,
+                                   [](const Seed& seed, int i) { return seed.index < i; });
+        if (it == seeds_.end() || it->index != index) return "";
+        if (it->alg == 0 && it->auf == 0 && it->adf == 0) return " ";
+        static const char* const kAuf[] = {"", " U", " U2", " U'"};
+        static const char* const kAdf[] = {"", " D", " D2", " D'"};
+        return algs_[it->alg] + kAuf[it->auf] + kAdf[it->adf];
+    }
+
+    size_t size() const { return seeds_.size(); }
+
+private:
+    struct Seed {
+        int index;
+        uint16_t alg;
+        unsigned char auf;
+        unsigned char adf;
+    };
+
+    std::vector<std::string> algs_ = {""};
+    std::vector<Seed> seeds_;
+};
+
+#endif // APPL_SEEDS_H
@@ -0,0 +1,205 @@
+// =============================================================================
+// Solver / Analyzer Bundle
+// =============================================================================
+//
+// All solver and analyzer modules in one WASM instance. Each module source is
+// compiled unchanged inside its own namespace, so the per-module helpers and
+// search structs do not collide, and re-exported with the module name as a
+// prefix:
+//
+//   Module.crossSolver_solve(...)            same arguments as Module.solve
+//   new Module.crossAnalyzer_Analyzer()      same methods as Module.Analyzer
+//
+// The modules share one heap (grown on demand, see compile.txt) and one
+// TableRegistry, so move tables built by one page are reused by the next.
+// Tables are still built on first use by a search; nothing is built at
+// startup.
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <emscripten.h>
+#include <emscripten/bind.h>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
+#include "../corpus_stats.h"
+#include "../twophase/two_phase.h"
+
+// The headers above are included at global scope first; their include guards
+// turn the modules' own includes into no-ops inside the namespaces below.
+
+EM_JS(void, bundle_update, (const char *str), {
+    postMessage(UTF8ToString(str));
+});
+
+// Inside the modules, update() forwards to bundle_update() and the per-module
+// EMSCRIPTEN_BINDINGS blocks are compiled but never registered (their
+// unprefixed names would clash).
+#pragma push_macro("EM_JS")
+#pragma push_macro("EMSCRIPTEN_BINDINGS")
+#undef EM_JS
+#undef EMSCRIPTEN_BINDINGS
+#define EM_JS(ret, name, params, ...) ret name params { bundle_update(str); }
+#define EMSCRIPTEN_BINDINGS(name) [[maybe_unused]] static void unregistered_bindings_##name()
+namespace crossSolver
+{
+#include "../crossSolver/solver.cpp"
+}
+namespace EOCrossSolver
+{
+#include "../EOCrossSolver/solver.cpp"
+}
+namespace F2LEOSolver
+{
+#include "../F2LEOSolver/solver.cpp"
+}
+namespace F2L_PairingSolver
+{
+#include "../F2L_PairingSolver/pairing_solver.cpp"
+}
+namespace pseudoCrossSolver
+{
+#include "../pseudoCrossSolver/pseudo.cpp"
+}
+namespace pseudoF2LEOSolver
+{
+#include "../pseudoF2LEOSolver/pseudo.cpp"
+}
+namespace pseudoPairingSolver
+{
+#include "../pseudoPairingSolver/pseudoPairingSolver.cpp"
+}
+namespace highMemorySolver
+{
+#include "../highMemorySolver/solver2.cpp"
+}
+namespace crossAnalyzer
+{
+#include "../crossAnalyzer/analyzer.cpp"
+}
+namespace EOCrossAnalyzer
+{
+#include "../EOCrossAnalyzer/analyzer.cpp"
+}
+namespace F2LEOAnalyzer
+{
+#include "../F2LEOAnalyzer/analyzer.cpp"
+}
+namespace pairAnalyzer
+{
+#include "../pairAnalyzer/analyzer.cpp"
+}
+namespace pseudoCrossAnalyzer
+{
+#include "../pseudoCrossAnalyzer/pseudo_analyzer.cpp"
+}
+namespace pseudoF2LEOAnalyzer
+{
+#include "../pseudoF2LEOAnalyzer/pseudo_analyzer.cpp"
+}
+namespace pseudoPairAnalyzer
+{
+#include "../pseudoPairAnalyzer/analyzer.cpp"
+}
+#pragma pop_macro("EMSCRIPTEN_BINDINGS")
+#pragma pop_macro("EM_JS")
+
+// Drop cached tables no live search or analyzer refers to, e.g. after leaving
+// a page whose tables are not needed by the next one.
+size_t bundle_release_tables()
+{
+    return TableRegistry::instance().release_unused();
+}
+
+std::string bundle_table_stats()
+{
+    const TableRegistry::Stats stats = TableRegistry::instance().stats();
+    std::ostringstream oss;
+    oss << "{\"tables\":" << stats.tables << ",\"bytes\":" << stats.bytes
+        << ",\"builds\":" << stats.builds << ",\"hits\":" << stats.hits << "}";
+    return oss.str();
+}
+
+EMSCRIPTEN_BINDINGS(bundle)
+{
+    emscripten::function("crossSolver_solve", &crossSolver::controller);
+    emscripten::function("EOCrossSolver_solve", &EOCrossSolver::controller);
+    emscripten::function("F2LEOSolver_solve", &F2LEOSolver::controller);
+    emscripten::function("F2L_PairingSolver_solve", &F2L_PairingSolver::controller);
+    emscripten::function("pseudoCrossSolver_solve", &pseudoCrossSolver::controller);
+    emscripten::function("pseudoF2LEOSolver_solve", &pseudoF2LEOSolver::controller);
+    emscripten::function("pseudoPairingSolver_solve", &pseudoPairingSolver::controller);
+    emscripten::function("highMemorySolver_solve", &highMemorySolver::controller);
+
+    emscripten::function("crossAnalyzer_analyze", &crossAnalyzer::analyzer);
+    emscripten::class_<crossAnalyzer::analyzer_session>("crossAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &crossAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &crossAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &crossAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &crossAnalyzer::analyzer_session::analyze_random_moves)
+        .function("set_best_orientations", &crossAnalyzer::analyzer_session::set_best_orientations)
+        .function("prefix_reset", &crossAnalyzer::analyzer_session::prefix_reset)
+        .function("prefix_push", &crossAnalyzer::analyzer_session::prefix_push)
+        .function("prefix_pop", &crossAnalyzer::analyzer_session::prefix_pop);
+    emscripten::function("EOCrossAnalyzer_analyze", &EOCrossAnalyzer::analyzer);
+    emscripten::class_<EOCrossAnalyzer::analyzer_session>("EOCrossAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &EOCrossAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &EOCrossAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &EOCrossAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &EOCrossAnalyzer::analyzer_session::analyze_random_moves)
+        .function("set_eo_slot_pruning", &EOCrossAnalyzer::analyzer_session::set_eo_slot_pruning);
+    emscripten::function("F2LEOAnalyzer_analyze", &F2LEOAnalyzer::analyzer);
+    emscripten::class_<F2LEOAnalyzer::analyzer_session>("F2LEOAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &F2LEOAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &F2LEOAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &F2LEOAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &F2LEOAnalyzer::analyzer_session::analyze_random_moves);
+    emscripten::function("pairAnalyzer_analyze", &pairAnalyzer::analyzer);
+    emscripten::class_<pairAnalyzer::analyzer_session>("pairAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &pairAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &pairAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &pairAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &pairAnalyzer::analyzer_session::analyze_random_moves)
+        .function("set_table_capacity_mb", &pairAnalyzer::analyzer_session::set_table_capacity_mb);
+    emscripten::function("pseudoCrossAnalyzer_analyze", &pseudoCrossAnalyzer::analyzer);
+    emscripten::class_<pseudoCrossAnalyzer::analyzer_session>("pseudoCrossAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &pseudoCrossAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &pseudoCrossAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &pseudoCrossAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &pseudoCrossAnalyzer::analyzer_session::analyze_random_moves);
+    emscripten::function("pseudoF2LEOAnalyzer_analyze", &pseudoF2LEOAnalyzer::analyzer);
+    emscripten::class_<pseudoF2LEOAnalyzer::analyzer_session>("pseudoF2LEOAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &pseudoF2LEOAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &pseudoF2LEOAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &pseudoF2LEOAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &pseudoF2LEOAnalyzer::analyzer_session::analyze_random_moves);
+    emscripten::function("pseudoPairAnalyzer_analyze", &pseudoPairAnalyzer::analyzer);
+    emscripten::class_<pseudoPairAnalyzer::analyzer_session>("pseudoPairAnalyzer_Analyzer")
+        .constructor<>()
+        .function("analyze", &pseudoPairAnalyzer::analyzer_session::analyze)
+        .function("analyze_corpus", &pseudoPairAnalyzer::analyzer_session::analyze_corpus)
+        .function("analyze_random", &pseudoPairAnalyzer::analyzer_session::analyze_random)
+        .function("analyze_random_moves", &pseudoPairAnalyzer::analyzer_session::analyze_random_moves);
+
+    emscripten::function("bundle_release_tables", &bundle_release_tables);
+    emscripten::function("bundle_table_stats", &bundle_table_stats);
+    emscripten::function("set_search_limits", &set_search_limits);
+    emscripten::function("set_canonical_mode", &set_canonical_mode);
+}
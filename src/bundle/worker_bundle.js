@@ -0,0 +1,92 @@
+
+const solverPromise = new Promise(resolve => {
+	self.Module = {
+		onRuntimeInitialized: () => resolve(self.Module)
+	};
+});
+
+importScripts('bundle.js');
+
+// Arguments of Module.<name>_solve, in the order of each module's worker
+const solveArgs = {
+	crossSolver: ["solver", "scr", "rot", "slot", "ll", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	highMemorySolver: ["solver", "scr", "rot", "slot", "ll", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	EOCrossSolver: ["scr", "rot", "slot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	F2LEOSolver: ["scr", "rot", "slot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	F2L_PairingSolver: ["scr", "rot", "slot", "pslot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	pseudoCrossSolver: ["scr", "rot", "slot", "pslot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	pseudoF2LEOSolver: ["scr", "rot", "slot", "pslot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"],
+	pseudoPairingSolver: ["scr", "rot", "slot", "pslot", "a_slot", "a_pslot", "num", "len", "move_restrict", "post_alg", "center_offset", "max_rot_count", "ma2", "mcString"]
+};
+
+// One persistent Analyzer per module: its prune tables are built once
+const analyzers = {};
+
+function runAnalyzer(Module, name, data) {
+	const { scramble, cross, x, xx, xxx, n, rot_set, corpus, seed, count, random_moves, best_orientations, prefix, moves, eo_slot_pruning, table_capacity_mb } = data;
+	if (!analyzers[name]) {
+		analyzers[name] = new Module[name + "_Analyzer"]();
+	}
+	const analyzer = analyzers[name];
+	if (best_orientations !== undefined && analyzer.set_best_orientations) {
+		analyzer.set_best_orientations(best_orientations);
+	}
+	if (eo_slot_pruning !== undefined && analyzer.set_eo_slot_pruning) {
+		analyzer.set_eo_slot_pruning(eo_slot_pruning);
+	}
+	if (table_capacity_mb !== undefined && analyzer.set_table_capacity_mb) {
+		analyzer.set_table_capacity_mb(table_capacity_mb);
+	}
+	if (prefix !== undefined && analyzer.prefix_reset) {
+		if (prefix === "reset") {
+			self.postMessage(analyzer.prefix_reset(cross, x, xx, xxx, rot_set));
+		} else if (prefix === "push") {
+			self.postMessage(analyzer.prefix_push(moves));
+		} else {
+			self.postMessage(analyzer.prefix_pop());
+		}
+	} else if (corpus !== undefined) {
+		self.postMessage(analyzer.analyze_corpus(corpus.join("\n"), cross, x, xx, xxx, n, rot_set));
+	} else if (count !== undefined) {
+		// Random-state scrambles; random_moves selects 25-move random-move ones
+		const run = random_moves ? analyzer.analyze_random_moves : analyzer.analyze_random;
+		self.postMessage(run.call(analyzer, seed || 0, count, cross, x, xx, xxx, n, rot_set));
+	} else {
+		analyzer.analyze(scramble, cross, x, xx, xxx, n, rot_set);
+	}
+}
+
+// Messages carry the module name plus the fields its own worker accepts,
+// e.g. { module: "crossSolver", solver: "F2L", scr: ..., ... }.
+// { release: true } frees the analyzers and every table no search holds.
+self.onmessage = async function (event) {
+	const data = event.data;
+	try {
+		const Module = await solverPromise;
+		if (data.cancel_buffer !== undefined) {
+			// Int32Array over a SharedArrayBuffer; the page sets [0] to 1 to stop the running search
+			Module.searchCancel = new Int32Array(data.cancel_buffer);
+		}
+		if (Module.searchCancel) {
+			Atomics.store(Module.searchCancel, 0, 0);
+		}
+		Module.set_search_limits(data.time_limit_ms || 0, data.node_limit || 0);
+		Module.set_canonical_mode(!!data.canonical);
+		if (data.release) {
+			for (const name in analyzers) {
+				analyzers[name].delete();
+				delete analyzers[name];
+			}
+			Module.bundle_release_tables();
+			self.postMessage(Module.bundle_table_stats());
+		} else if (solveArgs[data.module]) {
+			Module[data.module + "_solve"](...solveArgs[data.module].map(key => data[key]));
+		} else if (Module[data.module + "_Analyzer"]) {
+			runAnalyzer(Module, data.module, data);
+		} else {
+			self.postMessage("Error");
+		}
+	} catch (e) {
+		self.postMessage("Error");
+	}
+};
@@ -0,0 +1,196 @@
+#ifndef CORPUS_STATS_H
+#define CORPUS_STATS_H
+
+// =============================================================================
+// Corpus Statistics
+// =============================================================================
+//
+// Batch mode of the analyzers (analyze_corpus, analyze_random over random-state
+// scrambles from ../twophase/two_phase.h, analyze_random_moves). While
+// a run is active the analyzer's rows are handed to corpus_stats::record()
+// instead of being posted as HTML; the aggregate per-slot / per-orientation
+// statistics are returned as JSON at the end. The length of a row in one
+// orientation is the optimal length (sol_num = 1) or the mean of the first
+// sol_num solutions, or UNSOLVED if the orientation was not searched to the
+// end (crossAnalyzer's best-N mode); such cells are only counted in
+// "unsolved" and left out of the mean, the histogram and the best orientation.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "search_budget.h"
+
+struct corpus_stats {
+    static const int HISTOGRAM_SIZE = 21;  // Lengths 0-20 (max_length)
+    static constexpr double UNSOLVED = -1;
+
+    struct row_stats {
+        std::string slot;
+        std::vector<double> sum;                  // [rotation]
+        std::vector<std::vector<int>> histogram;  // [rotation][length]
+        std::vector<int> unsolved;                // [rotation]
+        double best_sum = 0;
+        std::vector<int> best_histogram;          // [length], best over orientations
+        std::vector<int> best_rotation;           // [rotation], ties count for each
+    };
+
+    std::vector<std::string> rotations;
+    std::vector<row_stats> rows;
+    std::unordered_map<std::string, int> row_index;
+    int scrambles = 0;
+    int sol_num = 1;
+
+    void set_rotations(const std::vector<std::string>& rots) {
+        if (rotations.empty()) {
+            rotations = rots;
+        }
+    }
+
+    static int bin(double length) {
+        int b = static_cast<int>(std::lround(length));
+        return std::min(std::max(b, 0), HISTOGRAM_SIZE - 1);
+    }
+
+    void record(const std::string& slot, const std::vector<double>& lengths) {
+        if (lengths.empty()) {
+            return;
+        }
+        auto it = row_index.find(slot);
+        if (it == row_index.end()) {
+            row_stats r;
+            r.slot = slot;
+            r.sum.assign(lengths.size(), 0);
+            r.histogram.assign(lengths.size(), std::vector<int>(HISTOGRAM_SIZE, 0));
+            r.unsolved.assign(lengths.size(), 0);
+            r.best_histogram.assign(HISTOGRAM_SIZE, 0);
+            r.best_rotation.assign(lengths.size(), 0);
+            it = row_index.emplace(slot, static_cast<int>(rows.size())).first;
+            rows.emplace_back(r);
+        }
+        row_stats& r = rows[it->second];
+        double best = UNSOLVED;
+        for (size_t i = 0; i < lengths.size() && i < r.sum.size(); ++i) {
+            if (lengths[i] < 0) {
+                r.unsolved[i]++;
+                continue;
+            }
+            r.sum[i] += lengths[i];
+            r.histogram[i][bin(lengths[i])]++;
+            if (best < 0 || lengths[i] < best) {
+                best = lengths[i];
+            }
+        }
+        if (best < 0) {
+            return;
+        }
+        r.best_sum += best;
+        r.best_histogram[bin(best)]++;
+        for (size_t i = 0; i < lengths.size() && i < r.best_rotation.size(); ++i) {
+            if (lengths[i] == best) {
+                r.best_rotation[i]++;
+            }
+        }
+    }
+
+    static void append_ints(std::ostringstream& oss, const std::vector<int>& v) {
+        oss << "[";
+        for (size_t i = 0; i < v.size(); ++i) {
+            oss << (i > 0 ? "," : "") << v[i];
+        }
+        oss << "]";
+    }
+
+    std::string to_json() const {
+        std::ostringstream oss;
+        double n = scrambles > 0 ? scrambles : 1;
+        oss << "{\"scrambles\":" << scrambles << ",\"sol_num\":" << sol_num << ",\"rotations\":[";
+        for (size_t i = 0; i < rotations.size(); ++i) {
+            oss << (i > 0 ? "," : "") << "\"" << rotations[i] << "\"";
+        }
+        oss << "],\"rows\":[";
+        for (size_t k = 0; k < rows.size(); ++k) {
+            const row_stats& r = rows[k];
+            oss << (k > 0 ? "," : "") << "{\"slot\":\"" << r.slot << "\",\"mean\":[";
+            for (size_t i = 0; i < r.sum.size(); ++i) {
+                int solved = scrambles - r.unsolved[i];
+                oss << (i > 0 ? "," : "") << r.sum[i] / (solved > 0 ? solved : 1);
+            }
+            oss << "],\"histogram\":[";
+            for (size_t i = 0; i < r.histogram.size(); ++i) {
+                oss << (i > 0 ? "," : "");
+                append_ints(oss, r.histogram[i]);
+            }
+            oss << "],\"unsolved\":";
+            append_ints(oss, r.unsolved);
+            oss << ",\"best_mean\":" << r.best_sum / n << ",\"best_histogram\":";
+            append_ints(oss, r.best_histogram);
+            oss << ",\"best_rotation\":";
+            append_ints(oss, r.best_rotation);
+            oss << "}";
+        }
+        oss << "]}";
+        return oss.str();
+    }
+};
+
+// Runs analyze(scramble) for every non-blank line of scrambles with corpus
+// pointing at a fresh aggregator and returns its JSON. The run is one request:
+// the search budget starts here, and a stopped search ends the run without
+// counting the scramble it interrupted.
+template <class Analyze>
+std::string run_corpus(const std::string& scrambles, int sol_num, corpus_stats*& corpus, Analyze analyze) {
+    corpus_stats stats;
+    stats.sol_num = sol_num;
+    corpus = &stats;
+    SearchBudget::instance().begin();
+    std::istringstream iss(scrambles);
+    std::string scramble;
+    while (!SearchBudget::instance().stopped() && std::getline(iss, scramble)) {
+        if (scramble.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        analyze(scramble);
+        if (!SearchBudget::instance().stopped()) {
+            stats.scrambles++;
+        }
+    }
+    corpus = nullptr;
+    return stats.to_json();
+}
+
+// count random-move scrambles of length moves from seed, one per line, with
+// no same-face repeats and no redundant opposite-face pairs (U D U). These
+// are not random-state scrambles: their states are only approximately
+// uniform, so corpus means over them are estimates of the random-state means
+// (analyze_random samples states uniformly).
+inline std::string random_move_scrambles(int seed, int count, int length) {
+    static const char* const kFaces[] = {"U", "D", "L", "R", "F", "B"};
+    static const char* const kSuffixes[] = {"", "2", "'"};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> face_dist(0, 5);
+    std::uniform_int_distribution<int> suffix_dist(0, 2);
+    std::string result;
+    for (int k = 0; k < count; ++k) {
+        int prev = -1;
+        int prev2 = -1;
+        for (int i = 0; i < length; ++i) {
+            int face;
+            do {
+                face = face_dist(rng);
+            } while (face == prev || (prev2 == face && prev / 2 == face / 2));
+            result += kFaces[face];
+            result += kSuffixes[suffix_dist(rng)];
+            result += ' ';
+            prev2 = prev;
+            prev = face;
+        }
+        result += '\n';
+    }
+    return result;
+}
+
+#endif // CORPUS_STATS_H
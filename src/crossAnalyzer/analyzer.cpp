@@ -9,6 +9,12 @@
 #include <cstdlib>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
+#include "../corpus_stats.h"
+#include "../twophase/two_phase.h"
 
 int analyzer_count = 0;
 
@@ -94,34 +100,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -542,6 +530,31 @@ std::vector<bool> create_ma_table()
 	return ma;
 }
 
+// Corpus mode (analyze_corpus / analyze_random / analyze_random_moves, see
+// ../corpus_stats.h):
+// while corpus is set, rows are aggregated there instead of being posted.
+corpus_stats *corpus = nullptr;
+
+void post(const char *str)
+{
+	if (!corpus)
+	{
+		update(str);
+	}
+}
+
+void emit_row(const std::string &slot, const std::string &result, const std::vector<double> &lengths)
+{
+	if (corpus)
+	{
+		corpus->record(slot, lengths);
+	}
+	else
+	{
+		update((result + "</tr>").c_str());
+	}
+}
+
 struct cross_analyzer
 {
 	std::vector<int> sol;
@@ -550,8 +563,8 @@ struct cross_analyzer
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
@@ -568,8 +581,11 @@ struct cross_analyzer
 
 	cross_analyzer()
 	{
-		edge_move_table = create_edge_move_table();
-		multi_move_table = create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table/2", [&]()
+		{
+			return create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		});
 		index1 = 416;
 		index2 = 520;
 		prune_table = create_prune_table(index1, index2, 24 * 22, 24 * 22, 10, multi_move_table, multi_move_table);
@@ -578,6 +594,10 @@ struct cross_analyzer
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int depth, int prev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -658,6 +678,35 @@ struct cross_analyzer
 		return rotations_js[std::distance(rotations.begin(), it)];
 	}
 
+	// Move conjugation by a rotation: rotation_moves(rot)[m] is move m of the
+	// scramble as seen after rotating the cube by rot
+	static std::vector<int> rotation_moves(const std::string &rot)
+	{
+		std::vector<int> conj(18);
+		for (int m = 0; m < 18; ++m)
+		{
+			conj[m] = AlgRotation({m}, rot)[0];
+		}
+		return conj;
+	}
+
+	// IDA* state of one orientation, saved between depths so the searches of
+	// all orientations can be interleaved
+	struct orientation_search
+	{
+		std::vector<int> conj;
+		int index1 = 416;
+		int index2 = 520;
+		int bound = 0;
+		int count = 0;
+		int total_length = 0;
+		std::vector<int> sol_len;
+		bool done = false;
+	};
+
+	// 0 = solve every orientation; otherwise stop once this many are solved
+	int best_n = 0;
+
 	void start_search(std::string arg_scramble, std::string name, int arg_sol_num, std::vector<std::string> rotations)
 	{
 		scramble = arg_scramble;
@@ -667,6 +716,8 @@ struct cross_analyzer
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">None</th>";
+		std::string label = "None";
+		std::vector<double> lengths;
 		move_restrict.clear();
 		for (std::string name : restrict)
 		{
@@ -674,51 +725,130 @@ struct cross_analyzer
 			move_restrict.emplace_back(std::distance(move_names.begin(), it));
 		}
 
-		for (std::string rot : rotations)
+		// Start coordinates of every orientation in one pass over the scramble
+		int n = static_cast<int>(rotations.size());
+		std::vector<orientation_search> searches(n);
+		for (int r = 0; r < n; ++r)
 		{
-			std::vector<int> alg = AlgRotation(StringToAlg(scramble), rot);
-			index1 = 416;
-			index2 = 520;
-			count = 0;
-			total_length = 0;
-			sol.clear();
-			sol_len.clear();
-			for (int m : alg)
+			searches[r].conj = rotation_moves(rotations[r]);
+		}
+		for (int m : StringToAlg(scramble))
+		{
+			for (orientation_search &s : searches)
 			{
-				index1 = multi_move_table[index1 * 18 + m];
-				index2 = multi_move_table[index2 * 18 + m];
+				s.index1 = multi_move_table[s.index1 * 18 + s.conj[m]];
+				s.index2 = multi_move_table[s.index2 * 18 + s.conj[m]];
 			}
-			prune_tmp = prune_table[index1 * 528 + index2];
-			if (prune_tmp == 0)
+		}
+		int target = best_n > 0 ? std::min(best_n, n) : n;
+		int finished = 0;
+		for (orientation_search &s : searches)
+		{
+			s.bound = prune_table[s.index1 * 528 + s.index2];
+			if (s.bound == 0)
 			{
-				result += "<td class=" + converter_face(rot) + ">0</td>";
+				s.done = true;
+				finished++;
 			}
-			else
+		}
+
+		// All orientations at depth d before any at d + 1: the best ones are
+		// solved first and the rest are abandoned once target are done
+		// (orientations tied at the last depth are all kept)
+		for (int d = 1; d <= max_length && finished < target; d++)
+		{
+			for (orientation_search &s : searches)
 			{
-				index1 *= 18;
-				index2 *= 18;
-				for (int d = prune_tmp; d <= max_length; d++)
+				if (s.done || s.bound > d)
 				{
-					current_max_depth = d;
-					sol.resize(d);
-					if (depth_limited_search(index1, index2, d, 324))
-					{
-						break;
-					}
+					continue;
+				}
+				index1 = s.index1 * 18;
+				index2 = s.index2 * 18;
+				count = s.count;
+				total_length = s.total_length;
+				sol_len.swap(s.sol_len);
+				current_max_depth = d;
+				sol.resize(d);
+				s.done = depth_limited_search(index1, index2, d, 324);
+				s.count = count;
+				s.total_length = total_length;
+				sol_len.swap(s.sol_len);
+				if (s.done)
+				{
+					finished++;
 				}
+			}
+		}
+		if (SearchBudget::instance().stopped())
+		{
+			return;
+		}
+
+		for (int r = 0; r < n; ++r)
+		{
+			const orientation_search &s = searches[r];
+			const std::string &rot = rotations[r];
+			if (s.bound == 0)
+			{
+				lengths.emplace_back(0);
+				result += "<td class=" + converter_face(rot) + ">0</td>";
+			}
+			else if (!s.done)
+			{
+				// Abandoned by best-N: no measured length, reported as unsolved
+				lengths.emplace_back(corpus_stats::UNSOLVED);
+				result += "<td class=" + converter_face(rot) + ">-</td>";
+			}
+			else
+			{
+				lengths.emplace_back(arg_sol_num > 1 ? double(s.total_length) / sol_num : s.sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
-					oss << "<td class=" << converter_face(rot) << " onclick=\"solve(\'" << name << "\', " << converter(rot) << ")\">" << round(double(total_length) * 10 / sol_num) / 10 << "</td>";
+					oss << "<td class=" << converter_face(rot) << " onclick=\"solve(\'" << name << "\', " << converter(rot) << ")\">" << round(double(s.total_length) * 10 / sol_num) / 10 << "</td>";
 				}
 				else
 				{
-					oss << "<td class=" << converter_face(rot) << " onclick=\"solve(\'" << name << "\', " << converter(rot) << ")\">" << sol_len[0] << "</td>";
+					oss << "<td class=" << converter_face(rot) << " onclick=\"solve(\'" << name << "\', " << converter(rot) << ")\">" << s.sol_len[0] << "</td>";
 				}
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+	}
+
+	// Optimal cross length of (arg_index1, arg_index2), known to be at least
+	// lower; used by the incremental prefix mode. -1 if the search was stopped
+	int optimal_length(int arg_index1, int arg_index2, int lower)
+	{
+		prune_tmp = prune_table[arg_index1 * 528 + arg_index2];
+		if (prune_tmp == 0)
+		{
+			return 0;
+		}
+		max_length = 20;
+		sol_num = 1;
+		move_restrict.clear();
+		for (int i = 0; i < 18; ++i)
+		{
+			move_restrict.emplace_back(i);
+		}
+		index1 = arg_index1 * 18;
+		index2 = arg_index2 * 18;
+		for (int d = std::max(prune_tmp, lower); d <= max_length; d++)
+		{
+			count = 0;
+			total_length = 0;
+			sol_len.clear();
+			current_max_depth = d;
+			sol.resize(d);
+			if (depth_limited_search(index1, index2, d, 324))
+			{
+				return SearchBudget::instance().stopped() ? -1 : d;
+			}
+		}
+		return max_length;
 	}
 };
 
@@ -733,9 +863,9 @@ struct xcross_analyzer2
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> prune_table2;
 	std::vector<unsigned char> prune_table3;
@@ -774,9 +904,12 @@ struct xcross_analyzer2
 
 	xcross_analyzer2()
 	{
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("analyzer/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table2/4", [&]()
+		{
+			return create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		});
 		ma = create_ma_table();
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -792,6 +925,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_1(int arg_index1, int arg_index2, int arg_index3, int depth, int prev, std::vector<unsigned char> &prune1)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -886,6 +1023,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -915,6 +1054,7 @@ struct xcross_analyzer2
 			prune1_tmp = prune1[index1 + index2];
 			if (prune1_tmp == 0 && index3 == edge_solved1)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -930,6 +1070,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -942,7 +1087,52 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+	}
+
+	std::vector<unsigned char> &slot_prune_table(int slot)
+	{
+		std::vector<unsigned char> *tables[] = {&prune_table1, &prune_table2, &prune_table3, &prune_table4};
+		return *tables[slot];
+	}
+
+	// Optimal xcross length for slot from the raw coordinates (as in
+	// start_search_1 after applying the scramble), known to be at least lower;
+	// -1 if the search was stopped
+	int optimal_length_1(int slot, int arg_index1, int arg_index2, int arg_index3, int lower)
+	{
+		std::vector<int> single_edge_index = {0, 2, 4, 6};
+		std::vector<unsigned char> &prune1 = slot_prune_table(slot);
+		slot1 = slot;
+		edge_solved1 = single_edge_index[slot];
+		prune1_tmp = prune1[arg_index1 + arg_index2];
+		if (prune1_tmp == 0 && arg_index3 == edge_solved1)
+		{
+			return 0;
+		}
+		max_length = 20;
+		sol_num = 1;
+		move_restrict.clear();
+		for (int i = 0; i < 18; ++i)
+		{
+			move_restrict.emplace_back(i);
+		}
+		index1 = arg_index1;
+		index2 = arg_index2 * 18;
+		index3 = arg_index3 * 18;
+		for (int d = std::max(prune1_tmp, lower); d <= max_length; d++)
+		{
+			count = 0;
+			total_length = 0;
+			sol_len.clear();
+			current_max_depth = d;
+			sol.resize(d);
+			if (depth_limited_search_1(index1, index2, index3, d, 324, prune1))
+			{
+				return SearchBudget::instance().stopped() ? -1 : d;
+			}
+		}
+		return max_length;
 	}
 
 	void xcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -955,6 +1145,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_2(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1047,6 +1241,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1082,6 +1278,7 @@ struct xcross_analyzer2
 			prune2_tmp = prune2[index1 + index4];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && index5 == edge_solved1 && index6 == edge_solved2)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1099,6 +1296,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1111,7 +1313,52 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+	}
+
+	// Optimal xxcross length for slots s1, s2 from the raw coordinates (as in
+	// start_search_2 after applying the scramble), known to be at least lower;
+	// -1 if the search was stopped
+	int optimal_length_2(int s1, int s2, int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int lower)
+	{
+		std::vector<int> single_edge_index = {0, 2, 4, 6};
+		std::vector<unsigned char> &prune1 = slot_prune_table(s1);
+		std::vector<unsigned char> &prune2 = slot_prune_table(s2);
+		slot1 = s1;
+		slot2 = s2;
+		edge_solved1 = single_edge_index[s1];
+		edge_solved2 = single_edge_index[s2];
+		prune1_tmp = prune1[arg_index1 + arg_index2];
+		prune2_tmp = prune2[arg_index1 + arg_index4];
+		if (prune1_tmp == 0 && prune2_tmp == 0 && arg_index5 == edge_solved1 && arg_index6 == edge_solved2)
+		{
+			return 0;
+		}
+		max_length = 20;
+		sol_num = 1;
+		move_restrict.clear();
+		for (int i = 0; i < 18; ++i)
+		{
+			move_restrict.emplace_back(i);
+		}
+		index1 = arg_index1;
+		index2 = arg_index2 * 18;
+		index4 = arg_index4 * 18;
+		index5 = arg_index5 * 18;
+		index6 = arg_index6 * 18;
+		for (int d = std::max(std::max(prune1_tmp, prune2_tmp), lower); d <= max_length; d++)
+		{
+			count = 0;
+			total_length = 0;
+			sol_len.clear();
+			current_max_depth = d;
+			sol.resize(d);
+			if (depth_limited_search_2(index1, index2, index4, index5, index6, d, 324, prune1, prune2))
+			{
+				return SearchBudget::instance().stopped() ? -1 : d;
+			}
+		}
+		return max_length;
 	}
 
 	void xxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1126,6 +1373,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_3(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &prune3)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1232,6 +1483,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th>";
+		std::string label = name;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1273,6 +1526,7 @@ struct xcross_analyzer2
 			prune3_tmp = prune3[index1 + index6];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && index7 == edge_solved1 && index8 == edge_solved2 && index9 == edge_solved3)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1292,6 +1546,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1304,7 +1563,58 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+	}
+
+	// Optimal xxxcross length for slots s1, s2, s3 from the raw coordinates
+	// (as in start_search_3 after applying the scramble), known to be at least
+	// lower; -1 if the search was stopped
+	int optimal_length_3(int s1, int s2, int s3, int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int lower)
+	{
+		std::vector<int> single_edge_index = {0, 2, 4, 6};
+		std::vector<unsigned char> &prune1 = slot_prune_table(s1);
+		std::vector<unsigned char> &prune2 = slot_prune_table(s2);
+		std::vector<unsigned char> &prune3 = slot_prune_table(s3);
+		slot1 = s1;
+		slot2 = s2;
+		slot3 = s3;
+		edge_solved1 = single_edge_index[s1];
+		edge_solved2 = single_edge_index[s2];
+		edge_solved3 = single_edge_index[s3];
+		prune1_tmp = prune1[arg_index1 + arg_index2];
+		prune2_tmp = prune2[arg_index1 + arg_index4];
+		prune3_tmp = prune3[arg_index1 + arg_index6];
+		if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && arg_index7 == edge_solved1 && arg_index8 == edge_solved2 && arg_index9 == edge_solved3)
+		{
+			return 0;
+		}
+		max_length = 20;
+		sol_num = 1;
+		move_restrict.clear();
+		for (int i = 0; i < 18; ++i)
+		{
+			move_restrict.emplace_back(i);
+		}
+		index1 = arg_index1;
+		index2 = arg_index2 * 18;
+		index4 = arg_index4 * 18;
+		index6 = arg_index6 * 18;
+		index7 = arg_index7 * 18;
+		index8 = arg_index8 * 18;
+		index9 = arg_index9 * 18;
+		for (int d = std::max(std::max(prune1_tmp, std::max(prune2_tmp, prune3_tmp)), lower); d <= max_length; d++)
+		{
+			count = 0;
+			total_length = 0;
+			sol_len.clear();
+			current_max_depth = d;
+			sol.resize(d);
+			if (depth_limited_search_3(index1, index2, index4, index6, index7, index8, index9, d, 324, prune1, prune2, prune3))
+			{
+				return SearchBudget::instance().stopped() ? -1 : d;
+			}
+		}
+		return max_length;
 	}
 
 	void xxxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1316,8 +1626,57 @@ struct xcross_analyzer2
 	}
 };
 
-void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+// Keeps the move and prune tables between analyze() calls. Each analyzer is
+// built by the first call that requests its rows (cross / x, xx, xxx), so
+// later scrambles only pay for the searches.
+struct analyzer_session
 {
+	std::unique_ptr<cross_analyzer> cs;
+	std::unique_ptr<xcross_analyzer2> xcs;
+	int best_orientations = 0;
+
+	// Incremental prefix mode: one frame per applied move holding, for every
+	// row (cross, then x, xx and xxx slots) and orientation, the coordinates
+	// and the optimal length. Removing a move only pops a frame. A row over
+	// n slots keeps 1 + 2n coordinates: the cross edges, then the n corners,
+	// then the n slot edges (the cross row keeps its two cross coordinates).
+	static const int PREFIX_COORDS = 7;
+	struct prefix_frame
+	{
+		std::vector<int> coords;  // [(row * rotations + orientation) * PREFIX_COORDS + k]
+		std::vector<int> lengths; // [row * rotations + orientation]
+	};
+	std::vector<std::string> prefix_rotations;
+	std::vector<std::vector<int>> prefix_conj;
+	std::vector<std::string> prefix_rows;
+	std::vector<std::vector<int>> prefix_slots; // [row], empty for the cross row
+	std::vector<prefix_frame> prefix_stack;
+	std::vector<int> prefix_moves;
+
+	// Cross row: report only the best n orientations (0 = all); the others
+	// are left unsolved and shown as "-"
+	void set_best_orientations(int n)
+	{
+		best_orientations = n;
+	}
+
+	void analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string prefix_reset(bool cross, bool x, bool xx, bool xxx, std::string rot_set);
+	std::string prefix_push(std::string moves);
+	std::string prefix_pop();
+	std::string prefix_json();
+};
+
+void analyzer_session::analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	// A corpus run is one request; its budget starts in analyze_corpus
+	if (!corpus)
+	{
+		SearchBudget::instance().begin();
+	}
 	std::vector<std::string> rotations;
 	std::string table = "<br><table border=\"2\" id=\"analyzer_result\" translate=\"no\"><thead><tr><th class=\"sort\" data-sort=\"No\">No</th><th class=\"sort\" data-sort=\"slot\">slot</th>";
 	for (char c_tmp : rot_set)
@@ -1356,7 +1715,11 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	}
 	table += "</tr></thead><tbody class=\"list\"></tbody></table>";
 
-	update(table.c_str());
+	if (corpus)
+	{
+		corpus->set_rotations(rotations);
+	}
+	post(table.c_str());
 	int sol_num = std::stoi(num);
 	int count = 0;
 	if (cross)
@@ -1375,32 +1738,260 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	{
 		count += 4;
 	}
-	update((std::to_string(count)).c_str());
+	post((std::to_string(count)).c_str());
 	if (cross)
 	{
-		cross_analyzer cs;
-		cs.start_search(scramble, "", sol_num, rotations);
+		if (!cs)
+		{
+			cs.reset(new cross_analyzer());
+		}
+		cs->best_n = best_orientations;
+		cs->start_search(scramble, "", sol_num, rotations);
 	}
 	if (x || xx || xxx)
 	{
-		xcross_analyzer2 xcs;
+		if (!xcs)
+		{
+			xcs.reset(new xcross_analyzer2());
+		}
 		if (x)
 		{
-			xcs.xcross_analyze(scramble, sol_num, rotations);
+			xcs->xcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xx)
 		{
-			xcs.xxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xxx)
 		{
-			xcs.xxxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxxcross_analyze(scramble, sol_num, rotations);
+		}
+	}
+	if (SearchBudget::instance().stopped())
+	{
+		post(SearchBudget::instance().stop_message());
+	}
+	post("Finished.");
+}
+
+// Batch mode: one scramble per line. Nothing is posted; the aggregated
+// per-slot / per-orientation statistics are returned as JSON.
+std::string analyzer_session::analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	int saved_count = analyzer_count;
+	std::string json = run_corpus(scrambles, std::stoi(num), corpus, [&](const std::string &scramble)
+	{
+		analyze(scramble, cross, x, xx, xxx, num, rot_set);
+	});
+	analyzer_count = saved_count;
+	return json;
+}
+
+// Batch mode over count random-state scrambles from seed, solved two-phase
+// (see twophase::random_state_scrambles): a uniform sample of cube states.
+std::string analyzer_session::analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(twophase::random_state_scrambles(seed, count), cross, x, xx, xxx, num, rot_set);
+}
+
+// Extra batch mode over count random-move scrambles (25 moves) from seed,
+// e.g. to compare with results from other tools. Their states are only
+// approximately uniform; see random_move_scrambles.
+std::string analyzer_session::analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(random_move_scrambles(seed, count, 25), cross, x, xx, xxx, num, rot_set);
+}
+
+// Starts the incremental mode from the solved cube. Optimal lengths of the
+// requested rows (as in analyze: cross, the four xcross, six xxcross and four
+// xxxcross rows) are returned as JSON after every call.
+std::string analyzer_session::prefix_reset(bool cross, bool x, bool xx, bool xxx, std::string rot_set)
+{
+	std::vector<std::string> faces = {"D", "U", "L", "R", "F", "B"};
+	std::vector<std::string> face_rotations = {"", "z2", "z'", "z", "x'", "x"};
+	prefix_rotations.clear();
+	prefix_conj.clear();
+	for (char c_tmp : rot_set)
+	{
+		auto it = std::find(faces.begin(), faces.end(), std::string(1, c_tmp));
+		if (it != faces.end())
+		{
+			prefix_rotations.emplace_back(face_rotations[std::distance(faces.begin(), it)]);
+			prefix_conj.emplace_back(cross_analyzer::rotation_moves(prefix_rotations.back()));
+		}
+	}
+	prefix_rows.clear();
+	prefix_slots.clear();
+	prefix_frame frame;
+	int n = static_cast<int>(prefix_rotations.size());
+	if (cross)
+	{
+		if (!cs)
+		{
+			cs.reset(new cross_analyzer());
+		}
+		prefix_rows.emplace_back("None");
+		prefix_slots.emplace_back();
+		for (int o = 0; o < n; ++o)
+		{
+			frame.coords.insert(frame.coords.end(), {416, 520, 0, 0, 0, 0, 0});
+			frame.lengths.emplace_back(0);
+		}
+	}
+	std::vector<std::vector<int>> slot_rows;
+	if (x)
+	{
+		slot_rows.insert(slot_rows.end(), {{0}, {1}, {2}, {3}});
+	}
+	if (xx)
+	{
+		slot_rows.insert(slot_rows.end(), {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}});
+	}
+	if (xxx)
+	{
+		slot_rows.insert(slot_rows.end(), {{0, 1, 2}, {0, 1, 3}, {0, 2, 3}, {1, 2, 3}});
+	}
+	if (!slot_rows.empty() && !xcs)
+	{
+		xcs.reset(new xcross_analyzer2());
+	}
+	std::vector<std::string> names = {"BL", "BR", "FR", "FL"};
+	std::vector<int> corner_index = {12, 15, 18, 21};
+	std::vector<int> single_edge_index = {0, 2, 4, 6};
+	for (const std::vector<int> &slots : slot_rows)
+	{
+		std::string name;
+		std::vector<int> coords(PREFIX_COORDS, 0);
+		int s = static_cast<int>(slots.size());
+		coords[0] = 187520 * 24;
+		for (int j = 0; j < s; ++j)
+		{
+			name += (j > 0 ? " " : "") + names[slots[j]];
+			coords[1 + j] = corner_index[slots[j]];
+			coords[1 + s + j] = single_edge_index[slots[j]];
 		}
+		prefix_rows.emplace_back(name);
+		prefix_slots.emplace_back(slots);
+		for (int o = 0; o < n; ++o)
+		{
+			frame.coords.insert(frame.coords.end(), coords.begin(), coords.end());
+			frame.lengths.emplace_back(0);
+		}
+	}
+	prefix_stack.assign(1, frame);
+	prefix_moves.clear();
+	return prefix_json();
+}
+
+// Appends moves to the prefix. A move changes each optimal length by at most
+// one, so every search starts at (previous length - 1) and ends by
+// (previous length + 1). Lengths not found within the search budget are -1.
+std::string analyzer_session::prefix_push(std::string moves)
+{
+	SearchBudget::instance().begin();
+	if (prefix_stack.empty() || prefix_rows.empty())
+	{
+		return prefix_json();
 	}
-	update("Finished.");
+	int n = static_cast<int>(prefix_rotations.size());
+	for (int m : StringToAlg(moves))
+	{
+		prefix_frame frame = prefix_stack.back();
+		for (int r = 0; r < static_cast<int>(prefix_rows.size()); ++r)
+		{
+			const std::vector<int> &slots = prefix_slots[r];
+			int s = static_cast<int>(slots.size());
+			for (int o = 0; o < n; ++o)
+			{
+				int k = r * n + o;
+				int *c = &frame.coords[k * PREFIX_COORDS];
+				int mo = prefix_conj[o][m];
+				int lower = std::max(frame.lengths[k] - 1, 0);
+				if (s == 0)
+				{
+					c[0] = cs->multi_move_table[c[0] * 18 + mo];
+					c[1] = cs->multi_move_table[c[1] * 18 + mo];
+					frame.lengths[k] = cs->optimal_length(c[0], c[1], lower);
+					continue;
+				}
+				c[0] = xcs->multi_move_table[c[0] + mo];
+				for (int j = 1; j <= s; ++j)
+				{
+					c[j] = xcs->corner_move_table[c[j] * 18 + mo];
+					c[s + j] = xcs->edge_move_table[c[s + j] * 18 + mo];
+				}
+				if (s == 1)
+				{
+					frame.lengths[k] = xcs->optimal_length_1(slots[0], c[0], c[1], c[2], lower);
+				}
+				else if (s == 2)
+				{
+					frame.lengths[k] = xcs->optimal_length_2(slots[0], slots[1], c[0], c[1], c[2], c[3], c[4], lower);
+				}
+				else
+				{
+					frame.lengths[k] = xcs->optimal_length_3(slots[0], slots[1], slots[2], c[0], c[1], c[2], c[3], c[4], c[5], c[6], lower);
+				}
+			}
+		}
+		prefix_stack.emplace_back(frame);
+		prefix_moves.emplace_back(m);
+	}
+	return prefix_json();
+}
+
+// Removes the last move; the previous lengths are restored without searching
+std::string analyzer_session::prefix_pop()
+{
+	if (prefix_stack.size() > 1)
+	{
+		prefix_stack.pop_back();
+		prefix_moves.pop_back();
+	}
+	return prefix_json();
+}
+
+std::string analyzer_session::prefix_json()
+{
+	std::ostringstream oss;
+	int n = static_cast<int>(prefix_rotations.size());
+	oss << "{\"scramble\":\"" << AlgToString(prefix_moves) << "\",\"rotations\":[";
+	for (int o = 0; o < n; ++o)
+	{
+		oss << (o > 0 ? "," : "") << "\"" << prefix_rotations[o] << "\"";
+	}
+	oss << "],\"rows\":[";
+	for (size_t r = 0; r < prefix_rows.size() && !prefix_stack.empty(); ++r)
+	{
+		oss << (r > 0 ? "," : "") << "{\"slot\":\"" << prefix_rows[r] << "\",\"lengths\":[";
+		for (int o = 0; o < n; ++o)
+		{
+			oss << (o > 0 ? "," : "") << prefix_stack.back().lengths[r * n + o];
+		}
+		oss << "]}";
+	}
+	oss << "]}";
+	return oss.str();
+}
+
+void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	analyzer_session session;
+	session.analyze(scramble, cross, x, xx, xxx, num, rot_set);
 }
 
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("analyze", &analyzer);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::class_<analyzer_session>("Analyzer")
+		.constructor<>()
+		.function("analyze", &analyzer_session::analyze)
+		.function("analyze_corpus", &analyzer_session::analyze_corpus)
+		.function("analyze_random", &analyzer_session::analyze_random)
+		.function("analyze_random_moves", &analyzer_session::analyze_random_moves)
+		.function("set_best_orientations", &analyzer_session::set_best_orientations)
+		.function("prefix_reset", &analyzer_session::prefix_reset)
+		.function("prefix_push", &analyzer_session::prefix_push)
+		.function("prefix_pop", &analyzer_session::prefix_pop);
 }
\ No newline at end of file
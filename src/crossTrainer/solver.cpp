@@ -8,6 +8,8 @@
 #include <sstream>
 #include <cstdlib>
 #include <random>
+#include "../depth_sampler.h"
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
     postMessage(UTF8ToString(str));
@@ -91,34 +93,16 @@ std::unordered_map<std::string, State> moves = {
     {"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-    std::string result = "";
-    for (int i : alg)
-    {
-        result += move_names[i] + " ";
-    }
-    return result;
+    return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-    std::vector<int> alg;
-    std::istringstream iss(str);
-    std::string name;
-    while (iss >> name)
-    {
-        if (!name.empty())
-        {
-            auto it = std::find(move_names.begin(), move_names.end(), name);
-            if (it != move_names.end())
-            {
-                alg.emplace_back(std::distance(move_names.begin(), it));
-            }
-        }
-    }
-    return alg;
+    return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -320,23 +304,18 @@ std::vector<int> create_multi_move_table(int n, int c, int pn, int size, const s
     return move_table;
 }
 
-void create_prune_table(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table, std::vector<std::vector<int>> &index_list)
+void create_prune_table(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table)
 {
     int size = size1 * size2;
     prune_table = std::vector<unsigned char>(size, 255);
-    index_list = std::vector<std::vector<int>>(8);
-    std::vector<int> num_list = {15, 158, 1394, 9809, 46381, 97254, 34966, 102};
     int start = index1 * size2 + index2;
     int next_i;
     int index1_tmp;
     int index2_tmp;
     int next_d;
-    int num = 0;
     prune_table[start] = 0;
     for (int d = 0; d < depth; ++d)
     {
-        num = 0;
-        index_list[d].reserve(num_list[d]);
         next_d = d + 1;
         for (int i = 0; i < size; ++i)
         {
@@ -350,8 +329,6 @@ void create_prune_table(int index1, int index2, int size1, int size2, int depth,
                     if (prune_table[next_i] == 255)
                     {
                         prune_table[next_i] = next_d;
-                        index_list[d][num] = next_i;
-                        num += 1;
                     }
                 }
             }
@@ -387,7 +364,7 @@ struct cross_search
     std::vector<int> edge_move_table;
     std::vector<int> multi_move_table;
     std::vector<unsigned char> prune_table;
-    std::vector<std::vector<int>> index_list;
+    DepthSampler depth_sampler;
     std::vector<int> alg;
     std::vector<std::string> restrict;
     std::vector<int> move_restrict;
@@ -399,7 +376,6 @@ struct cross_search
     int prune_tmp;
     std::string tmp;
     std::mt19937 generator;
-    std::vector<int> num_list;
     int current_max_depth;
 
     cross_search()
@@ -408,11 +384,11 @@ struct cross_search
         multi_move_table = create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
         index1 = 416;
         index2 = 520;
-        create_prune_table(index1, index2, 24 * 22, 24 * 22, 10, multi_move_table, multi_move_table, prune_table, index_list);
+        create_prune_table(index1, index2, 24 * 22, 24 * 22, 10, multi_move_table, multi_move_table, prune_table);
+        depth_sampler.build(prune_table, 10);
         ma = create_ma_table();
         std::random_device rd;
         generator.seed(rd());
-        num_list = {15, 158, 1394, 9809, 46381, 97254, 34966, 102};
         move_restrict = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
     }
 
@@ -492,8 +468,11 @@ struct cross_search
     {
         sol.clear();
         int len = std::stoi(arg_length);
-        std::uniform_int_distribution<> distribution(0, num_list[len - 1] - 1);
-        int cross_index = index_list[len - 1][distribution(generator)];
+        if (len < 1 || depth_sampler.count(len) == 0)
+        {
+            return "";
+        }
+        int cross_index = static_cast<int>(depth_sampler.sample(prune_table, len, generator));
         index1 = cross_index / 528;
         index2 = cross_index % 528;
         index1 *= 18;
@@ -544,6 +523,12 @@ struct cross_search
         return tmp;
     }
 
+    // Number of states at depth (0 past the sampled depths)
+    int get_depth_count(int depth)
+    {
+        return static_cast<int>(depth_sampler.count(depth));
+    }
+
     std::string func(std::string arg_scramble = "", std::string arg_length = "8")
     {
         std::string ret = arg_scramble + start_search(arg_scramble) + "," + get_cross_scramble(arg_length);
@@ -555,5 +540,6 @@ EMSCRIPTEN_BINDINGS(my_module)
 {
     emscripten::class_<cross_search>("cross_search")
         .constructor<>()
-        .function("func", &cross_search::func);
+        .function("func", &cross_search::func)
+        .function("depth_count", &cross_search::get_depth_count);
 }
@@ -0,0 +1,90 @@
+#ifndef DEPTH_SAMPLER_H
+#define DEPTH_SAMPLER_H
+
+// =============================================================================
+// Depth Sampler
+// =============================================================================
+//
+// Draws a uniform random state of an exact depth straight from a byte prune
+// table (entry = depth, 255 = not reached), instead of keeping a list of the
+// states of every depth beside the table.
+//
+// build() counts the entries of each depth in blocks of kBlock entries and
+// stores the running totals (rank). sample() picks k uniformly among the
+// count(d) entries of depth d, binary-searches the block holding the k-th one
+// and scans that block (select).
+//
+// The index takes (max_depth + 1) * 4 bytes per block: about 0.8 MB for the
+// 73M-entry xcross table, whose per-depth lists took about 300 MB.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class DepthSampler {
+public:
+    static const size_t kBlock = 4096;
+
+    // Index table; entries above max_depth are never sampled. table must be
+    // the one passed to sample() later and must not change in between.
+    void build(const std::vector<unsigned char>& table, int max_depth) {
+        const size_t blocks = (table.size() + kBlock - 1) / kBlock;
+        max_depth_ = max_depth;
+        stride_ = blocks + 1;
+        rank_.assign((max_depth + 1) * stride_, 0);
+        std::vector<uint32_t> running(max_depth + 1, 0);
+        for (size_t b = 0; b < blocks; ++b) {
+            for (int d = 0; d <= max_depth; ++d) {
+                rank_[d * stride_ + b] = running[d];
+            }
+            const size_t end = std::min(table.size(), (b + 1) * kBlock);
+            for (size_t i = b * kBlock; i < end; ++i) {
+                if (table[i] <= max_depth) {
+                    running[table[i]]++;
+                }
+            }
+        }
+        for (int d = 0; d <= max_depth; ++d) {
+            rank_[d * stride_ + blocks] = running[d];
+        }
+    }
+
+    // Number of entries of depth d
+    uint32_t count(int depth) const {
+        if (depth < 0 || depth > max_depth_) return 0;
+        return rank_[depth * stride_ + stride_ - 1];
+    }
+
+    // Position of the k-th entry (0-based) of depth d, -1 if there is none
+    long long select(const std::vector<unsigned char>& table, int depth, uint32_t k) const {
+        if (k >= count(depth)) return -1;
+        const uint32_t* rank = rank_.data() + depth * stride_;
+        const size_t b = std::upper_bound(rank, rank + stride_, k) - rank - 1;
+        uint32_t left = k - rank[b];
+        for (size_t i = b * kBlock;; ++i) {
+            if (table[i] == depth && left-- == 0) {
+                return static_cast<long long>(i);
+            }
+        }
+    }
+
+    // Uniform random entry of depth d, -1 if there is none
+    template <class Generator>
+    long long sample(const std::vector<unsigned char>& table, int depth, Generator& generator) const {
+        const uint32_t n = count(depth);
+        if (n == 0) return -1;
+        std::uniform_int_distribution<uint32_t> distribution(0, n - 1);
+        return select(table, depth, distribution(generator));
+    }
+
+    size_t bytes() const { return rank_.size() * sizeof(uint32_t); }
+
+private:
+    int max_depth_ = -1;
+    size_t stride_ = 0;
+    std::vector<uint32_t> rank_;  // [depth * stride_ + block] = entries of depth before block
+};
+
+#endif // DEPTH_SAMPLER_H
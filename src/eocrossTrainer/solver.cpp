@@ -8,6 +8,8 @@
 #include <sstream>
 #include <cstdlib>
 #include <random>
+#include "../depth_sampler.h"
+#include "../move_sequence.h"
 
 struct State
 {
@@ -87,34 +89,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -452,23 +436,18 @@ void create_prune_table2(int index1, int index2, int size1, int size2, int depth
 	}
 }
 
-void create_prune_table3(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table, std::vector<std::vector<int>> &index_list)
+void create_prune_table3(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table)
 {
 	int size = size1 * size2;
 	prune_table = std::vector<unsigned char>(size, 255);
-	index_list = std::vector<std::vector<int>>(10);
-	std::vector<int> num_list = {15, 178, 1982, 21041, 204732, 1645039, 8477633, 12917628, 1061851, 140};
 	int start = index1 * size2 + index2;
 	int next_i;
 	int index1_tmp;
 	int index2_tmp;
 	int next_d;
-	int num = 0;
 	prune_table[start] = 0;
 	for (int d = 0; d < depth; ++d)
 	{
-		num = 0;
-		index_list[d].reserve(num_list[d]);
 		next_d = d + 1;
 		for (int i = 0; i < size; ++i)
 		{
@@ -482,8 +461,6 @@ void create_prune_table3(int index1, int index2, int size1, int size2, int depth
 					if (prune_table[next_i] == 255)
 					{
 						prune_table[next_i] = next_d;
-						index_list[d][num] = next_i;
-						num += 1;
 					}
 				}
 			}
@@ -519,7 +496,7 @@ struct cross_search
 	std::vector<int> dep_move_table;
 	std::vector<int> eo_move_table;
 	std::vector<unsigned char> prune_table_dep_eo;
-	std::vector<std::vector<int>> index_list;
+	DepthSampler depth_sampler;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -531,7 +508,6 @@ struct cross_search
 	int prune_tmp;
 	std::string tmp;
 	std::mt19937 generator;
-	std::vector<int> num_list;
 	int current_max_depth;
 
 	cross_search()
@@ -541,11 +517,11 @@ struct cross_search
 		dep_move_table = create_multi_move_table(4, 1, 12, 12 * 11 * 10 * 9, single_ep_move_table);
 		index_dep = 11720;
 		index_eo = 0;
-		create_prune_table3(index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 10, dep_move_table, eo_move_table, prune_table_dep_eo, index_list);
+		create_prune_table3(index_dep, index_eo, 12 * 11 * 10 * 9, 2048, 10, dep_move_table, eo_move_table, prune_table_dep_eo);
+		depth_sampler.build(prune_table_dep_eo, 10);
 		ma = create_ma_table();
 		std::random_device rd;
 		generator.seed(rd());
-		num_list = {15, 178, 1982, 21041, 204732, 1645039, 8477633, 12917628, 1061851, 140};
 		move_restrict = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
 	}
 
@@ -625,8 +601,11 @@ struct cross_search
 	{
 		sol.clear();
 		int len = std::stoi(arg_length);
-		std::uniform_int_distribution<> distribution(0, num_list[len - 1] - 1);
-		int cross_index = index_list[len - 1][distribution(generator)];
+		if (len < 1 || depth_sampler.count(len) == 0)
+		{
+			return "";
+		}
+		int cross_index = static_cast<int>(depth_sampler.sample(prune_table_dep_eo, len, generator));
 		index_dep = cross_index / 2048;
 		index_eo = cross_index % 2048;
 		index_dep *= 18;
@@ -676,6 +655,12 @@ struct cross_search
 		return tmp;
 	}
 
+	// Number of states at depth (0 past the sampled depths)
+	int get_depth_count(int depth)
+	{
+		return static_cast<int>(depth_sampler.count(depth));
+	}
+
 	std::string func(std::string arg_scramble = "", std::string arg_length = "8")
 	{
 		std::string ret = arg_scramble + start_search(arg_scramble) + "," + get_cross_scramble(arg_length);
@@ -687,5 +672,6 @@ EMSCRIPTEN_BINDINGS(my_module)
 {
     emscripten::class_<cross_search>("cross_search")
         .constructor<>()
-        .function("func", &cross_search::func);
+        .function("func", &cross_search::func)
+		.function("depth_count", &cross_search::get_depth_count);
 }
\ No newline at end of file
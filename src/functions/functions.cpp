@@ -6,8 +6,16 @@
 #include <unordered_map>
 #include <string>
 #include <sstream>
+#include <cctype>
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#include "../move_sequence.h"
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 std::unordered_map<std::string, std::string> move_convert =
 	{
 		{"U", "U"},
@@ -297,31 +305,12 @@ std::unordered_map<std::string, std::string> rotation_reverse = {
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string &str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::string MirrorScramble(std::string str)
@@ -364,54 +353,47 @@ std::string ReverseScramble(std::string str)
 	return result;
 }
 
-std::vector<int> AlgConvertRotation(std::vector<int> &alg, std::string &rotation)
+// Face permutation of each rotation, in the order of rotation_codec
+std::vector<std::vector<int>> rotation_face_lists = {
+	{5, 4, 2, 3, 0, 1},
+	{1, 0, 2, 3, 5, 4},
+	{4, 5, 2, 3, 1, 0},
+	{0, 1, 5, 4, 2, 3},
+	{0, 1, 3, 2, 5, 4},
+	{0, 1, 4, 5, 3, 2},
+	{3, 2, 0, 1, 4, 5},
+	{1, 0, 3, 2, 4, 5},
+	{2, 3, 1, 0, 4, 5}};
+
+MoveCodec rotation_codec({"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"});
+
+// Move id map of each rotation: move_maps[r][m] = m with its face sent
+// through rotation_face_lists[r]
+std::vector<std::vector<int>> create_rotation_move_maps()
 {
-	if (rotation.empty())
-	{
-		return alg;
-	}
-	std::vector<int> face_list_0 = {0, 1, 2, 3, 4, 5};
-	std::vector<int> face_list;
-	if (rotation == "x")
-	{
-		face_list = {5, 4, 2, 3, 0, 1};
-	}
-	else if (rotation == "x2" || rotation == "x2'")
-	{
-		face_list = {1, 0, 2, 3, 5, 4};
-	}
-	else if (rotation == "x'")
-	{
-		face_list = {4, 5, 2, 3, 1, 0};
-	}
-	else if (rotation == "y")
-	{
-		face_list = {0, 1, 5, 4, 2, 3};
-	}
-	else if (rotation == "y2" || rotation == "y2'")
-	{
-		face_list = {0, 1, 3, 2, 5, 4};
-	}
-	else if (rotation == "y'")
-	{
-		face_list = {0, 1, 4, 5, 3, 2};
-	}
-	else if (rotation == "z")
-	{
-		face_list = {3, 2, 0, 1, 4, 5};
-	}
-	else if (rotation == "z2" || rotation == "z2'")
-	{
-		face_list = {1, 0, 3, 2, 4, 5};
-	}
-	else if (rotation == "z'")
+	std::vector<std::vector<int>> move_maps(rotation_face_lists.size(), std::vector<int>(18));
+	for (size_t r = 0; r < rotation_face_lists.size(); ++r)
 	{
-		face_list = {2, 3, 1, 0, 4, 5};
+		for (int m = 0; m < 18; ++m)
+		{
+			move_maps[r][m] = 3 * rotation_face_lists[r][m / 3] + m % 3;
+		}
 	}
-	for (size_t i = 0; i < alg.size(); ++i)
+	return move_maps;
+}
+
+std::vector<std::vector<int>> rotation_move_maps = create_rotation_move_maps();
+
+std::vector<int> AlgConvertRotation(std::vector<int> &alg, std::string &rotation)
+{
+	// "x2'" is the same rotation as "x2"
+	size_t length = rotation.size() == 3 && rotation[1] == '2' ? 2 : rotation.size();
+	int r = rotation_codec.id(rotation.data(), length);
+	if (r == -1)
 	{
-		alg[i] = 3 * face_list[alg[i] / 3] + alg[i] % 3;
+		return alg;
 	}
+	conjugate_moves(alg, rotation_move_maps[r]);
 	return alg;
 }
 
@@ -480,40 +462,6 @@ struct State
 	}
 };
 
-std::string StateToInput(const State &state)
-{
-	std::vector<int> sc = state.sc;
-	std::string input = "";
-	for (int i : sc)
-	{
-		if (i < 9)
-		{
-			input += "U";
-		}
-		else if (i < 18)
-		{
-			input += "R";
-		}
-		else if (i < 27)
-		{
-			input += "F";
-		}
-		else if (i < 36)
-		{
-			input += "D";
-		}
-		else if (i < 45)
-		{
-			input += "L";
-		}
-		else
-		{
-			input += "B";
-		}
-	}
-	return input;
-}
-
 std::unordered_map<std::string, State> moves = {
 	{"U", State({6, 3, 0, 7, 4, 1, 8, 5, 2, 45, 46, 47, 12, 13, 14, 15, 16, 17, 9, 10, 11, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 18, 19, 20, 39, 40, 41, 42, 43, 44, 36, 37, 38, 48, 49, 50, 51, 52, 53})},
 	{"U2", State({8, 7, 6, 5, 4, 3, 2, 1, 0, 36, 37, 38, 12, 13, 14, 15, 16, 17, 45, 46, 47, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 9, 10, 11, 39, 40, 41, 42, 43, 44, 18, 19, 20, 48, 49, 50, 51, 52, 53})},
@@ -534,24 +482,159 @@ std::unordered_map<std::string, State> moves = {
 	{"B2", State({35, 34, 33, 3, 4, 5, 6, 7, 8, 9, 10, 42, 12, 13, 39, 15, 16, 36, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 2, 1, 0, 17, 37, 38, 14, 40, 41, 11, 43, 44, 53, 52, 51, 50, 49, 48, 47, 46, 45})},
 	{"B'", State({42, 39, 36, 3, 4, 5, 6, 7, 8, 9, 10, 0, 12, 13, 1, 15, 16, 2, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 17, 14, 11, 33, 37, 38, 34, 40, 41, 35, 43, 44, 47, 50, 53, 46, 49, 52, 45, 48, 51})}};
 
-std::string ScrambleToState(std::string scramble)
+// =============================================================================
+// Facelet Engine
+// =============================================================================
+//
+// The 54 facelets (colour letters, faces U R F D L B) in a 64-byte buffer of
+// four 16-byte vectors. A move is the byte permutation of its State
+// (new[i] = old[perm[i]]), precomputed as 4 x 4 lane shuffles: output vector k
+// is the OR of the shuffles of the four source vectors, with 0x80 (zero) for
+// the lanes another source provides. Applied with wasm i8x16.swizzle or SSSE3
+// pshufb, and a byte loop on other targets.
+
+struct alignas(16) FaceletState
+{
+	unsigned char f[64];
+};
+
+struct alignas(16) FaceletMove
+{
+	unsigned char perm[64];
+	unsigned char lane[4][4][16]; // [output vector][source vector]
+};
+
+std::vector<FaceletMove> create_facelet_moves()
+{
+	std::vector<FaceletMove> table(18);
+	for (int m = 0; m < 18; ++m)
+	{
+		const std::vector<int> &sc = moves[move_names[m]].sc;
+		FaceletMove &move = table[m];
+		for (int i = 0; i < 64; ++i)
+		{
+			move.perm[i] = i < 54 ? sc[i] : i;
+		}
+		for (int k = 0; k < 4; ++k)
+		{
+			for (int s = 0; s < 4; ++s)
+			{
+				for (int j = 0; j < 16; ++j)
+				{
+					int src = move.perm[16 * k + j];
+					move.lane[k][s][j] = src / 16 == s ? src % 16 : 0x80;
+				}
+			}
+		}
+	}
+	return table;
+}
+
+std::vector<FaceletMove> facelet_moves = create_facelet_moves();
+
+FaceletState solved_facelets()
 {
-	std::vector<std::string> faces;
-	for (const auto &pair : moves)
+	FaceletState state;
+	const std::string solved = "UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB";
+	std::copy(solved.begin(), solved.end(), state.f);
+	std::fill(state.f + 54, state.f + 64, 0);
+	return state;
+}
+
+inline void apply_facelet_move(FaceletState &state, const FaceletMove &move)
+{
+#if defined(__wasm_simd128__)
+	v128_t src[4];
+	for (int s = 0; s < 4; ++s)
 	{
-		faces.emplace_back(pair.first);
+		src[s] = wasm_v128_load(state.f + 16 * s);
 	}
-	State state;
-	std::string name;
-	std::istringstream iss(scramble);
-	while (iss >> name)
+	for (int k = 0; k < 4; ++k)
 	{
-		if (!name.empty())
+		v128_t out = wasm_i8x16_swizzle(src[0], wasm_v128_load(move.lane[k][0]));
+		for (int s = 1; s < 4; ++s)
+		{
+			out = wasm_v128_or(out, wasm_i8x16_swizzle(src[s], wasm_v128_load(move.lane[k][s])));
+		}
+		wasm_v128_store(state.f + 16 * k, out);
+	}
+#elif defined(__SSSE3__)
+	__m128i src[4];
+	for (int s = 0; s < 4; ++s)
+	{
+		src[s] = _mm_load_si128(reinterpret_cast<const __m128i *>(state.f + 16 * s));
+	}
+	for (int k = 0; k < 4; ++k)
+	{
+		__m128i out = _mm_shuffle_epi8(src[0], _mm_load_si128(reinterpret_cast<const __m128i *>(move.lane[k][0])));
+		for (int s = 1; s < 4; ++s)
+		{
+			out = _mm_or_si128(out, _mm_shuffle_epi8(src[s], _mm_load_si128(reinterpret_cast<const __m128i *>(move.lane[k][s]))));
+		}
+		_mm_store_si128(reinterpret_cast<__m128i *>(state.f + 16 * k), out);
+	}
+#else
+	FaceletState old = state;
+	for (int i = 0; i < 64; ++i)
+	{
+		state.f[i] = old.f[move.perm[i]];
+	}
+#endif
+}
+
+// Index in move_names of a face turn ("R", "R2", "R'"), -1 for other tokens
+inline int facelet_move_id(const char *name, size_t length)
+{
+	return move_codec.id(name, length);
+}
+
+// Facelets after the scramble in [begin, end); tokens other than face turns
+// are ignored
+std::string scramble_facelets(const char *begin, const char *end)
+{
+	FaceletState state = solved_facelets();
+	const char *p = begin;
+	while (p < end)
+	{
+		while (p < end && std::isspace(static_cast<unsigned char>(*p)))
+		{
+			++p;
+		}
+		const char *token = p;
+		while (p < end && !std::isspace(static_cast<unsigned char>(*p)))
+		{
+			++p;
+		}
+		int id = facelet_move_id(token, p - token);
+		if (id != -1)
 		{
-			state.apply_move(moves[name]);
+			apply_facelet_move(state, facelet_moves[id]);
 		}
 	}
-	std::string output = StateToInput(state);
+	return std::string(state.f, state.f + 54);
+}
+
+std::string ScrambleToState(std::string scramble)
+{
+	return scramble_facelets(scramble.data(), scramble.data() + scramble.size());
+}
+
+// ScrambleToState for each line of scrambles; one facelet string per line
+std::string ScrambleToStates(std::string scrambles)
+{
+	std::string output;
+	size_t begin = 0;
+	while (begin < scrambles.size())
+	{
+		size_t end = scrambles.find('\n', begin);
+		if (end == std::string::npos)
+		{
+			end = scrambles.size();
+		}
+		output += scramble_facelets(scrambles.data() + begin, scrambles.data() + end);
+		output += "\n";
+		begin = end + 1;
+	}
 	return output;
 }
 
@@ -619,7 +702,8 @@ std::vector<std::string> maskRotation(std::string &arg_e_mask, std::string &arg_
 	return {m.e_mask, m.c_mask};
 }
 
-std::string convertMask(std::string center, std::string input_e, std::string input_c, std::string rotation_alg)
+// Edge, corner and center masks before the rotation
+std::vector<std::string> createMask(std::string center, std::string input_e, std::string input_c)
 {
 	// de, ble, bre, fre, fle, lle
 	// blc, brc, frc, flc, llc
@@ -695,8 +779,30 @@ std::string convertMask(std::string center, std::string input_e, std::string inp
 			}
 		}
 	}
-	std::vector results = maskRotation(e_mask, c_mask, rotation_alg);
-	return results[0] + results[1] + center_mask;
+	return {e_mask, c_mask, center_mask};
+}
+
+std::string convertMask(std::string center, std::string input_e, std::string input_c, std::string rotation_alg)
+{
+	std::vector<std::string> masks = createMask(center, input_e, input_c);
+	std::vector<std::string> results = maskRotation(masks[0], masks[1], rotation_alg);
+	return results[0] + results[1] + masks[2];
+}
+
+// convertMask for each line of rotation_algs; the masks are built once, one
+// result per line
+std::string convertMasks(std::string center, std::string input_e, std::string input_c, std::string rotation_algs)
+{
+	std::vector<std::string> masks = createMask(center, input_e, input_c);
+	std::string output;
+	std::string rotation_alg;
+	std::istringstream iss(rotation_algs);
+	while (std::getline(iss, rotation_alg))
+	{
+		std::vector<std::string> results = maskRotation(masks[0], masks[1], rotation_alg);
+		output += results[0] + results[1] + masks[2] + "\n";
+	}
+	return output;
 }
 
 // Get Center Offset
@@ -904,24 +1010,18 @@ std::vector<std::vector<int>> index_to_center =
 		{4, 5, 0, 1, 2, 3}};
 
 std::vector<std::string> move_names2 = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'", "u", "u2", "u'", "d", "d2", "d'", "l", "l2", "l'", "r", "r2", "r'", "f", "f2", "f'", "b", "b2", "b'", "M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'", "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
+MoveCodec move_codec2(move_names2);
 
 std::vector<int> StringToAlg2(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names2.begin(), move_names2.end(), name);
-			if (it != move_names2.end())
-			{
-				alg.emplace_back(std::distance(move_names2.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec2.parse(str);
+}
+
+// str with redundant moves cancelled or merged ("R U U' R2" -> "R' "); wide
+// and slice moves and rotations are kept, other tokens dropped
+std::string ReduceScramble(std::string str)
+{
+	return move_codec2.format(move_codec2.reduce(move_codec2.parse(str)));
 }
 
 std::vector<std::vector<int>> rotationMap =
@@ -1016,7 +1116,10 @@ EMSCRIPTEN_BINDINGS(my_module)
 	emscripten::function("scr_mirror", &MirrorScramble);
 	emscripten::function("scr_reverse", &ReverseScramble);
 	emscripten::function("scr_converter", &ConvertScramble);
+	emscripten::function("scr_reduce", &ReduceScramble);
 	emscripten::function("ScrambleToState", &ScrambleToState);
+	emscripten::function("ScrambleToStates", &ScrambleToStates);
 	emscripten::function("convertMask", &convertMask);
+	emscripten::function("convertMasks", &convertMasks);
 	emscripten::function("get_center", &get_center_offset_param);
 }
\ No newline at end of file
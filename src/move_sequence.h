@@ -0,0 +1,253 @@
+#ifndef MOVE_SEQUENCE_H
+#define MOVE_SEQUENCE_H
+
+// =============================================================================
+// Move Sequences
+// =============================================================================
+//
+// Move ids are indices into a module's move_names. MoveCodec is built from
+// those names (letter plus "", "2" or "'") and turns a token into its id with
+// one lookup in a [letter][suffix] table instead of a std::find over the
+// names.
+//
+// reduce() cancels and merges moves. All moves about one axis (U D E u d y,
+// L R M l r x, F B S f b z) commute, so within a run of such moves the
+// quarter turns of each letter are summed mod 4: "R L R" -> "R2 L",
+// "U D U'" -> "D", "R U U' R'" -> "". Surviving letters keep the order of
+// their first appearance; with ordered = true they follow the axis order
+// above instead, which gives sequences differing only by swaps of commuting
+// moves one form. follows_out_of_order() is the same order as a successor
+// mask for the searches.
+//
+// conjugate_moves() rewrites ids through one row of a rotation map
+// (rotationMap[r][id] in the solvers).
+//
+// Canonical mode (set_canonical_mode, off by default) is for solvers asked for
+// many solutions. Their successor masks then keep the canonical order even
+// where a move-order override would allow a swapped pair, and SolutionSet
+// drops a solution whose canonical form was already posted by the same
+// search, so sol_num counts distinct solutions.
+
+#include <set>
+#include <string>
+#include <vector>
+
+class MoveCodec {
+public:
+    explicit MoveCodec(const std::vector<std::string>& names) : names_(names) {
+        for (int c = 0; c < 128; ++c) {
+            for (int a = 0; a < 3; ++a) {
+                ids_[c][a] = -1;
+            }
+            axis_[c] = -1;
+            order_[c] = -1;
+        }
+        static const char* const kAxes[] = {"UDEudy", "LRMlrx", "FBSfbz"};
+        for (int axis = 0; axis < 3; ++axis) {
+            for (const char* p = kAxes[axis]; *p; ++p) {
+                axis_[static_cast<int>(*p)] = axis;
+                order_[static_cast<int>(*p)] = static_cast<int>(p - kAxes[axis]);
+            }
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            int amount = suffix_amount(names[i].c_str() + 1, names[i].size() - 1);
+            unsigned char letter = static_cast<unsigned char>(names[i][0]);
+            if (amount > 0 && letter < 128 && ids_[letter][amount - 1] == -1) {
+                ids_[letter][amount - 1] = static_cast<int>(i);
+            }
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            unsigned char letter = static_cast<unsigned char>(names[i][0]);
+            Move move = {-1, 0, 0, -1};
+            move.amount = suffix_amount(names[i].c_str() + 1, names[i].size() - 1);
+            if (move.amount > 0 && letter < 128) {
+                move.letter = letter;
+                move.axis = axis_[letter];
+                move.order = order_[letter];
+            }
+            moves_.push_back(move);
+        }
+    }
+
+    // Id of the token [name, name + length), -1 if it is not a move name
+    int id(const char* name, size_t length) const {
+        if (length == 0 || length > 2) return -1;
+        unsigned char letter = static_cast<unsigned char>(name[0]);
+        int amount = suffix_amount(name + 1, length - 1);
+        if (letter >= 128 || amount == 0) return -1;
+        return ids_[letter][amount - 1];
+    }
+
+    // Ids of the whitespace separated tokens of str; unknown tokens are skipped
+    std::vector<int> parse(const std::string& str) const {
+        std::vector<int> alg;
+        const char* p = str.data();
+        const char* end = p + str.size();
+        while (p < end) {
+            while (p < end && is_space(*p)) ++p;
+            const char* token = p;
+            while (p < end && !is_space(*p)) ++p;
+            int move = id(token, p - token);
+            if (move != -1) {
+                alg.push_back(move);
+            }
+        }
+        return alg;
+    }
+
+    // Names of alg, each followed by a space
+    std::string format(const std::vector<int>& alg) const {
+        std::string result;
+        result.reserve(alg.size() * 3);
+        for (int move : alg) {
+            result += names_[move];
+            result += ' ';
+        }
+        return result;
+    }
+
+    // Appends move to alg and cancels / merges it with the run of moves about
+    // the same axis it joins; see the comment at the top
+    void push(std::vector<int>& alg, int move, bool ordered = false) const {
+        const Move& m = moves_[move];
+        if (m.axis == -1) {
+            alg.push_back(move);
+            return;
+        }
+        size_t start = alg.size();
+        while (start > 0 && moves_[alg[start - 1]].axis == m.axis) {
+            --start;
+        }
+        for (size_t i = start; i < alg.size(); ++i) {
+            const Move& other = moves_[alg[i]];
+            if (other.letter != m.letter) continue;
+            int amount = (other.amount + m.amount) & 3;
+            if (amount == 0) {
+                alg.erase(alg.begin() + i);
+            } else if (ids_[m.letter][amount - 1] != -1) {
+                alg[i] = ids_[m.letter][amount - 1];
+            } else {
+                break;
+            }
+            return;
+        }
+        size_t position = alg.size();
+        if (ordered) {
+            while (position > start && moves_[alg[position - 1]].order > m.order) {
+                --position;
+            }
+        }
+        alg.insert(alg.begin() + position, move);
+    }
+
+    std::vector<int> reduce(const std::vector<int>& alg, bool ordered = false) const {
+        std::vector<int> result;
+        result.reserve(alg.size());
+        for (int move : alg) {
+            push(result, move, ordered);
+        }
+        return result;
+    }
+
+    // format(reduce(prefix + alg)): a fixed prefix (post_alg) followed by a
+    // search result
+    std::string join(const std::vector<int>& prefix, const std::vector<int>& alg) const {
+        std::vector<int> result;
+        result.reserve(prefix.size() + alg.size());
+        for (int move : prefix) {
+            push(result, move);
+        }
+        for (int move : alg) {
+            push(result, move);
+        }
+        return format(result);
+    }
+
+    // True if next directly after prev is not in canonical form: the same
+    // letter again, or a move about the same axis that goes before prev
+    // ("R" after "R'", "U" after "D", "U" after "y")
+    bool follows_out_of_order(int prev, int next) const {
+        const Move& p = moves_[prev];
+        const Move& n = moves_[next];
+        if (p.axis == -1 || n.axis == -1) return false;
+        return p.letter == n.letter || (p.axis == n.axis && p.order > n.order);
+    }
+
+    // Canonical form: reduce(prefix + alg, true)
+    std::vector<int> canonical(const std::vector<int>& prefix, const std::vector<int>& alg) const {
+        std::vector<int> result;
+        result.reserve(prefix.size() + alg.size());
+        for (int move : prefix) {
+            push(result, move, true);
+        }
+        for (int move : alg) {
+            push(result, move, true);
+        }
+        return result;
+    }
+
+    const std::vector<std::string>& names() const { return names_; }
+
+private:
+    struct Move {
+        int axis;
+        int amount;  // quarter turns: 1, 2 or 3
+        int letter;
+        int order;   // position of the letter in its axis
+    };
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // 1, 2, 3 for "", "2", "'"; 0 for other suffixes
+    static int suffix_amount(const char* suffix, size_t length) {
+        if (length == 0) return 1;
+        if (length != 1) return 0;
+        if (suffix[0] == '2') return 2;
+        if (suffix[0] == '\'') return 3;
+        return 0;
+    }
+
+    std::vector<std::string> names_;
+    std::vector<Move> moves_;
+    int ids_[128][3];
+    int axis_[128];
+    int order_[128];
+};
+
+inline bool& canonical_mode() {
+    static bool enabled = false;
+    return enabled;
+}
+
+// Bound by the solver modules
+inline void set_canonical_mode(bool enabled) {
+    canonical_mode() = enabled;
+}
+
+// Canonical forms of the solutions a search has posted. The move ids
+// themselves are kept, not a hash, so two distinct solutions never collide.
+class SolutionSet {
+public:
+    void clear() { solutions_.clear(); }
+
+    // False if prefix + alg is a solution posted before in canonical mode;
+    // always true otherwise
+    bool insert(const MoveCodec& codec, const std::vector<int>& prefix, const std::vector<int>& alg) {
+        if (!canonical_mode()) return true;
+        return solutions_.insert(codec.canonical(prefix, alg)).second;
+    }
+
+private:
+    std::set<std::vector<int>> solutions_;
+};
+
+// alg[i] = map[alg[i]], e.g. map = rotationMap[r]
+inline void conjugate_moves(std::vector<int>& alg, const std::vector<int>& map) {
+    for (int& move : alg) {
+        move = map[move];
+    }
+}
+
+#endif // MOVE_SEQUENCE_H
@@ -9,6 +9,12 @@
 #include <cstdlib>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
+#include "../corpus_stats.h"
+#include "../twophase/two_phase.h"
 
 int analyzer_count = 0;
 
@@ -94,34 +100,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -631,6 +619,31 @@ std::vector<bool> create_ma_table()
 	return ma;
 }
 
+// Corpus mode (analyze_corpus / analyze_random / analyze_random_moves, see
+// ../corpus_stats.h):
+// while corpus is set, rows are aggregated there instead of being posted.
+corpus_stats *corpus = nullptr;
+
+void post(const char *str)
+{
+	if (!corpus)
+	{
+		update(str);
+	}
+}
+
+void emit_row(const std::string &slot, const std::string &result, const std::vector<double> &lengths)
+{
+	if (corpus)
+	{
+		corpus->record(slot, lengths);
+	}
+	else
+	{
+		update((result + "</tr>").c_str());
+	}
+}
+
 struct xcross_analyzer2
 {
 	std::vector<int> sol;
@@ -643,17 +656,18 @@ struct xcross_analyzer2
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
-	std::vector<unsigned char> prune_table1;
-	std::vector<unsigned char> prune_table2;
-	std::vector<unsigned char> prune_table3;
-	std::vector<unsigned char> prune_table4;
-	std::vector<unsigned char> prune_table1_x;
-	std::vector<unsigned char> prune_table2_x;
-	std::vector<unsigned char> prune_table3_x;
-	std::vector<unsigned char> prune_table4_x;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
+	// Per-slot prune tables, built on first use: [0-3] create_prune_table2,
+	// [4-7] create_prune_table3. When capacity_bytes is set (0 = no limit) the
+	// least recently used tables are freed to make room; tables used by the
+	// row being analyzed are never evicted.
+	std::vector<std::vector<unsigned char>> slot_tables;
+	std::vector<unsigned long long> slot_table_use;
+	unsigned long long use_clock;
+	unsigned long long row_start;
+	size_t capacity_bytes;
 	std::vector<unsigned char> edge_corner_prune_table1;
 	std::vector<unsigned char> edge_corner_prune_table2;
 	std::vector<unsigned char> edge_corner_prune_table3;
@@ -702,43 +716,119 @@ struct xcross_analyzer2
 	std::vector<int> sol_len;
 	int current_max_depth;
 
-	xcross_analyzer2()
+	xcross_analyzer2(int capacity_mb = 0)
 	{
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("analyzer/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table2/4", [&]()
+		{
+			return create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		});
 		ma = create_ma_table();
-		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> corner_index = {12, 15, 18, 21};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
-		prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table3 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table4 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table1_x = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table2_x = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table3_x = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
-		prune_table4_x = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
+		slot_tables.resize(8);
+		slot_table_use.assign(8, 0);
+		use_clock = 0;
+		row_start = 1;
+		capacity_bytes = 0;
+		set_capacity_mb(capacity_mb);
 		edge_corner_prune_table1 = std::vector<unsigned char>(24 * 24, 255);
 		edge_corner_prune_table2 = std::vector<unsigned char>(24 * 24, 255);
 		edge_corner_prune_table3 = std::vector<unsigned char>(24 * 24, 255);
 		edge_corner_prune_table4 = std::vector<unsigned char>(24 * 24, 255);
-		create_prune_table2(edge_index[0], corner_index[0], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table1);
-		create_prune_table2(edge_index[1], corner_index[1], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table2);
-		create_prune_table2(edge_index[2], corner_index[2], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table3);
-		create_prune_table2(edge_index[3], corner_index[3], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table4);
-		create_prune_table3(edge_index[0], corner_index[0], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table1_x);
-		create_prune_table3(edge_index[1], corner_index[1], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table2_x);
-		create_prune_table3(edge_index[2], corner_index[2], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table3_x);
-		create_prune_table3(edge_index[3], corner_index[3], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, prune_table4_x);
 		create_prune_table_edge_corner(single_edge_index[0], corner_index[0], 24, 24, 8, edge_move_table, corner_move_table, edge_corner_prune_table1);
 		create_prune_table_edge_corner(single_edge_index[1], corner_index[1], 24, 24, 8, edge_move_table, corner_move_table, edge_corner_prune_table2);
 		create_prune_table_edge_corner(single_edge_index[2], corner_index[2], 24, 24, 8, edge_move_table, corner_move_table, edge_corner_prune_table3);
 		create_prune_table_edge_corner(single_edge_index[3], corner_index[3], 24, 24, 8, edge_move_table, corner_move_table, edge_corner_prune_table4);
 	}
 
+	static const size_t SLOT_TABLE_SIZE = 24 * 22 * 20 * 18 * 24;
+
+	std::vector<unsigned char> &slot_table(int id)
+	{
+		slot_table_use[id] = ++use_clock;
+		if (slot_tables[id].empty())
+		{
+			std::vector<int> corner_index = {12, 15, 18, 21};
+			evict(SLOT_TABLE_SIZE);
+			slot_tables[id] = std::vector<unsigned char>(SLOT_TABLE_SIZE, 255);
+			if (id < 4)
+			{
+				create_prune_table2(187520, corner_index[id], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, slot_tables[id]);
+			}
+			else
+			{
+				create_prune_table3(187520, corner_index[id - 4], 24 * 22 * 20 * 18, 24, 10, multi_move_table, corner_move_table, slot_tables[id]);
+			}
+		}
+		return slot_tables[id];
+	}
+
+	std::vector<unsigned char> &xcross_table(int slot)
+	{
+		return slot_table(slot);
+	}
+
+	std::vector<unsigned char> &pair_table(int slot)
+	{
+		return slot_table(4 + slot);
+	}
+
+	size_t table_bytes() const
+	{
+		size_t total = 0;
+		for (const auto &t : slot_tables)
+		{
+			total += t.size();
+		}
+		return total;
+	}
+
+	// Free least recently used tables outside the current row until
+	// `incoming` more bytes fit under the capacity
+	void evict(size_t incoming)
+	{
+		if (capacity_bytes == 0)
+		{
+			return;
+		}
+		while (table_bytes() + incoming > capacity_bytes)
+		{
+			int victim = -1;
+			for (int i = 0; i < static_cast<int>(slot_tables.size()); ++i)
+			{
+				if (!slot_tables[i].empty() && slot_table_use[i] < row_start && (victim == -1 || slot_table_use[i] < slot_table_use[victim]))
+				{
+					victim = i;
+				}
+			}
+			if (victim == -1)
+			{
+				break;
+			}
+			std::vector<unsigned char>().swap(slot_tables[victim]);
+		}
+	}
+
+	// Tables acquired so far stop being pinned
+	void end_row()
+	{
+		row_start = use_clock + 1;
+	}
+
+	void set_capacity_mb(int capacity_mb)
+	{
+		capacity_bytes = capacity_mb > 0 ? static_cast<size_t>(capacity_mb) << 20 : 0;
+		evict(0);
+	}
+
 	bool depth_limited_search_1(int arg_index1, int arg_index2, int arg_index3, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &edge_prune1)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -782,7 +872,7 @@ struct xcross_analyzer2
 							index1_tmp2 = multi_move_table[index1_tmp2 + j];
 							index2_tmp2 = corner_move_table[index2_tmp2 + j];
 							index3_tmp2 = edge_move_table[index3_tmp2 + j];
-							if (c < l && (prune_table1[index1_tmp2 + index2_tmp2] == 0 && edge_corner_prune_table1[index3_tmp2 * 24 + index2_tmp2] == 0))
+							if (c < l && (prune1[index1_tmp2 + index2_tmp2] == 0 && edge_prune1[index3_tmp2 * 24 + index2_tmp2] == 0))
 							{
 								valid = false;
 								break;
@@ -838,6 +928,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">None</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = std::string("None / ") + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -868,6 +960,7 @@ struct xcross_analyzer2
 			edge_prune1_tmp = edge_prune1[index3 * 24 + index2];
 			if (prune1_tmp == 0 && edge_prune1_tmp == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -883,6 +976,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -895,19 +993,24 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+		end_row();
 	}
 
 	void xcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
 	{
-		start_search_1(scramble, 0, prune_table1_x, edge_corner_prune_table1, "", "BL", arg_sol_num, rotations);
-		start_search_1(scramble, 1, prune_table2_x, edge_corner_prune_table2, "", "BR", arg_sol_num, rotations);
-		start_search_1(scramble, 2, prune_table3_x, edge_corner_prune_table3, "", "FR", arg_sol_num, rotations);
-		start_search_1(scramble, 3, prune_table4_x, edge_corner_prune_table4, "", "FL", arg_sol_num, rotations);
+		start_search_1(scramble, 0, pair_table(0), edge_corner_prune_table1, "", "BL", arg_sol_num, rotations);
+		start_search_1(scramble, 1, pair_table(1), edge_corner_prune_table2, "", "BR", arg_sol_num, rotations);
+		start_search_1(scramble, 2, pair_table(2), edge_corner_prune_table3, "", "FR", arg_sol_num, rotations);
+		start_search_1(scramble, 3, pair_table(3), edge_corner_prune_table4, "", "FL", arg_sol_num, rotations);
 	}
 
 	bool depth_limited_search_2(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &edge_prune)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -962,7 +1065,7 @@ struct xcross_analyzer2
 							index4_tmp2 = corner_move_table[index4_tmp2 + j];
 							index5_tmp2 = edge_move_table[index5_tmp2 + j];
 							index6_tmp2 = edge_move_table[index6_tmp2 + j];
-							if (c < l && (prune_table1[index1_tmp2 + index2_tmp2] == 0 && prune_table2[index1_tmp2 + index4_tmp2] == 0 && edge_corner_prune_table1[index5_tmp2 * 24 + index2_tmp2] == 0 && index6_tmp2 == edge_solved2))
+							if (c < l && (prune1[index1_tmp2 + index2_tmp2] == 0 && prune2[index1_tmp2 + index4_tmp2] == 0 && edge_prune[index5_tmp2 * 24 + index2_tmp2] == 0 && index6_tmp2 == edge_solved2))
 							{
 								valid = false;
 								break;
@@ -1005,6 +1108,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1041,6 +1146,7 @@ struct xcross_analyzer2
 			edge_prune1_tmp = edge_prune[index5 * 24 + index2];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && edge_prune1_tmp == 0 && index6 == edge_solved2)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1058,6 +1164,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1070,30 +1181,35 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+		end_row();
 	}
 
 	void xxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
 	{
-		start_search_2(scramble, 1, 0, prune_table2_x, prune_table1, edge_corner_prune_table2, "BL", "BR", arg_sol_num, rotations);
-		start_search_2(scramble, 2, 0, prune_table3_x, prune_table1, edge_corner_prune_table3, "BL", "FR", arg_sol_num, rotations);
-		start_search_2(scramble, 3, 0, prune_table4_x, prune_table1, edge_corner_prune_table4, "BL", "FL", arg_sol_num, rotations);
+		start_search_2(scramble, 1, 0, pair_table(1), xcross_table(0), edge_corner_prune_table2, "BL", "BR", arg_sol_num, rotations);
+		start_search_2(scramble, 2, 0, pair_table(2), xcross_table(0), edge_corner_prune_table3, "BL", "FR", arg_sol_num, rotations);
+		start_search_2(scramble, 3, 0, pair_table(3), xcross_table(0), edge_corner_prune_table4, "BL", "FL", arg_sol_num, rotations);
 
-		start_search_2(scramble, 0, 1, prune_table1_x, prune_table2, edge_corner_prune_table1, "BR", "BL", arg_sol_num, rotations);
-		start_search_2(scramble, 2, 1, prune_table3_x, prune_table2, edge_corner_prune_table3, "BR", "FR", arg_sol_num, rotations);
-		start_search_2(scramble, 3, 1, prune_table4_x, prune_table2, edge_corner_prune_table4, "BR", "FL", arg_sol_num, rotations);
+		start_search_2(scramble, 0, 1, pair_table(0), xcross_table(1), edge_corner_prune_table1, "BR", "BL", arg_sol_num, rotations);
+		start_search_2(scramble, 2, 1, pair_table(2), xcross_table(1), edge_corner_prune_table3, "BR", "FR", arg_sol_num, rotations);
+		start_search_2(scramble, 3, 1, pair_table(3), xcross_table(1), edge_corner_prune_table4, "BR", "FL", arg_sol_num, rotations);
 
-		start_search_2(scramble, 0, 2, prune_table1_x, prune_table3, edge_corner_prune_table1, "FR", "BL", arg_sol_num, rotations);
-		start_search_2(scramble, 1, 2, prune_table2_x, prune_table3, edge_corner_prune_table2, "FR", "BR", arg_sol_num, rotations);
-		start_search_2(scramble, 3, 2, prune_table4_x, prune_table3, edge_corner_prune_table4, "FR", "FL", arg_sol_num, rotations);
+		start_search_2(scramble, 0, 2, pair_table(0), xcross_table(2), edge_corner_prune_table1, "FR", "BL", arg_sol_num, rotations);
+		start_search_2(scramble, 1, 2, pair_table(1), xcross_table(2), edge_corner_prune_table2, "FR", "BR", arg_sol_num, rotations);
+		start_search_2(scramble, 3, 2, pair_table(3), xcross_table(2), edge_corner_prune_table4, "FR", "FL", arg_sol_num, rotations);
 
-		start_search_2(scramble, 0, 3, prune_table1_x, prune_table4, edge_corner_prune_table1, "FL", "BL", arg_sol_num, rotations);
-		start_search_2(scramble, 1, 3, prune_table2_x, prune_table4, edge_corner_prune_table2, "FL", "BR", arg_sol_num, rotations);
-		start_search_2(scramble, 2, 3, prune_table3_x, prune_table4, edge_corner_prune_table3, "FL", "FR", arg_sol_num, rotations);
+		start_search_2(scramble, 0, 3, pair_table(0), xcross_table(3), edge_corner_prune_table1, "FL", "BL", arg_sol_num, rotations);
+		start_search_2(scramble, 1, 3, pair_table(1), xcross_table(3), edge_corner_prune_table2, "FL", "BR", arg_sol_num, rotations);
+		start_search_2(scramble, 2, 3, pair_table(2), xcross_table(3), edge_corner_prune_table3, "FL", "FR", arg_sol_num, rotations);
 	}
 
 	bool depth_limited_search_3(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &prune3, std::vector<unsigned char> &edge_prune)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1159,7 +1275,7 @@ struct xcross_analyzer2
 							index7_tmp2 = edge_move_table[index7_tmp2 + j];
 							index8_tmp2 = edge_move_table[index8_tmp2 + j];
 							index9_tmp2 = edge_move_table[index9_tmp2 + j];
-							if (c < l && (prune_table1[index1_tmp2 + index2_tmp2] == 0 && prune_table2[index1_tmp2 + index4_tmp2] == 0 && prune_table3[index1_tmp2 + index6_tmp2] == 0 && edge_corner_prune_table1[index7_tmp2 * 24 + index2_tmp2] == 0 && index8_tmp2 == edge_solved2 && index9_tmp2 == edge_solved3))
+							if (c < l && (prune1[index1_tmp2 + index2_tmp2] == 0 && prune2[index1_tmp2 + index4_tmp2] == 0 && prune3[index1_tmp2 + index6_tmp2] == 0 && edge_prune[index7_tmp2 * 24 + index2_tmp2] == 0 && index8_tmp2 == edge_solved2 && index9_tmp2 == edge_solved3))
 							{
 								valid = false;
 								break;
@@ -1205,6 +1321,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1247,6 +1365,7 @@ struct xcross_analyzer2
 			edge_prune1_tmp = edge_prune[index7 * 24 + index2];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && edge_prune1_tmp == 0 && index8 == edge_solved2 && index9 == edge_solved3)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1266,6 +1385,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1278,32 +1402,37 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+		end_row();
 	}
 
 	void xxxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
 	{
-		start_search_3(scramble, 2, 0, 1, prune_table3_x, prune_table1, prune_table2, edge_corner_prune_table3, "BL BR", "FR", arg_sol_num, rotations);
-		start_search_3(scramble, 3, 0, 1, prune_table4_x, prune_table1, prune_table2, edge_corner_prune_table4, "BL BR", "FL", arg_sol_num, rotations);
+		start_search_3(scramble, 2, 0, 1, pair_table(2), xcross_table(0), xcross_table(1), edge_corner_prune_table3, "BL BR", "FR", arg_sol_num, rotations);
+		start_search_3(scramble, 3, 0, 1, pair_table(3), xcross_table(0), xcross_table(1), edge_corner_prune_table4, "BL BR", "FL", arg_sol_num, rotations);
 
-		start_search_3(scramble, 1, 0, 2, prune_table2_x, prune_table1, prune_table3, edge_corner_prune_table2, "BL FR", "BR", arg_sol_num, rotations);
-		start_search_3(scramble, 3, 0, 2, prune_table4_x, prune_table1, prune_table3, edge_corner_prune_table4, "BL FR", "FL", arg_sol_num, rotations);
+		start_search_3(scramble, 1, 0, 2, pair_table(1), xcross_table(0), xcross_table(2), edge_corner_prune_table2, "BL FR", "BR", arg_sol_num, rotations);
+		start_search_3(scramble, 3, 0, 2, pair_table(3), xcross_table(0), xcross_table(2), edge_corner_prune_table4, "BL FR", "FL", arg_sol_num, rotations);
 
-		start_search_3(scramble, 1, 0, 3, prune_table2_x, prune_table1, prune_table4, edge_corner_prune_table2, "BL FL", "BR", arg_sol_num, rotations);
-		start_search_3(scramble, 2, 0, 3, prune_table3_x, prune_table1, prune_table4, edge_corner_prune_table3, "BL FL", "FR", arg_sol_num, rotations);
+		start_search_3(scramble, 1, 0, 3, pair_table(1), xcross_table(0), xcross_table(3), edge_corner_prune_table2, "BL FL", "BR", arg_sol_num, rotations);
+		start_search_3(scramble, 2, 0, 3, pair_table(2), xcross_table(0), xcross_table(3), edge_corner_prune_table3, "BL FL", "FR", arg_sol_num, rotations);
 
-		start_search_3(scramble, 0, 1, 2, prune_table1_x, prune_table2, prune_table3, edge_corner_prune_table1, "BR FR", "BL", arg_sol_num, rotations);
-		start_search_3(scramble, 3, 1, 2, prune_table4_x, prune_table2, prune_table3, edge_corner_prune_table4, "BR FR", "FL", arg_sol_num, rotations);
+		start_search_3(scramble, 0, 1, 2, pair_table(0), xcross_table(1), xcross_table(2), edge_corner_prune_table1, "BR FR", "BL", arg_sol_num, rotations);
+		start_search_3(scramble, 3, 1, 2, pair_table(3), xcross_table(1), xcross_table(2), edge_corner_prune_table4, "BR FR", "FL", arg_sol_num, rotations);
 
-		start_search_3(scramble, 0, 1, 3, prune_table1_x, prune_table2, prune_table4, edge_corner_prune_table1, "BR FL", "BL", arg_sol_num, rotations);
-		start_search_3(scramble, 2, 1, 3, prune_table3_x, prune_table2, prune_table4, edge_corner_prune_table3, "BR FL", "FR", arg_sol_num, rotations);
+		start_search_3(scramble, 0, 1, 3, pair_table(0), xcross_table(1), xcross_table(3), edge_corner_prune_table1, "BR FL", "BL", arg_sol_num, rotations);
+		start_search_3(scramble, 2, 1, 3, pair_table(2), xcross_table(1), xcross_table(3), edge_corner_prune_table3, "BR FL", "FR", arg_sol_num, rotations);
 
-		start_search_3(scramble, 0, 2, 3, prune_table1_x, prune_table3, prune_table4, edge_corner_prune_table1, "FR FL", "BL", arg_sol_num, rotations);
-		start_search_3(scramble, 1, 2, 3, prune_table2_x, prune_table3, prune_table4, edge_corner_prune_table2, "FR FL", "BR", arg_sol_num, rotations);
+		start_search_3(scramble, 0, 2, 3, pair_table(0), xcross_table(2), xcross_table(3), edge_corner_prune_table1, "FR FL", "BL", arg_sol_num, rotations);
+		start_search_3(scramble, 1, 2, 3, pair_table(1), xcross_table(2), xcross_table(3), edge_corner_prune_table2, "FR FL", "BR", arg_sol_num, rotations);
 	}
 
 	bool depth_limited_search_4(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index8, int arg_index9, int arg_index10, int arg_index11, int arg_index12, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &prune3, std::vector<unsigned char> &prune4, std::vector<unsigned char> &edge_prune)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1380,7 +1509,7 @@ struct xcross_analyzer2
 							index10_tmp2 = edge_move_table[index10_tmp2 + j];
 							index11_tmp2 = edge_move_table[index11_tmp2 + j];
 							index12_tmp2 = edge_move_table[index12_tmp2 + j];
-							if (c < l && (prune_table1[index1_tmp2 + index2_tmp2] == 0 && prune_table2[index1_tmp2 + index4_tmp2] == 0 && prune_table3[index1_tmp2 + index6_tmp2] == 0 && prune_table4[index1_tmp2 + index8_tmp2] == 0 && edge_corner_prune_table1[index9_tmp2 * 24 + index2_tmp2] == 0 && index10_tmp2 == edge_solved2 && index11_tmp2 == edge_solved3 && index12_tmp2 == edge_solved4))
+							if (c < l && (prune1[index1_tmp2 + index2_tmp2] == 0 && prune2[index1_tmp2 + index4_tmp2] == 0 && prune3[index1_tmp2 + index6_tmp2] == 0 && prune4[index1_tmp2 + index8_tmp2] == 0 && edge_prune[index9_tmp2 * 24 + index2_tmp2] == 0 && index10_tmp2 == edge_solved2 && index11_tmp2 == edge_solved3 && index12_tmp2 == edge_solved4))
 							{
 								valid = false;
 								break;
@@ -1429,6 +1558,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1477,6 +1608,7 @@ struct xcross_analyzer2
 			edge_prune1_tmp = edge_prune[index9 * 24 + index2];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && prune4_tmp == 0 && edge_prune1_tmp == 0 && index10 == edge_solved2 && index11 == edge_solved3 && index12 == edge_solved4)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1498,6 +1630,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1510,20 +1647,50 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
+		end_row();
 	}
 
 	void xxxxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
 	{
-		start_search_4(scramble, 3, 0, 1, 2, prune_table4_x, prune_table1, prune_table2, prune_table3, edge_corner_prune_table4, "BL BR FR", "FL", arg_sol_num, rotations);
-		start_search_4(scramble, 2, 0, 1, 3, prune_table3_x, prune_table1, prune_table2, prune_table4, edge_corner_prune_table3, "BL BR FL", "FR", arg_sol_num, rotations);
-		start_search_4(scramble, 1, 0, 2, 3, prune_table2_x, prune_table1, prune_table3, prune_table4, edge_corner_prune_table2, "BL FR FL", "BR", arg_sol_num, rotations);
-		start_search_4(scramble, 0, 1, 2, 3, prune_table1_x, prune_table2, prune_table3, prune_table4, edge_corner_prune_table1, "BR FR FL", "BL", arg_sol_num, rotations);
+		start_search_4(scramble, 3, 0, 1, 2, pair_table(3), xcross_table(0), xcross_table(1), xcross_table(2), edge_corner_prune_table4, "BL BR FR", "FL", arg_sol_num, rotations);
+		start_search_4(scramble, 2, 0, 1, 3, pair_table(2), xcross_table(0), xcross_table(1), xcross_table(3), edge_corner_prune_table3, "BL BR FL", "FR", arg_sol_num, rotations);
+		start_search_4(scramble, 1, 0, 2, 3, pair_table(1), xcross_table(0), xcross_table(2), xcross_table(3), edge_corner_prune_table2, "BL FR FL", "BR", arg_sol_num, rotations);
+		start_search_4(scramble, 0, 1, 2, 3, pair_table(0), xcross_table(1), xcross_table(2), xcross_table(3), edge_corner_prune_table1, "BR FR FL", "BL", arg_sol_num, rotations);
 	}
 };
 
-void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+// Keeps the move and prune tables between analyze() calls. Slot tables are
+// built when a row first needs them, so later scrambles only pay for the
+// searches (and for slots not requested before).
+struct analyzer_session
+{
+	std::unique_ptr<xcross_analyzer2> xcs;
+	int table_capacity_mb = 0;
+
+	// LRU limit for the per-slot prune tables (0 = keep all)
+	void set_table_capacity_mb(int mb)
+	{
+		table_capacity_mb = mb;
+		if (xcs)
+		{
+			xcs->set_capacity_mb(mb);
+		}
+	}
+
+	void analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+};
+
+void analyzer_session::analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
 {
+	// A corpus run is one request; its budget starts in analyze_corpus
+	if (!corpus)
+	{
+		SearchBudget::instance().begin();
+	}
 	std::vector<std::string> rotations;
 	std::string table = "<br><table border=\"2\" id=\"pair_analyzer_result\" translate=\"no\"><thead><tr><th class=\"sort\" data-sort=\"No\">No</th><th class=\"sort\" data-sort=\"slot\">slot</th><th class=\"sort\" data-sort=\"pslot\">Aslot</th>";
 	for (char c_tmp : rot_set)
@@ -1561,7 +1728,11 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 		}
 	}
 	table += "</tr></thead><tbody class=\"list\"></tbody></table>";
-	update(table.c_str());
+	if (corpus)
+	{
+		corpus->set_rotations(rotations);
+	}
+	post(table.c_str());
 	int sol_num = std::stoi(num);
 	int count = 0;
 	if (cross)
@@ -1580,28 +1751,77 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	{
 		count += 4;
 	}
-	update((std::to_string(count)).c_str());
-	xcross_analyzer2 xcs;
+	post((std::to_string(count)).c_str());
+	if (!xcs)
+	{
+		xcs.reset(new xcross_analyzer2(table_capacity_mb));
+	}
 	if (cross)
 	{
-		xcs.xcross_analyze(scramble, sol_num, rotations);
+		xcs->xcross_analyze(scramble, sol_num, rotations);
 	}
 	if (x)
 	{
-		xcs.xxcross_analyze(scramble, sol_num, rotations);
+		xcs->xxcross_analyze(scramble, sol_num, rotations);
 	}
 	if (xx)
 	{
-		xcs.xxxcross_analyze(scramble, sol_num, rotations);
+		xcs->xxxcross_analyze(scramble, sol_num, rotations);
 	}
 	if (xxx)
 	{
-		xcs.xxxxcross_analyze(scramble, sol_num, rotations);
+		xcs->xxxxcross_analyze(scramble, sol_num, rotations);
+	}
+	if (SearchBudget::instance().stopped())
+	{
+		post(SearchBudget::instance().stop_message());
 	}
-	update("Finished.");
+	post("Finished.");
+}
+
+// Batch mode: one scramble per line. Nothing is posted; the aggregated
+// per-slot / per-orientation statistics are returned as JSON.
+std::string analyzer_session::analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	int saved_count = analyzer_count;
+	std::string json = run_corpus(scrambles, std::stoi(num), corpus, [&](const std::string &scramble)
+	{
+		analyze(scramble, cross, x, xx, xxx, num, rot_set);
+	});
+	analyzer_count = saved_count;
+	return json;
+}
+
+// Batch mode over count random-state scrambles from seed, solved two-phase
+// (see twophase::random_state_scrambles): a uniform sample of cube states.
+std::string analyzer_session::analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(twophase::random_state_scrambles(seed, count), cross, x, xx, xxx, num, rot_set);
+}
+
+// Extra batch mode over count random-move scrambles (25 moves) from seed,
+// e.g. to compare with results from other tools. Their states are only
+// approximately uniform; see random_move_scrambles.
+std::string analyzer_session::analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(random_move_scrambles(seed, count, 25), cross, x, xx, xxx, num, rot_set);
+}
+
+void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	analyzer_session session;
+	session.analyze(scramble, cross, x, xx, xxx, num, rot_set);
 }
 
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("analyze", &analyzer);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::class_<analyzer_session>("Analyzer")
+		.constructor<>()
+		.function("analyze", &analyzer_session::analyze)
+		.function("analyze_corpus", &analyzer_session::analyze_corpus)
+		.function("analyze_random", &analyzer_session::analyze_random)
+		.function("analyze_random_moves", &analyzer_session::analyze_random_moves)
+		.function("set_table_capacity_mb", &analyzer_session::set_table_capacity_mb);
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <sstream>
 #include <cstdlib>
 #include <random>
+#include "../depth_sampler.h"
+#include "../appl_seeds.h"
+#include "../move_sequence.h"
 
 struct State
 {
@@ -87,34 +90,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -316,23 +301,20 @@ std::vector<int> create_multi_move_table2(int n, int c, int pn, int size, const
 	return move_table;
 }
 
-void create_prune_table2(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table, std::vector<std::vector<int>> &index_list, std::unordered_map<int, std::string> &appl_sols)
+void create_prune_table2(int index1, int index2, int size1, int size2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<unsigned char> &prune_table, ApplSeeds &appl_sols)
 {
 	int size = size1 * size2;
-	index_list = std::vector<std::vector<int>>(9);
 	prune_table = std::vector<unsigned char>(size, 255);
-	std::vector<int> num_list = {255, 3102, 35217, 367070, 3184390, 18621816, 41028188, 9746797, 3868};
 	int start = index1 * size2 + index2;
 	int next_i;
 	int index1_tmp;
 	int index2_tmp;
 	int next_d;
 	prune_table[start] = 0;
-	appl_sols[start] = " ";
+	appl_sols.add(start, 0);
 	int tmp_index;
-	std::vector<std::string> auf = {" U", " U2", " U'"};
-	std::vector<std::string> appl_moves = {"L U L'", "L U' L'", "B' U B", "B' U' B"};
-	for (int i = 0; i < 4; i++)
+	const std::vector<std::string> &appl_moves = appl_sols.algs();
+	for (int i = 1; i < static_cast<int>(appl_moves.size()); i++)
 	{
 		int index1_tmp_2 = index1 * 24;
 		int index2_tmp_2 = index2;
@@ -343,22 +325,19 @@ void create_prune_table2(int index1, int index2, int size1, int size2, int depth
 		}
 		tmp_index = index1_tmp_2 + index2_tmp_2;
 		prune_table[tmp_index] = 0;
-		appl_sols[tmp_index] = appl_moves[i];
+		appl_sols.add(tmp_index, i);
 		for (int j = 0; j < 3; j++)
 		{
 			tmp_index = table1[index1_tmp_2 + j] + table2[index2_tmp_2 * 18 + j];
 			prune_table[tmp_index] = 0;
-			appl_sols[tmp_index] = appl_moves[i] + auf[j];
+			appl_sols.add(tmp_index, i, j + 1);
 		}
 	}
+	appl_sols.finalize();
 	index1_tmp = index1 * 24;
 	index2_tmp = index2 * 18;
-	int num = 17;
-	index_list[0].reserve(num_list[0]);
 	for (int d = 0; d < depth; ++d)
 	{
-		num = 0;
-		index_list[d].reserve(num_list[d]);
 		next_d = d + 1;
 		for (int i = 0; i < size; ++i)
 		{
@@ -372,8 +351,6 @@ void create_prune_table2(int index1, int index2, int size1, int size2, int depth
 					if (prune_table[next_i] == 255)
 					{
 						prune_table[next_i] = next_d;
-						index_list[d][num] = next_i;
-						num += 1;
 					}
 				}
 			}
@@ -411,7 +388,7 @@ struct xcross_search
 	std::vector<int> corner_move_table;
 	std::vector<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
-	std::vector<std::vector<int>> index_list;
+	DepthSampler depth_sampler;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -423,8 +400,7 @@ struct xcross_search
 	int prune1_tmp;
 	std::string tmp;
 	std::mt19937 generator;
-	std::vector<int> num_list;
-	std::unordered_map<int, std::string> appl_sols;
+	ApplSeeds appl_sols;
 	int current_max_depth;
 
 	xcross_search()
@@ -432,14 +408,55 @@ struct xcross_search
 		edge_move_table = create_edge_move_table();
 		corner_move_table = create_corner_move_table();
 		multi_move_table = create_multi_move_table2(5, 2, 12, 24 * 22 * 20 * 18 * 16, edge_move_table);
-		create_prune_table2(2989056, 12, 24 * 22 * 20 * 18 * 16, 24, 9, multi_move_table, corner_move_table, prune_table1, index_list, appl_sols);
+		appl_sols.set_algs({"L U L'", "L U' L'", "B' U B", "B' U' B"});
+		build_prune_table();
 		ma = create_ma_table();
 		std::random_device rd;
 		generator.seed(rd());
-		num_list = {255, 3102, 35217, 367070, 3184390, 18621816, 41028188, 9746797, 3868};
 		move_restrict = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
 	}
 
+	void build_prune_table()
+	{
+		std::vector<unsigned char>().swap(prune_table1);
+		create_prune_table2(2989056, 12, 24 * 22 * 20 * 18 * 16, 24, 9, multi_move_table, corner_move_table, prune_table1, appl_sols);
+		depth_sampler.build(prune_table1, 9);
+	}
+
+	// Adds last-insert algorithms (comma separated, e.g. "L U2 L',B' U2 B") to
+	// the seeds and rebuilds the prune table; returns the number of seeds, or
+	// -1 if algorithms past ApplSeeds::MAX_ALGS were refused (the others are
+	// still added)
+	int add_appl_algs(std::string algs)
+	{
+		std::istringstream iss(algs);
+		std::string alg;
+		bool added = false;
+		bool refused = false;
+		while (std::getline(iss, alg, ','))
+		{
+			std::vector<int> alg_moves = StringToAlg(alg);
+			if (alg_moves.empty())
+			{
+				continue;
+			}
+			alg = AlgToString(alg_moves);
+			alg.pop_back();
+			size_t count_before = appl_sols.algs().size();
+			if (appl_sols.add_alg(alg) == -1)
+			{
+				refused = true;
+				continue;
+			}
+			added = added || appl_sols.algs().size() > count_before;
+		}
+		if (added)
+		{
+			build_prune_table();
+		}
+		return refused ? -1 : static_cast<int>(appl_sols.size());
+	}
+
 	bool depth_limited_search(int arg_index1, int arg_index2, int depth, int prev)
 	{
 		for (int i : move_restrict)
@@ -487,8 +504,11 @@ struct xcross_search
 	{
 		sol.clear();
 		int len = std::stoi(arg_length);
-		std::uniform_int_distribution<> distribution(0, num_list[len - 1] - 1);
-		int cross_index = index_list[len - 1][distribution(generator)];
+		if (len < 1 || depth_sampler.count(len) == 0)
+		{
+			return "";
+		}
+		int cross_index = static_cast<int>(depth_sampler.sample(prune_table1, len, generator));
 		index1 = cross_index / 24;
 		index2 = cross_index % 24;
 		index1 *= 24;
@@ -512,7 +532,7 @@ struct xcross_search
 			index1 = multi_move_table[index1 + m];
 			index2 = corner_move_table[index2 * 18 + m];
 		}
-		return tmp + "," + appl_sols[index1 + index2];
+		return tmp + "," + appl_sols.text(index1 + index2);
 	}
 
 	std::string start_search(std::string arg_scramble = "")
@@ -550,7 +570,13 @@ struct xcross_search
 			index1 = multi_move_table[index1 + m];
 			index2 = corner_move_table[index2 * 18 + m];
 		}
-		return tmp + "," + appl_sols[index1 + index2];
+		return tmp + "," + appl_sols.text(index1 + index2);
+	}
+
+	// Number of states at depth (0 past the sampled depths)
+	int get_depth_count(int depth)
+	{
+		return static_cast<int>(depth_sampler.count(depth));
 	}
 
 	std::string func(std::string arg_scramble = "", std::string arg_length = "8")
@@ -564,5 +590,7 @@ EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::class_<xcross_search>("xcross_search")
 		.constructor<>()
-		.function("func", &xcross_search::func);
+		.function("func", &xcross_search::func)
+		.function("depth_count", &xcross_search::get_depth_count)
+		.function("add_appl_algs", &xcross_search::add_appl_algs);
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+// ApplSeeds test (native build):
+//   g++ -std=c++17 -O2 -Wall test_appl_seeds_native.cpp -o test_appl_seeds_native && ./test_appl_seeds_native
+// Exits with 1 on the first failed check.
+
+#include "../appl_seeds.h"
+
+#include <iostream>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+int main()
+{
+	ApplSeeds seeds;
+	seeds.set_algs({"L U L'", "L U' L'", "B' U B", "B' U' B"});
+
+	// More than 255 algorithms: ids past the old 8-bit range must keep their text
+	std::vector<int> ids;
+	for (int i = 0; i < 600; ++i)
+	{
+		ids.push_back(seeds.add_alg("R U" + std::to_string(i) + " R'"));
+	}
+	check(ids[0] == 5 && ids[599] == 604, "ids follow the default algorithms");
+	check(seeds.add_alg("R U300 R'") == ids[300], "an existing algorithm keeps its id");
+
+	seeds.add(0, 0);
+	for (int i = 0; i < 600; ++i)
+	{
+		seeds.add(1000 + i, ids[i], i % 4, (i / 4) % 4);
+	}
+	seeds.finalize();
+	static const char *const kAuf[] = {"", " U", " U2", " U'"};
+	static const char *const kAdf[] = {"", " D", " D2", " D'"};
+	for (int i = 0; i < 600; ++i)
+	{
+		std::string expected = "R U" + std::to_string(i) + " R'" + kAuf[i % 4] + kAdf[(i / 4) % 4];
+		check(seeds.text(1000 + i) == expected, "text of seed " + std::to_string(1000 + i) + ": " + seeds.text(1000 + i));
+	}
+	check(seeds.text(0) == " ", "solved state");
+	check(seeds.text(5) == "", "index without a seed");
+
+	// The last seed added for an index wins
+	seeds.add(7, 1, 1);
+	seeds.add(7, ids[400], 2);
+	seeds.finalize();
+	check(seeds.text(7) == "R U400 R' U2", "last seed for an index wins");
+	check(seeds.size() == 602, "one seed per index");
+
+	// Ids are 16-bit: new algorithms past MAX_ALGS are refused
+	ApplSeeds full;
+	full.set_algs({});
+	for (int i = 1; i < ApplSeeds::MAX_ALGS; ++i)
+	{
+		full.add_alg(std::to_string(i));
+	}
+	check(static_cast<int>(full.algs().size()) == ApplSeeds::MAX_ALGS, "MAX_ALGS algorithms fit");
+	check(full.add_alg("one too many") == -1, "algorithm past MAX_ALGS is refused");
+	check(full.add_alg("65535") == ApplSeeds::MAX_ALGS - 1, "existing algorithm still found when full");
+	full.add(3, ApplSeeds::MAX_ALGS - 1);
+	full.finalize();
+	check(full.text(3) == "65535", "text of the highest id");
+
+	if (failures > 0)
+	{
+		return 1;
+	}
+	std::cout << "ApplSeeds: all checks passed" << std::endl;
+	return 0;
+}
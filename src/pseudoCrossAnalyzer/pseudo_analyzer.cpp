@@ -9,6 +9,12 @@
 #include <cstdlib>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
+#include "../corpus_stats.h"
+#include "../twophase/two_phase.h"
 
 int analyzer_count = 0;
 
@@ -94,34 +100,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -552,6 +540,31 @@ std::vector<bool> create_ma_table()
 	return ma;
 }
 
+// Corpus mode (analyze_corpus / analyze_random / analyze_random_moves, see
+// ../corpus_stats.h):
+// while corpus is set, rows are aggregated there instead of being posted.
+corpus_stats *corpus = nullptr;
+
+void post(const char *str)
+{
+	if (!corpus)
+	{
+		update(str);
+	}
+}
+
+void emit_row(const std::string &slot, const std::string &result, const std::vector<double> &lengths)
+{
+	if (corpus)
+	{
+		corpus->record(slot, lengths);
+	}
+	else
+	{
+		update((result + "</tr>").c_str());
+	}
+}
+
 struct cross_analyzer
 {
 	std::vector<int> sol;
@@ -560,8 +573,8 @@ struct cross_analyzer
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
@@ -578,8 +591,11 @@ struct cross_analyzer
 
 	cross_analyzer()
 	{
-		edge_move_table = create_edge_move_table();
-		multi_move_table = create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table/2", [&]()
+		{
+			return create_multi_move_table(2, 2, 12, 24 * 22, edge_move_table);
+		});
 		index1 = 416;
 		index2 = 520;
 		prune_table = create_prune_table_cross(8, multi_move_table, multi_move_table);
@@ -588,6 +604,10 @@ struct cross_analyzer
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int depth, int prev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -677,6 +697,8 @@ struct cross_analyzer
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">None</th><th class=\"pslot\">None</th>";
+		std::string label = "None / None";
+		std::vector<double> lengths;
 		move_restrict.clear();
 		for (std::string name : restrict)
 		{
@@ -701,6 +723,7 @@ struct cross_analyzer
 			prune_tmp = prune_table[index1 * 528 + index2];
 			if (prune_tmp == 0)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -716,6 +739,11 @@ struct cross_analyzer
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -728,7 +756,7 @@ struct cross_analyzer
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 };
 
@@ -746,9 +774,9 @@ struct xcross_analyzer2
 	int max_length;
 	int sol_num;
 	int count;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> prune_table2;
 	std::vector<unsigned char> prune_table3;
@@ -787,9 +815,12 @@ struct xcross_analyzer2
 
 	xcross_analyzer2()
 	{
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		edge_move_table = shared_table<int>("analyzer/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("analyzer/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("analyzer/multi_move_table2/4", [&]()
+		{
+			return create_multi_move_table2(4, 2, 12, 24 * 22 * 20 * 18, edge_move_table);
+		});
 		ma = create_ma_table();
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -805,6 +836,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_1(int arg_index1, int arg_index2, int arg_index3, int depth, int prev, std::vector<unsigned char> &prune1)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -900,6 +935,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -929,6 +966,7 @@ struct xcross_analyzer2
 			prune1_tmp = prune1[index1 + index2];
 			if (prune1_tmp == 0 && index3 == edge_solved1)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -944,6 +982,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -956,7 +999,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -985,6 +1028,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_2(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1079,6 +1126,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1114,6 +1163,7 @@ struct xcross_analyzer2
 			prune2_tmp = prune2[index1 + index4];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && index5 == edge_solved1 && index6 == edge_solved2)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1131,6 +1181,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1143,7 +1198,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1194,6 +1249,10 @@ struct xcross_analyzer2
 
 	bool depth_limited_search_3(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int depth, int prev, std::vector<unsigned char> &prune1, std::vector<unsigned char> &prune2, std::vector<unsigned char> &prune3)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict)
 		{
 			if (ma[prev + i])
@@ -1303,6 +1362,8 @@ struct xcross_analyzer2
 		analyzer_count++;
 		std::string count_string = std::to_string(analyzer_count);
 		std::string result = "<tr><th class=\"No\">" + count_string + "</th><th class=\"slot\">" + name + "</th><th class=\"pslot\">" + name2 + "</th>";
+		std::string label = name + " / " + name2;
+		std::vector<double> lengths;
 		std::vector<int> edge_index = {187520, 187520, 187520, 187520};
 		std::vector<int> single_edge_index = {0, 2, 4, 6};
 		std::vector<int> corner_index = {12, 15, 18, 21};
@@ -1344,6 +1405,7 @@ struct xcross_analyzer2
 			prune3_tmp = prune3[index1 + index6];
 			if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && index7 == edge_solved1 && index8 == edge_solved2 && index9 == edge_solved3)
 			{
+				lengths.emplace_back(0);
 				result += "<td class=" + converter_face(rot) + ">0</td>";
 			}
 			else
@@ -1363,6 +1425,11 @@ struct xcross_analyzer2
 						break;
 					}
 				}
+				if (SearchBudget::instance().stopped())
+				{
+					return;
+				}
+				lengths.emplace_back(arg_sol_num > 1 ? double(total_length) / sol_num : sol_len[0]);
 				std::ostringstream oss;
 				if (arg_sol_num > 1)
 				{
@@ -1375,7 +1442,7 @@ struct xcross_analyzer2
 				result += oss.str();
 			}
 		}
-		update((result + "</tr>").c_str());
+		emit_row(label, result, lengths);
 	}
 
 	void xxxcross_analyze(std::string scramble, int arg_sol_num, std::vector<std::string> rotations)
@@ -1403,8 +1470,27 @@ struct xcross_analyzer2
 	}
 };
 
-void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+// Keeps the move and prune tables between analyze() calls. Each analyzer is
+// built by the first call that requests its rows (cross / x, xx, xxx), so
+// later scrambles only pay for the searches.
+struct analyzer_session
 {
+	std::unique_ptr<cross_analyzer> cs;
+	std::unique_ptr<xcross_analyzer2> xcs;
+
+	void analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+	std::string analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set);
+};
+
+void analyzer_session::analyze(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	// A corpus run is one request; its budget starts in analyze_corpus
+	if (!corpus)
+	{
+		SearchBudget::instance().begin();
+	}
 	std::vector<std::string> rotations;
 	std::string table = "<br><table border=\"2\" id=\"panalyzer_result\" translate=\"no\"><thead><tr><th class=\"sort\" data-sort=\"No\">No</th><th class=\"sort\" data-sort=\"slot\">PSE</th><th class=\"sort\" data-sort=\"pslot\">PSC</th>";
 	for (char c_tmp : rot_set)
@@ -1443,7 +1529,11 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	}
 	table += "</tr></thead><tbody class=\"list\"></tbody></table>";
 
-	update(table.c_str());
+	if (corpus)
+	{
+		corpus->set_rotations(rotations);
+	}
+	post(table.c_str());
 	int sol_num = std::stoi(num);
 	int count = 0;
 	if (cross)
@@ -1462,32 +1552,83 @@ void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::
 	{
 		count += 16;
 	}
-	update((std::to_string(count)).c_str());
+	post((std::to_string(count)).c_str());
 	if (cross)
 	{
-		cross_analyzer cs;
-		cs.start_search(scramble, "", "", sol_num, rotations);
+		if (!cs)
+		{
+			cs.reset(new cross_analyzer());
+		}
+		cs->start_search(scramble, "", "", sol_num, rotations);
 	}
 	if (x || xx || xxx)
 	{
-		xcross_analyzer2 xcs;
+		if (!xcs)
+		{
+			xcs.reset(new xcross_analyzer2());
+		}
 		if (x)
 		{
-			xcs.xcross_analyze(scramble, sol_num, rotations);
+			xcs->xcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xx)
 		{
-			xcs.xxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxcross_analyze(scramble, sol_num, rotations);
 		}
 		if (xxx)
 		{
-			xcs.xxxcross_analyze(scramble, sol_num, rotations);
+			xcs->xxxcross_analyze(scramble, sol_num, rotations);
 		}
 	}
-	update("Finished.");
+	if (SearchBudget::instance().stopped())
+	{
+		post(SearchBudget::instance().stop_message());
+	}
+	post("Finished.");
+}
+
+// Batch mode: one scramble per line. Nothing is posted; the aggregated
+// per-slot / per-orientation statistics are returned as JSON.
+std::string analyzer_session::analyze_corpus(std::string scrambles, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	int saved_count = analyzer_count;
+	std::string json = run_corpus(scrambles, std::stoi(num), corpus, [&](const std::string &scramble)
+	{
+		analyze(scramble, cross, x, xx, xxx, num, rot_set);
+	});
+	analyzer_count = saved_count;
+	return json;
+}
+
+// Batch mode over count random-state scrambles from seed, solved two-phase
+// (see twophase::random_state_scrambles): a uniform sample of cube states.
+std::string analyzer_session::analyze_random(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(twophase::random_state_scrambles(seed, count), cross, x, xx, xxx, num, rot_set);
+}
+
+// Extra batch mode over count random-move scrambles (25 moves) from seed,
+// e.g. to compare with results from other tools. Their states are only
+// approximately uniform; see random_move_scrambles.
+std::string analyzer_session::analyze_random_moves(int seed, int count, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	return analyze_corpus(random_move_scrambles(seed, count, 25), cross, x, xx, xxx, num, rot_set);
+}
+
+void analyzer(std::string scramble, bool cross, bool x, bool xx, bool xxx, std::string num, std::string rot_set)
+{
+	analyzer_session session;
+	session.analyze(scramble, cross, x, xx, xxx, num, rot_set);
 }
 
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("analyze", &analyzer);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::class_<analyzer_session>("Analyzer")
+		.constructor<>()
+		.function("analyze", &analyzer_session::analyze)
+		.function("analyze_corpus", &analyzer_session::analyze_corpus)
+		.function("analyze_random", &analyzer_session::analyze_random)
+		.function("analyze_random_moves", &analyzer_session::analyze_random_moves);
 }
\ No newline at end of file
@@ -7,11 +7,41 @@ const solverPromise = new Promise(resolve => {
 
 importScripts('pseudo_analyzer.js');
 
+let analyzer = null;
+
 self.onmessage = async function (event) {
-	const { scramble, cross, x, xx, xxx, n, rot_set } = event.data;
+	const { scramble, cross, x, xx, xxx, n, rot_set, corpus, seed, count, random_moves, time_limit_ms, node_limit, cancel_buffer } = event.data;
 	try {
 		const Module = await solverPromise;
-		Module.analyze(scramble, cross, x, xx, xxx, n, rot_set);
+		if (cancel_buffer !== undefined) {
+			// Int32Array over a SharedArrayBuffer; the page sets [0] to 1 to stop the running search
+			Module.searchCancel = new Int32Array(cancel_buffer);
+		}
+		if (Module.searchCancel) {
+			Atomics.store(Module.searchCancel, 0, 0);
+		}
+		if (Module.set_search_limits) {
+			// 0 = no limit; a stopped search posts its reason, results found so far are kept
+			Module.set_search_limits(time_limit_ms || 0, node_limit || 0);
+		}
+		if (Module.Analyzer) {
+			// Persistent instance: tables are built once and reused for later scrambles
+			if (!analyzer) {
+				analyzer = new Module.Analyzer();
+			}
+			if (corpus !== undefined) {
+				// Batch mode: aggregated statistics as JSON, no per-row messages
+				self.postMessage(analyzer.analyze_corpus(corpus.join("\n"), cross, x, xx, xxx, n, rot_set));
+			} else if (count !== undefined) {
+				// Random-state scrambles; random_moves selects 25-move random-move ones
+				const run = random_moves ? analyzer.analyze_random_moves : analyzer.analyze_random;
+				self.postMessage(run.call(analyzer, seed || 0, count, cross, x, xx, xxx, n, rot_set));
+			} else {
+				analyzer.analyze(scramble, cross, x, xx, xxx, n, rot_set);
+			}
+		} else {
+			Module.analyze(scramble, cross, x, xx, xxx, n, rot_set);
+		}
 	} catch (e) {
 		self.postMessage("Error");
 	}
@@ -7,6 +7,11 @@
 #include <string>
 #include <sstream>
 #include <bitset>
+#include <functional>
+#include <memory>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
 	postMessage(UTF8ToString(str));
@@ -208,36 +213,18 @@ std::vector<std::vector<int>> index_to_center =
 		{4, 5, 0, 1, 2, 3}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'", "u", "u2", "u'", "d", "d2", "d'", "l", "l2", "l'", "r", "r2", "r'", "f", "f2", "f'", "b", "b2", "b'", "M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'", "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
+MoveCodec move_codec(move_names);
 
 std::vector<std::string> rotation_names = {"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<std::vector<int>> rotationMap =
@@ -819,6 +806,42 @@ void create_prune_table_xcross(int index2, int depth, const std::vector<int> &ta
 	}
 }
 
+// create_prune_table_cross() / create_prune_table_xcross() through cache:
+// searches sharing the cache get one table per set of arguments (move tables
+// are told apart by address)
+std::string prune_table_key(const std::string &kind, int index2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, const std::vector<int> &move_restrict)
+{
+	std::ostringstream key;
+	key << kind << ' ' << index2 << ' ' << depth << ' ' << table1.data() << ' ' << table2.data();
+	for (int m : move_restrict)
+	{
+		key << ' ' << m;
+	}
+	return key.str();
+}
+
+TableRef<unsigned char> cached_prune_table_cross(TableCache<unsigned char> &cache, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<int> &move_restrict, std::vector<std::vector<int>> &center_move_table)
+{
+	return cache.acquire(prune_table_key("cross", 0, depth, table1, table2, move_restrict), [&]()
+	{
+		std::vector<unsigned char> prune_table(528 * 528, 255);
+		std::vector<unsigned char> tmp_array;
+		create_prune_table_cross(depth, table1, table2, prune_table, move_restrict, tmp_array, center_move_table);
+		return prune_table;
+	});
+}
+
+TableRef<unsigned char> cached_prune_table_xcross(TableCache<unsigned char> &cache, int index2, int depth, const std::vector<int> &table1, const std::vector<int> &table2, std::vector<int> &move_restrict, std::vector<std::vector<int>> &center_move_table)
+{
+	return cache.acquire(prune_table_key("xcross", index2, depth, table1, table2, move_restrict), [&]()
+	{
+		std::vector<unsigned char> prune_table(190080 * 24, 255);
+		std::vector<unsigned char> tmp_array;
+		create_prune_table_xcross(index2, depth, table1, table2, prune_table, move_restrict, tmp_array, center_move_table);
+		return prune_table;
+	});
+}
+
 std::vector<bool> create_ma_table()
 {
 	std::vector<bool> ma(28 * 27, false);
@@ -854,10 +877,9 @@ struct cross_search
 	int sol_num;
 	int count;
 	std::vector<std::vector<int>> center_move_table;
-	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> multi_move_table;
-	std::vector<unsigned char> prune_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> multi_move_table;
+	TableRef<unsigned char> prune_table;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -885,23 +907,38 @@ struct cross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
+	// Set by prepare() for search_depth(); start_depth 0 = already solved.
+	// label prefixes the emitted solutions and the prune tables come from
+	// prune_tables, shared by the combinations of solve_F2L_interleaved
+	int aprev_start;
+	int start_depth;
+	std::string label;
+	std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
 	cross_search()
 	{
-		edge_move_table = create_edge_move_table();
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
 		center_move_table = create_center_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 27, -1);
-		create_multi_move_table(2, 2, 12, 24 * 22, multi_move_table, edge_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/2", [&]()
+		{
+			std::vector<int> table(24 * 22 * 27, -1);
+			create_multi_move_table(2, 2, 12, 24 * 22, table, edge_move_table);
+			return table;
+		});
 		index1 = 416;
 		index2 = 520;
 		ma = create_ma_table();
-		prune_table = std::vector<unsigned char>(24 * 22 * 24 * 22, 255);
 	}
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index_eo1, int arg_index_eo2, int arg_index_eo3, int arg_index_eo4, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1006,18 +1043,18 @@ struct cross_search
                             index_eo4_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -1139,18 +1176,18 @@ struct cross_search
                             index_eo4_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -1168,7 +1205,7 @@ struct cross_search
 		return false;
 	}
 
-	void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 8, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+	void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_sol_num = 100, int arg_max_length = 8, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
 	{
 		scramble = arg_scramble;
 		rotation = arg_rotation;
@@ -1198,7 +1235,8 @@ struct cross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -1217,9 +1255,9 @@ struct cross_search
         index_eo2 = 2;
         index_eo3 = 4;
         index_eo4 = 6;
-		create_prune_table_cross(20, multi_move_table, multi_move_table, prune_table, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table = cached_prune_table_cross(*prune_tables, 20, multi_move_table, multi_move_table, move_restrict_tmp, center_move_table);
 		count = 0;
-		int aprev_tmp = 54;
+		aprev_start = 54;
 		for (int m : alg)
 		{
 			index1 = multi_move_table[index1 * 27 + m];
@@ -1232,7 +1270,7 @@ struct cross_search
 		initial_center = 0;
 		for (int m_tmp : post_alg)
 		{
-			aprev_tmp = m_tmp;
+			aprev_start = m_tmp;
 			if (m_tmp >= 45)
 			{
 				initial_center = center_move_table[initial_center][m_tmp];
@@ -1247,40 +1285,60 @@ struct cross_search
             index_eo3 = edge_move_table[index_eo3 * 27 + m];
             index_eo4 = edge_move_table[index_eo4 * 27 + m];
 		}
-		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
 		if (it == move_restrict.end())
 		{
-			aprev_tmp = 54;
+			aprev_start = 54;
 		}
 		prune_tmp = prune_table[index1 * 528 + index2];
 		if (prune_tmp == 0 && index_eo1 % 2 == 0 && index_eo2 % 2 == 0 && index_eo3 % 2 == 0 && index_eo4 % 2 == 0)
+		{
+			start_depth = 0;
+			return;
+		}
+		index1 *= 27;
+		index2 *= 27;
+		index_eo1 *= 27;
+		index_eo2 *= 27;
+		index_eo3 *= 27;
+		index_eo4 *= 27;
+		start_depth = prune_tmp;
+		if (start_depth == 255)
+		{
+			start_depth = 1;
+		}
+	}
+
+	bool search_depth(int d)
+	{
+		return depth_limited_search(index1, index2, index_eo1, index_eo2, index_eo3, index_eo4, d, initial_center, 0, aprev_start * 54);
+	}
+
+	// Full search: prepare() (same arguments and defaults), then every depth
+	// from start_depth to max_length
+	template <class... Args>
+	void start_search(Args &&...args)
+	{
+		prepare(std::forward<Args>(args)...);
+		if (start_depth == 0)
 		{
 			update("Already solved.");
+			return;
 		}
-		else
+		for (int d = start_depth; d <= max_length; d++)
 		{
-			index1 *= 27;
-			index2 *= 27;
-            index_eo1 *= 27;
-            index_eo2 *= 27;
-            index_eo3 *= 27;
-            index_eo4 *= 27;
-			int d_min = prune_tmp;
-			if (d_min == 255)
+			tmp = "depth=" + std::to_string(d);
+			update(tmp.c_str());
+			if (search_depth(d))
 			{
-				d_min = 1;
+				break;
 			}
-			for (int d = d_min; d <= max_length; d++)
-			{
-				tmp = "depth=" + std::to_string(d);
-				update(tmp.c_str());
-				if (depth_limited_search(index1, index2, index_eo1, index_eo2, index_eo3, index_eo4, d, initial_center, 0, aprev_tmp * 54))
-				{
-					break;
-				}
-			}
-			update("Search finished.");
 		}
+		if (SearchBudget::instance().stopped())
+		{
+			update(SearchBudget::instance().stop_message());
+		}
+		update("Search finished.");
 	}
 };
 
@@ -1295,11 +1353,10 @@ struct xcross_search
 	int sol_num;
 	int count;
 	std::vector<std::vector<int>> center_move_table;
-	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
-	std::vector<unsigned char> prune_table1;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
+	TableRef<unsigned char> prune_table1;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -1328,22 +1385,37 @@ struct xcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
+	// Set by prepare() for search_depth(); start_depth 0 = already solved.
+	// label prefixes the emitted solutions and the prune tables come from
+	// prune_tables, shared by the combinations of solve_F2L_interleaved
+	int aprev_start;
+	int start_depth;
+	std::string label;
+	std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
 	xcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		ma = create_ma_table();
-		prune_table1 = std::vector<unsigned char>(190080 * 24, 255);
 	}
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index3, int arg_index_eo1, int arg_index_eo2, int arg_index_eo3, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1448,18 +1520,18 @@ struct xcross_search
                             index_eo3_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -1581,18 +1653,18 @@ struct xcross_search
                             index_eo3_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -1610,7 +1682,7 @@ struct xcross_search
 		return false;
 	}
 
-	void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_pslot1 = 0, int arg_sol_num = 100, int arg_max_length = 10, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+	void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_pslot1 = 0, int arg_sol_num = 100, int arg_max_length = 10, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
 	{
 		scramble = arg_scramble;
 		rotation = arg_rotation;
@@ -1642,7 +1714,8 @@ struct xcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -1673,9 +1746,9 @@ struct xcross_search
         index_eo1 = eo_indices[0];
         index_eo2 = eo_indices[1];
         index_eo3 = eo_indices[2];
-		create_prune_table_xcross(index2, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table1 = cached_prune_table_xcross(*prune_tables, index2, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
 		count = 0;
-		int aprev_tmp = 54;
+		aprev_start = 54;
 		for (int m : alg)
 		{
 			index1 = multi_move_table[index1 * 27 + m];
@@ -1688,7 +1761,7 @@ struct xcross_search
 		initial_center = 0;
 		for (int m_tmp : post_alg)
 		{
-			aprev_tmp = m_tmp;
+			aprev_start = m_tmp;
 			if (m_tmp >= 45)
 			{
 				initial_center = center_move_table[initial_center][m_tmp];
@@ -1703,40 +1776,60 @@ struct xcross_search
             index_eo2 = edge_move_table[index_eo2 * 27 + m];
             index_eo3 = edge_move_table[index_eo3 * 27 + m];
 		}
-		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
 		if (it == move_restrict.end())
 		{
-			aprev_tmp = 54;
+			aprev_start = 54;
 		}
 		prune1_tmp = prune_table1[index1 * 24 + index2];
 		if (prune1_tmp == 0 && index3 == edge_solved1 && index_eo1 % 2 == 0 && index_eo2 % 2 == 0 && index_eo3 % 2 == 0)
+		{
+			start_depth = 0;
+			return;
+		}
+		index1 *= 27;
+		index2 *= 27;
+		index3 *= 27;
+		index_eo1 *= 27;
+		index_eo2 *= 27;
+		index_eo3 *= 27;
+		start_depth = prune1_tmp;
+		if (start_depth == 255)
+		{
+			start_depth = 1;
+		}
+	}
+
+	bool search_depth(int d)
+	{
+		return depth_limited_search(index1, index2, index3, index_eo1, index_eo2, index_eo3, d, initial_center, 0, aprev_start * 54);
+	}
+
+	// Full search: prepare() (same arguments and defaults), then every depth
+	// from start_depth to max_length
+	template <class... Args>
+	void start_search(Args &&...args)
+	{
+		prepare(std::forward<Args>(args)...);
+		if (start_depth == 0)
 		{
 			update("Already solved.");
+			return;
 		}
-		else
+		for (int d = start_depth; d <= max_length; d++)
 		{
-			index1 *= 27;
-			index2 *= 27;
-			index3 *= 27;
-            index_eo1 *= 27;
-            index_eo2 *= 27;
-            index_eo3 *= 27;
-			int d_min = prune1_tmp;
-			if (d_min == 255)
-			{
-				d_min = 1;
-			}
-			for (int d = d_min; d <= max_length; d++)
+			tmp = "depth=" + std::to_string(d);
+			update(tmp.c_str());
+			if (search_depth(d))
 			{
-				tmp = "depth=" + std::to_string(d);
-				update(tmp.c_str());
-				if (depth_limited_search(index1, index2, index3, index_eo1, index_eo2, index_eo3, d, initial_center, 0, aprev_tmp * 54))
-				{
-					break;
-				}
+				break;
 			}
-			update("Search finished.");
 		}
+		if (SearchBudget::instance().stopped())
+		{
+			update(SearchBudget::instance().stop_message());
+		}
+		update("Search finished.");
 	}
 };
 
@@ -1753,12 +1846,11 @@ struct xxcross_search
 	int sol_num;
 	int count;
 	std::vector<std::vector<int>> center_move_table;
-	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
-	std::vector<unsigned char> prune_table1;
-	std::vector<unsigned char> prune_table2;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
+	TableRef<unsigned char> prune_table1;
+	TableRef<unsigned char> prune_table2;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -1793,23 +1885,37 @@ struct xxcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
+	// Set by prepare() for search_depth(); start_depth 0 = already solved.
+	// label prefixes the emitted solutions and the prune tables come from
+	// prune_tables, shared by the combinations of solve_F2L_interleaved
+	int aprev_start;
+	int start_depth;
+	std::string label;
+	std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
 	xxcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		ma = create_ma_table();
-		prune_table1 = std::vector<unsigned char>(190080 * 24, 255);
-		prune_table2 = std::vector<unsigned char>(190080 * 24, 255);
 	}
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int arg_index_eo1, int arg_index_eo2, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1923,18 +2029,18 @@ struct xxcross_search
                             index_eo2_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -2065,18 +2171,18 @@ struct xxcross_search
                             index_eo2_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -2094,7 +2200,7 @@ struct xxcross_search
 		return false;
 	}
 
-	void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_pslot1 = 0, int arg_pslot2 = 3, int arg_sol_num = 100, int arg_max_length = 12, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+	void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_pslot1 = 0, int arg_pslot2 = 3, int arg_sol_num = 100, int arg_max_length = 12, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
 	{
 		scramble = arg_scramble;
 		rotation = arg_rotation;
@@ -2128,7 +2234,8 @@ struct xxcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -2148,11 +2255,11 @@ struct xxcross_search
 		index2 = corner_index[pslot1];
 		index5 = single_edge_index[slot1];
 		edge_solved1 = index5;
-		create_prune_table_xcross(index2, 20, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table1 = cached_prune_table_xcross(*prune_tables, index2, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
 		index4 = corner_index[pslot2];
 		index6 = single_edge_index[slot2];
 		edge_solved2 = index6;
-		create_prune_table_xcross(index4, 20, multi_move_table, corner_move_table, prune_table2, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table2 = cached_prune_table_xcross(*prune_tables, index4, 20, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         std::vector<int> eo_indices;
         bool is_solved[4] = {false};
         is_solved[slot1] = true; 
@@ -2165,7 +2272,7 @@ struct xxcross_search
         index_eo1 = eo_indices[0];
         index_eo2 = eo_indices[1];
 		count = 0;
-		int aprev_tmp = 54;
+		aprev_start = 54;
 		for (int m : alg)
 		{
 			index1 = multi_move_table[index1 * 27 + m];
@@ -2179,7 +2286,7 @@ struct xxcross_search
 		initial_center = 0;
 		for (int m_tmp : post_alg)
 		{
-			aprev_tmp = m_tmp;
+			aprev_start = m_tmp;
 			if (m_tmp >= 45)
 			{
 				initial_center = center_move_table[initial_center][m_tmp];
@@ -2195,42 +2302,62 @@ struct xxcross_search
             index_eo1 = edge_move_table[index_eo1 * 27 + m];
             index_eo2 = edge_move_table[index_eo2 * 27 + m];
 		}
-		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
 		if (it == move_restrict.end())
 		{
-			aprev_tmp = 54;
+			aprev_start = 54;
 		}
 		prune1_tmp = prune_table1[index1 * 24 + index2];
 		prune2_tmp = prune_table2[index1 * 24 + index4];
 		if (prune1_tmp == 0 && prune2_tmp == 0 && index5 == edge_solved1 && index6 == edge_solved2 && index_eo1 % 2 == 0 && index_eo2 % 2 == 0)
+		{
+			start_depth = 0;
+			return;
+		}
+		index1 *= 27;
+		index2 *= 27;
+		index4 *= 27;
+		index5 *= 27;
+		index6 *= 27;
+		index_eo1 *= 27;
+		index_eo2 *= 27;
+		start_depth = std::max(prune1_tmp, prune2_tmp);
+		if (start_depth == 255)
+		{
+			start_depth = 1;
+		}
+	}
+
+	bool search_depth(int d)
+	{
+		return depth_limited_search(index1, index2, index4, index5, index6, index_eo1, index_eo2, d, initial_center, 0, aprev_start * 54);
+	}
+
+	// Full search: prepare() (same arguments and defaults), then every depth
+	// from start_depth to max_length
+	template <class... Args>
+	void start_search(Args &&...args)
+	{
+		prepare(std::forward<Args>(args)...);
+		if (start_depth == 0)
 		{
 			update("Already solved.");
+			return;
 		}
-		else
+		for (int d = start_depth; d <= max_length; d++)
 		{
-			index1 *= 27;
-			index2 *= 27;
-			index4 *= 27;
-			index5 *= 27;
-			index6 *= 27;
-            index_eo1 *= 27;
-            index_eo2 *= 27;
-			int d_min = std::max(prune1_tmp, prune2_tmp);
-			if (d_min == 255)
+			tmp = "depth=" + std::to_string(d);
+			update(tmp.c_str());
+			if (search_depth(d))
 			{
-				d_min = 1;
+				break;
 			}
-			for (int d = d_min; d <= max_length; d++)
-			{
-				tmp = "depth=" + std::to_string(d);
-				update(tmp.c_str());
-				if (depth_limited_search(index1, index2, index4, index5, index6, index_eo1, index_eo2, d, initial_center, 0, aprev_tmp * 54))
-				{
-					break;
-				}
-			}
-			update("Search finished.");
 		}
+		if (SearchBudget::instance().stopped())
+		{
+			update(SearchBudget::instance().stop_message());
+		}
+		update("Search finished.");
 	}
 };
 
@@ -2249,13 +2376,12 @@ struct xxxcross_search
 	int sol_num;
 	int count;
 	std::vector<std::vector<int>> center_move_table;
-	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
-	std::vector<unsigned char> prune_table1;
-	std::vector<unsigned char> prune_table2;
-	std::vector<unsigned char> prune_table3;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
+	TableRef<unsigned char> prune_table1;
+	TableRef<unsigned char> prune_table2;
+	TableRef<unsigned char> prune_table3;
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -2296,24 +2422,37 @@ struct xxxcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
+	// Set by prepare() for search_depth(); start_depth 0 = already solved.
+	// label prefixes the emitted solutions and the prune tables come from
+	// prune_tables, shared by the combinations of solve_F2L_interleaved
+	int aprev_start;
+	int start_depth;
+	std::string label;
+	std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
 
 	xxxcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		ma = create_ma_table();
-		prune_table1 = std::vector<unsigned char>(190080 * 24, 255);
-		prune_table2 = std::vector<unsigned char>(190080 * 24, 255);
-		prune_table3 = std::vector<unsigned char>(190080 * 24, 255);
 	}
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int arg_index_eo1, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -2436,18 +2575,18 @@ struct xxxcross_search
                             index_eo1_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -2587,18 +2726,18 @@ struct xxxcross_search
                             index_eo1_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
-						update(tmp.c_str());
+						update((label + tmp).c_str());
 						if (count == sol_num)
 						{
 							return true;
@@ -2616,7 +2755,7 @@ struct xxxcross_search
 		return false;
 	}
 
-	void start_search(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_slot3 = 1, int arg_pslot1 = 0, int arg_pslot2 = 3, int arg_pslot3 = 1, int arg_sol_num = 100, int arg_max_length = 14, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
+	void prepare(std::string arg_scramble = "", std::string arg_rotation = "", int arg_slot1 = 0, int arg_slot2 = 3, int arg_slot3 = 1, int arg_pslot1 = 0, int arg_pslot2 = 3, int arg_pslot3 = 1, int arg_sol_num = 100, int arg_max_length = 14, const std::vector<std::string> &arg_restrict = move_names, std::string arg_post_alg = "", const std::vector<int> &arg_center_offset = {0}, int arg_max_rot_count = 0, const std::vector<bool> &arg_ma2 = std::vector<bool>(55 * 54, false), const std::vector<int> &arg_mc = std::vector<int>(54, 20))
 	{
 		scramble = arg_scramble;
 		rotation = arg_rotation;
@@ -2652,7 +2791,8 @@ struct xxxcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -2672,15 +2812,15 @@ struct xxxcross_search
 		index2 = corner_index[pslot1];
 		index7 = single_edge_index[slot1];
 		edge_solved1 = index7;
-		create_prune_table_xcross(index2, 10, multi_move_table, corner_move_table, prune_table1, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table1 = cached_prune_table_xcross(*prune_tables, index2, 10, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
 		index4 = corner_index[pslot2];
 		index8 = single_edge_index[slot2];
 		edge_solved2 = index8;
-		create_prune_table_xcross(index4, 10, multi_move_table, corner_move_table, prune_table2, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table2 = cached_prune_table_xcross(*prune_tables, index4, 10, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
 		index6 = corner_index[pslot3];
 		index9 = single_edge_index[slot3];
 		edge_solved3 = index9;
-		create_prune_table_xcross(index6, 10, multi_move_table, corner_move_table, prune_table3, move_restrict_tmp, tmp_array, center_move_table);
+		prune_table3 = cached_prune_table_xcross(*prune_tables, index6, 10, multi_move_table, corner_move_table, move_restrict_tmp, center_move_table);
         std::vector<int> eo_indices;
         bool is_solved[4] = {false};
         is_solved[slot1] = true; 
@@ -2693,7 +2833,7 @@ struct xxxcross_search
         }
         index_eo1 = eo_indices[0];
 		count = 0;
-		int aprev_tmp = 54;
+		aprev_start = 54;
 		for (int m : alg)
 		{
 			index1 = multi_move_table[index1 * 27 + m];
@@ -2708,7 +2848,7 @@ struct xxxcross_search
 		initial_center = 0;
 		for (int m_tmp : post_alg)
 		{
-			aprev_tmp = m_tmp;
+			aprev_start = m_tmp;
 			if (m_tmp >= 45)
 			{
 				initial_center = center_move_table[initial_center][m_tmp];
@@ -2725,44 +2865,64 @@ struct xxxcross_search
 			index9 = edge_move_table[index9 * 27 + m];
             index_eo1 = edge_move_table[index_eo1 * 27 + m];
 		}
-		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_tmp);
+		auto it = std::find(move_restrict.begin(), move_restrict.end(), aprev_start);
 		if (it == move_restrict.end())
 		{
-			aprev_tmp = 54;
+			aprev_start = 54;
 		}
 		prune1_tmp = prune_table1[index1 * 24 + index2];
 		prune2_tmp = prune_table2[index1 * 24 + index4];
 		prune3_tmp = prune_table3[index1 * 24 + index6];
 		if (prune1_tmp == 0 && prune2_tmp == 0 && prune3_tmp == 0 && index7 == edge_solved1 && index8 == edge_solved2 && index9 == edge_solved3 && index_eo1 % 2 == 0)
+		{
+			start_depth = 0;
+			return;
+		}
+		index1 *= 27;
+		index2 *= 27;
+		index4 *= 27;
+		index6 *= 27;
+		index7 *= 27;
+		index8 *= 27;
+		index9 *= 27;
+		index_eo1 *= 27;
+		start_depth = std::max(prune1_tmp, std::max(prune2_tmp, prune3_tmp));
+		if (start_depth == 255)
+		{
+			start_depth = 1;
+		}
+	}
+
+	bool search_depth(int d)
+	{
+		return depth_limited_search(index1, index2, index4, index6, index7, index8, index9, index_eo1, d, initial_center, 0, aprev_start * 54);
+	}
+
+	// Full search: prepare() (same arguments and defaults), then every depth
+	// from start_depth to max_length
+	template <class... Args>
+	void start_search(Args &&...args)
+	{
+		prepare(std::forward<Args>(args)...);
+		if (start_depth == 0)
 		{
 			update("Already solved.");
+			return;
 		}
-		else
+		for (int d = start_depth; d <= max_length; d++)
 		{
-			index1 *= 27;
-			index2 *= 27;
-			index4 *= 27;
-			index6 *= 27;
-			index7 *= 27;
-			index8 *= 27;
-			index9 *= 27;
-            index_eo1 *= 27;
-			int d_min = std::max(prune1_tmp, std::max(prune2_tmp, prune3_tmp));
-			if (d_min == 255)
+			tmp = "depth=" + std::to_string(d);
+			update(tmp.c_str());
+			if (search_depth(d))
 			{
-				d_min = 1;
+				break;
 			}
-			for (int d = d_min; d <= max_length; d++)
-			{
-				tmp = "depth=" + std::to_string(d);
-				update(tmp.c_str());
-				if (depth_limited_search(index1, index2, index4, index6, index7, index8, index9, index_eo1, d, initial_center, 0, aprev_tmp * 54))
-				{
-					break;
-				}
-			}
-			update("Search finished.");
 		}
+		if (SearchBudget::instance().stopped())
+		{
+			update(SearchBudget::instance().stop_message());
+		}
+		update("Search finished.");
 	}
 };
 
@@ -2858,37 +3018,13 @@ void buidMoveRestrict(const std::string &restID, std::vector<std::string> &move_
 	}
 }
 
-static std::string get_move_base(const std::string &move)
-{
-	if (move.empty())
-		return "";
-	return move.substr(0, 1);
-}
-
 static bool should_be_checked_by_default(const std::string &prev_move, const std::string &next_move)
 {
 	if (prev_move.empty())
 		return false;
-	const static std::map<std::string, int> y_axis_order = {{"U", 0}, {"D", 1}, {"E", 2}, {"u", 3}, {"d", 4}, {"y", 5}};
-	const static std::map<std::string, int> x_axis_order = {{"L", 0}, {"R", 1}, {"M", 2}, {"l", 3}, {"r", 4}, {"x", 5}};
-	const static std::map<std::string, int> z_axis_order = {{"F", 0}, {"B", 1}, {"S", 2}, {"f", 3}, {"b", 4}, {"z", 5}};
-	const static std::map<std::string, const std::map<std::string, int> *> base_to_axis_map = {
-		{"U", &y_axis_order}, {"D", &y_axis_order}, {"E", &y_axis_order}, {"u", &y_axis_order}, {"d", &y_axis_order}, {"y", &y_axis_order}, {"L", &x_axis_order}, {"R", &x_axis_order}, {"M", &x_axis_order}, {"l", &x_axis_order}, {"r", &x_axis_order}, {"x", &x_axis_order}, {"F", &z_axis_order}, {"B", &z_axis_order}, {"S", &z_axis_order}, {"f", &z_axis_order}, {"b", &z_axis_order}, {"z", &z_axis_order}};
-	std::string prev_base = get_move_base(prev_move);
-	std::string next_base = get_move_base(next_move);
-	if (prev_base == next_base)
-		return true;
-	auto it_prev = base_to_axis_map.find(prev_base);
-	auto it_next = base_to_axis_map.find(next_base);
-	if (it_prev != base_to_axis_map.end() && it_next != base_to_axis_map.end() && it_prev->second == it_next->second)
-	{
-		const auto &axis_map = *it_prev->second;
-		if (axis_map.at(prev_base) > axis_map.at(next_base))
-		{
-			return true;
-		}
-	}
-	return false;
+	int prev = move_codec.id(prev_move.data(), prev_move.size());
+	int next = move_codec.id(next_move.data(), next_move.size());
+	return prev != -1 && next != -1 && move_codec.follows_out_of_order(prev, next);
 }
 
 void buidMA2(const std::string &restID, const std::string &mavString, std::vector<bool> &vector)
@@ -2966,6 +3102,19 @@ void buidMA2(const std::string &restID, const std::string &mavString, std::vecto
 			}
 		}
 	}
+	if (canonical_mode())
+	{
+		for (const auto &row_move : active_moves)
+		{
+			for (const auto &col_move : active_moves)
+			{
+				if (should_be_checked_by_default(row_move, col_move))
+				{
+					vector[move_to_index_map.at(row_move) * NUM_COLS + move_to_index_map.at(col_move)] = true;
+				}
+			}
+		}
+	}
 }
 
 void buildMoveCountVector(const std::string &restID, const std::string &moveCountString, std::vector<int> &move_count_vector)
@@ -3033,8 +3182,146 @@ void buildMoveCountVector(const std::string &restID, const std::string &moveCoun
 	}
 }
 
+// One slot / pseudo slot combination of the interleaved mode
+struct F2L_combination
+{
+	std::string label;
+	int start_depth;
+	std::function<int(int, int)> search_depth; // (depth, solutions left) -> solutions found
+};
+
+template <class Search, class... Args>
+F2L_combination make_F2L_combination(const std::string &label, const std::shared_ptr<TableCache<unsigned char>> &prune_tables, Args &&...args)
+{
+	std::shared_ptr<Search> search = std::make_shared<Search>();
+	search->label = "[" + label + "] ";
+	search->prune_tables = prune_tables;
+	search->prepare(std::forward<Args>(args)...);
+	F2L_combination combination;
+	combination.label = label;
+	combination.start_depth = search->start_depth;
+	combination.search_depth = [search](int depth, int left)
+	{
+		search->count = 0;
+		search->sol_num = left;
+		search->search_depth(depth);
+		return search->count;
+	};
+	return combination;
+}
+
+std::vector<int> F2L_slot_list(const std::string &input)
+{
+	std::vector<bool> option_list = F2L_option_array(input);
+	std::vector<int> slot;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (option_list[i])
+		{
+			slot.emplace_back(i);
+		}
+	}
+	return slot;
+}
+
+// Interleaved mode: slot and pslot list combinations separated by '|', paired
+// by position (slot "BL|BL", pslot "BL|BR"; a pslot without '|' applies to
+// every combination). Every combination is searched at depth d before any is
+// searched at d + 1, so solutions are emitted in nondecreasing length, each
+// prefixed with its combination ("[BL/BR] ..."), and the search ends after
+// sol_num solutions in total.
+void solve_F2L_interleaved(std::string scramble, std::string rotation, std::string slot, std::string pslot, int sol_num, int max_length, const std::vector<std::string> &move_restrict, std::string post_alg, const std::vector<int> &center_offset, int max_rot_count, const std::vector<bool> &ma2, const std::vector<int> &mc)
+{
+	std::vector<std::string> names = {"BL", "BR", "FR", "FL"};
+	std::vector<std::string> slot_parts, pslot_parts;
+	std::string part;
+	std::istringstream slot_iss(slot);
+	while (std::getline(slot_iss, part, '|'))
+	{
+		slot_parts.emplace_back(part);
+	}
+	std::istringstream pslot_iss(pslot);
+	while (std::getline(pslot_iss, part, '|'))
+	{
+		pslot_parts.emplace_back(part);
+	}
+	std::shared_ptr<TableCache<unsigned char>> prune_tables = std::make_shared<TableCache<unsigned char>>();
+	std::vector<F2L_combination> combinations;
+	int found = 0;
+	for (size_t k = 0; k < slot_parts.size(); ++k)
+	{
+		std::vector<int> s = F2L_slot_list(slot_parts[k]);
+		std::vector<int> p = F2L_slot_list(pslot_parts.size() == 1 ? pslot_parts[0] : (k < pslot_parts.size() ? pslot_parts[k] : ""));
+		if (p.size() < s.size())
+		{
+			continue;
+		}
+		std::string label;
+		for (size_t i = 0; i < s.size(); ++i)
+		{
+			label += (i > 0 ? " " : "") + names[s[i]];
+		}
+		label += "/";
+		for (size_t i = 0; i < s.size(); ++i)
+		{
+			label += (i > 0 ? " " : "") + names[p[i]];
+		}
+		if (s.size() == 0)
+		{
+			combinations.emplace_back(make_F2L_combination<cross_search>("None", prune_tables, scramble, rotation, sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+		}
+		else if (s.size() == 1)
+		{
+			combinations.emplace_back(make_F2L_combination<xcross_search>(label, prune_tables, scramble, rotation, s[0], p[0], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+		}
+		else if (s.size() == 2)
+		{
+			combinations.emplace_back(make_F2L_combination<xxcross_search>(label, prune_tables, scramble, rotation, s[0], s[1], p[0], p[1], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+		}
+		else if (s.size() == 3)
+		{
+			combinations.emplace_back(make_F2L_combination<xxxcross_search>(label, prune_tables, scramble, rotation, s[0], s[1], s[2], p[0], p[1], p[2], sol_num, max_length, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc));
+		}
+		else
+		{
+			continue;
+		}
+		if (combinations.back().start_depth == 0)
+		{
+			update(("[" + combinations.back().label + "] Already solved.").c_str());
+			found++;
+		}
+	}
+	int d_min = max_length + 1;
+	for (const F2L_combination &combination : combinations)
+	{
+		if (combination.start_depth > 0)
+		{
+			d_min = std::min(d_min, combination.start_depth);
+		}
+	}
+	for (int d = d_min; d <= max_length && found < sol_num && !SearchBudget::instance().stopped(); d++)
+	{
+		update(("depth=" + std::to_string(d)).c_str());
+		for (F2L_combination &combination : combinations)
+		{
+			if (combination.start_depth == 0 || combination.start_depth > d || found >= sol_num || SearchBudget::instance().stopped())
+			{
+				continue;
+			}
+			found += combination.search_depth(d, sol_num - found);
+		}
+	}
+	if (SearchBudget::instance().stopped())
+	{
+		update(SearchBudget::instance().stop_message());
+	}
+	update("Search finished.");
+}
+
 void controller(std::string scr, std::string rot, std::string slot, std::string pslot, int num, int len, std::string move_restrict_string, std::string post_alg, std::string center_offset_string, int max_rot_count, std::string ma2_string, std::string mcString)
 {
+	SearchBudget::instance().begin();
 	std::vector<int> center_offset;
 	std::vector<bool> ma2;
 	std::vector<int> mc;
@@ -3043,6 +3330,11 @@ void controller(std::string scr, std::string rot, std::string slot, std::string
 	buidMoveRestrict(move_restrict_string, move_restrict);
 	buidMA2(move_restrict_string, ma2_string, ma2);
 	buildMoveCountVector(move_restrict_string, mcString, mc);
+	if (slot.find('|') != std::string::npos)
+	{
+		solve_F2L_interleaved(scr, rot, slot, pslot, num, len, move_restrict, post_alg, center_offset, max_rot_count, ma2, mc);
+		return;
+	}
 	std::vector<bool> slot_list = F2L_option_array(slot);
 	std::vector<bool> pslot_list = F2L_option_array(pslot);
 	int count = 0;
@@ -3110,4 +3402,6 @@ void controller(std::string scr, std::string rot, std::string slot, std::string
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("solve", &controller);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::function("set_canonical_mode", &set_canonical_mode);
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <sstream>
 #include <cstdlib>
 #include <bitset>
+#include "../table_registry.h"
+#include "../search_budget.h"
+#include "../move_sequence.h"
 
 EM_JS(void, update, (const char *str), {
 	postMessage(UTF8ToString(str));
@@ -209,36 +212,18 @@ std::vector<std::vector<int>> index_to_center =
 		{4, 5, 0, 1, 2, 3}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'", "u", "u2", "u'", "d", "d2", "d'", "l", "l2", "l'", "r", "r2", "r'", "f", "f2", "f'", "b", "b2", "b'", "M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'", "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
+MoveCodec move_codec(move_names);
 
 std::vector<std::string> rotation_names = {"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"};
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<std::vector<int>> rotationMap =
@@ -1053,9 +1038,9 @@ struct xcross_search
 	int count;
 	std::vector<std::vector<int>> center_move_table;
 	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> edge_corner_prune_table1;
 	std::vector<int> alg;
@@ -1081,22 +1066,31 @@ struct xcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
 
 	xcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		edge_corner_prune_table1 = std::vector<unsigned char>(24 * 24, 255);
 	}
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index3, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1194,16 +1188,16 @@ struct xcross_search
 							index3_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -1320,16 +1314,16 @@ struct xcross_search
 							index3_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -1381,7 +1375,8 @@ struct xcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -1456,6 +1451,10 @@ struct xcross_search
 					break;
 				}
 			}
+			if (SearchBudget::instance().stopped())
+			{
+				update(SearchBudget::instance().stop_message());
+			}
 			update("Search finished.");
 		}
 	}
@@ -1475,9 +1474,9 @@ struct xxcross_search
 	int count;
 	std::vector<std::vector<int>> center_move_table;
 	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> edge_corner_prune_table1;
 	std::vector<unsigned char> prune_table2;
@@ -1512,16 +1511,21 @@ struct xxcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
 
 	xxcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		edge_corner_prune_table1 = std::vector<unsigned char>(24 * 24, 255);
@@ -1529,6 +1533,10 @@ struct xxcross_search
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index5, int arg_index6, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -1639,16 +1647,16 @@ struct xxcross_search
 							index6_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -1778,16 +1786,16 @@ struct xxcross_search
 							index6_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -1841,7 +1849,8 @@ struct xxcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -1927,6 +1936,10 @@ struct xxcross_search
 					break;
 				}
 			}
+			if (SearchBudget::instance().stopped())
+			{
+				update(SearchBudget::instance().stop_message());
+			}
 			update("Search finished.");
 		}
 	}
@@ -1948,9 +1961,9 @@ struct xxxcross_search
 	int count;
 	std::vector<std::vector<int>> center_move_table;
 	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> edge_corner_prune_table1;
 	std::vector<unsigned char> prune_table2;
@@ -1994,16 +2007,21 @@ struct xxxcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
 
 	xxxcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		prune_table3 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
@@ -2012,6 +2030,10 @@ struct xxxcross_search
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index7, int arg_index8, int arg_index9, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -2135,16 +2157,16 @@ struct xxxcross_search
 							index9_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -2287,16 +2309,16 @@ struct xxxcross_search
 							index9_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -2352,7 +2374,8 @@ struct xxxcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -2449,6 +2472,10 @@ struct xxxcross_search
 					break;
 				}
 			}
+			if (SearchBudget::instance().stopped())
+			{
+				update(SearchBudget::instance().stop_message());
+			}
 			update("Search finished.");
 		}
 	}
@@ -2472,9 +2499,9 @@ struct xxxxcross_search
 	int count;
 	std::vector<std::vector<int>> center_move_table;
 	std::vector<unsigned char> tmp_array;
-	std::vector<int> edge_move_table;
-	std::vector<int> corner_move_table;
-	std::vector<int> multi_move_table;
+	TableRef<int> edge_move_table;
+	TableRef<int> corner_move_table;
+	TableRef<int> multi_move_table;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> edge_corner_prune_table1;
 	std::vector<unsigned char> prune_table2;
@@ -2527,16 +2554,21 @@ struct xxxxcross_search
 	int m_tmp;
 	std::vector<int> center_offset;
 	int max_rot_count;
-	std::string post_moves;
+	std::vector<int> post_sequence;
+	SolutionSet solutions;
 	int initial_center;
 
 	xxxxcross_search()
 	{
 		center_move_table = create_center_move_table();
-		edge_move_table = create_edge_move_table();
-		corner_move_table = create_corner_move_table();
-		multi_move_table = std::vector<int>(24 * 22 * 20 * 18 * 27, -1);
-		create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, multi_move_table, edge_move_table);
+		edge_move_table = shared_table<int>("solver/edge_move_table", create_edge_move_table);
+		corner_move_table = shared_table<int>("solver/corner_move_table", create_corner_move_table);
+		multi_move_table = shared_table<int>("solver/multi_move_table/4", [&]()
+		{
+			std::vector<int> table(24 * 22 * 20 * 18 * 27, -1);
+			create_multi_move_table(4, 2, 12, 24 * 22 * 20 * 18, table, edge_move_table);
+			return table;
+		});
 		prune_table1 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		prune_table2 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
 		prune_table3 = std::vector<unsigned char>(24 * 22 * 20 * 18 * 24, 255);
@@ -2546,6 +2578,10 @@ struct xxxxcross_search
 
 	bool depth_limited_search(int arg_index1, int arg_index2, int arg_index4, int arg_index6, int arg_index8, int arg_index9, int arg_index10, int arg_index11, int arg_index12, int depth, int center, int rot_count, int aprev)
 	{
+		if (SearchBudget::instance().expired())
+		{
+			return true;
+		}
 		for (int i : move_restrict_move)
 		{
 			if (ma2[aprev + i] || mc_tmp[i] >= mc[i])
@@ -2682,16 +2718,16 @@ struct xxxxcross_search
 							index12_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -2847,16 +2883,16 @@ struct xxxxcross_search
 							index12_tmp2 *= 27;
 						}
 					}
-					if (valid && center_valid)
+					if (valid && center_valid && solutions.insert(move_codec, post_sequence, sol))
 					{
 						count += 1;
 						if (rotation == "")
 						{
-							tmp = post_moves + AlgToString(sol);
+							tmp = move_codec.join(post_sequence, sol);
 						}
 						else
 						{
-							tmp = rotation + " " + post_moves + AlgToString(sol);
+							tmp = rotation + " " + move_codec.join(post_sequence, sol);
 						}
 						update(tmp.c_str());
 						if (count == sol_num)
@@ -2914,7 +2950,8 @@ struct xxxxcross_search
 		std::vector<int> rotation_alg = StringToAlg(rotation);
 		std::vector<int> alg = AlgRotation(scramble_alg, rotation_alg, center_move_table);
 		std::vector<int> post_alg = StringToAlg(arg_post_alg);
-		post_moves = AlgToString(post_alg);
+		post_sequence = post_alg;
+		solutions.clear();
 		std::vector<int> move_restrict_tmp = move_restrict;
 		int tc = 0;
 		for (int i : post_alg)
@@ -3022,6 +3059,10 @@ struct xxxxcross_search
 					break;
 				}
 			}
+			if (SearchBudget::instance().stopped())
+			{
+				update(SearchBudget::instance().stop_message());
+			}
 			update("Search finished.");
 		}
 	}
@@ -3119,37 +3160,13 @@ void buidMoveRestrict(const std::string &restID, std::vector<std::string> &move_
 	}
 }
 
-static std::string get_move_base(const std::string &move)
-{
-	if (move.empty())
-		return "";
-	return move.substr(0, 1);
-}
-
 static bool should_be_checked_by_default(const std::string &prev_move, const std::string &next_move)
 {
 	if (prev_move.empty())
 		return false;
-	const static std::map<std::string, int> y_axis_order = {{"U", 0}, {"D", 1}, {"E", 2}, {"u", 3}, {"d", 4}, {"y", 5}};
-	const static std::map<std::string, int> x_axis_order = {{"L", 0}, {"R", 1}, {"M", 2}, {"l", 3}, {"r", 4}, {"x", 5}};
-	const static std::map<std::string, int> z_axis_order = {{"F", 0}, {"B", 1}, {"S", 2}, {"f", 3}, {"b", 4}, {"z", 5}};
-	const static std::map<std::string, const std::map<std::string, int> *> base_to_axis_map = {
-		{"U", &y_axis_order}, {"D", &y_axis_order}, {"E", &y_axis_order}, {"u", &y_axis_order}, {"d", &y_axis_order}, {"y", &y_axis_order}, {"L", &x_axis_order}, {"R", &x_axis_order}, {"M", &x_axis_order}, {"l", &x_axis_order}, {"r", &x_axis_order}, {"x", &x_axis_order}, {"F", &z_axis_order}, {"B", &z_axis_order}, {"S", &z_axis_order}, {"f", &z_axis_order}, {"b", &z_axis_order}, {"z", &z_axis_order}};
-	std::string prev_base = get_move_base(prev_move);
-	std::string next_base = get_move_base(next_move);
-	if (prev_base == next_base)
-		return true;
-	auto it_prev = base_to_axis_map.find(prev_base);
-	auto it_next = base_to_axis_map.find(next_base);
-	if (it_prev != base_to_axis_map.end() && it_next != base_to_axis_map.end() && it_prev->second == it_next->second)
-	{
-		const auto &axis_map = *it_prev->second;
-		if (axis_map.at(prev_base) > axis_map.at(next_base))
-		{
-			return true;
-		}
-	}
-	return false;
+	int prev = move_codec.id(prev_move.data(), prev_move.size());
+	int next = move_codec.id(next_move.data(), next_move.size());
+	return prev != -1 && next != -1 && move_codec.follows_out_of_order(prev, next);
 }
 
 void buidMA2(const std::string &restID, const std::string &mavString, std::vector<bool> &vector)
@@ -3227,6 +3244,19 @@ void buidMA2(const std::string &restID, const std::string &mavString, std::vecto
 			}
 		}
 	}
+	if (canonical_mode())
+	{
+		for (const auto &row_move : active_moves)
+		{
+			for (const auto &col_move : active_moves)
+			{
+				if (should_be_checked_by_default(row_move, col_move))
+				{
+					vector[move_to_index_map.at(row_move) * NUM_COLS + move_to_index_map.at(col_move)] = true;
+				}
+			}
+		}
+	}
 }
 
 void buildMoveCountVector(const std::string &restID, const std::string &moveCountString, std::vector<int> &move_count_vector)
@@ -3296,6 +3326,7 @@ void buildMoveCountVector(const std::string &restID, const std::string &moveCoun
 
 void controller(std::string scr, std::string rot, std::string slot, std::string pslot, std::string a_slot, std::string a_pslot, int num, int len, std::string move_restrict_string, std::string post_alg, std::string center_offset_string, int max_rot_count, std::string ma2_string, std::string mcString)
 {
+	SearchBudget::instance().begin();
 	std::vector<int> center_offset;
     std::vector<bool> ma2;
     std::vector<int> mc;
@@ -3407,4 +3438,6 @@ void controller(std::string scr, std::string rot, std::string slot, std::string
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	emscripten::function("solve", &controller);
+	emscripten::function("set_search_limits", &set_search_limits);
+	emscripten::function("set_canonical_mode", &set_canonical_mode);
 }
\ No newline at end of file
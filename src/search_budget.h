@@ -0,0 +1,117 @@
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+// =============================================================================
+// Search Budget
+// =============================================================================
+//
+// Cooperative stop for the IDA* searches of the solvers and analyzers. A
+// request calls begin(); every depth_limited_search calls expired() once per
+// node and unwinds (returns true) as soon as it reports a stop. Every
+// check_mask + 1 nodes expired() looks at
+//   - the node and wall-clock limits (set_search_limits, 0 = no limit), and
+//   - the cancel flag: element 0 of Module.searchCancel, an Int32Array the
+//     page shares with the worker through a SharedArrayBuffer. The running
+//     search sees it without ASYNCIFY or returning to the event loop.
+//
+// Nothing is checked while tables are built. Solutions found before the stop
+// have already been posted, and the tables stay as they are for the next
+// request.
+
+#include <chrono>
+#include <cstdint>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+class SearchBudget {
+public:
+    enum Stop { NONE, CANCELLED, TIME_LIMIT, NODE_LIMIT };
+
+    static SearchBudget& instance() {
+        static SearchBudget budget;
+        return budget;
+    }
+
+    // Limits for the following requests; 0 disables a limit.
+    void set_limits(double time_limit_ms, double node_limit) {
+        time_limit_ms_ = time_limit_ms > 0 ? time_limit_ms : 0;
+        node_limit_ = node_limit > 0 ? static_cast<uint64_t>(node_limit) : 0;
+    }
+
+    // Nodes between two checks minus one; must be 2^k - 1.
+    void set_check_mask(uint32_t mask) { check_mask_ = mask; }
+
+    void begin() {
+        nodes_ = 0;
+        stop_ = NONE;
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    bool expired() {
+        if (stop_ != NONE) return true;
+        if ((++nodes_ & check_mask_) != 0) return false;
+        return check();
+    }
+
+    bool stopped() const { return stop_ != NONE; }
+    Stop reason() const { return stop_; }
+    uint64_t nodes() const { return nodes_; }
+
+    const char* stop_message() const {
+        switch (stop_) {
+        case CANCELLED:
+            return "Search cancelled.";
+        case TIME_LIMIT:
+            return "Search stopped: time limit.";
+        case NODE_LIMIT:
+            return "Search stopped: node limit.";
+        default:
+            return "";
+        }
+    }
+
+private:
+    SearchBudget() = default;
+    SearchBudget(const SearchBudget&) = delete;
+    SearchBudget& operator=(const SearchBudget&) = delete;
+
+    bool check() {
+        if (node_limit_ > 0 && nodes_ >= node_limit_) {
+            stop_ = NODE_LIMIT;
+        } else if (time_limit_ms_ > 0 &&
+                   std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start_).count() >= time_limit_ms_) {
+            stop_ = TIME_LIMIT;
+        } else if (cancel_requested()) {
+            stop_ = CANCELLED;
+        }
+        return stop_ != NONE;
+    }
+
+    static bool cancel_requested() {
+#ifdef __EMSCRIPTEN__
+        return EM_ASM_INT({
+            return (Module.searchCancel && Atomics.load(Module.searchCancel, 0) != 0) ? 1 : 0;
+        }) != 0;
+#else
+        return false;
+#endif
+    }
+
+    // About 1-5 ms of search between checks
+    uint32_t check_mask_ = 0xFFFF;
+    uint64_t nodes_ = 0;
+    uint64_t node_limit_ = 0;
+    double time_limit_ms_ = 0;
+    Stop stop_ = NONE;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Bound by the solver / analyzer modules
+inline void set_search_limits(double time_limit_ms, double node_limit) {
+    SearchBudget::instance().set_limits(time_limit_ms, node_limit);
+}
+
+#endif // SEARCH_BUDGET_H
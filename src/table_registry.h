@@ -0,0 +1,141 @@
+#ifndef TABLE_REGISTRY_H
+#define TABLE_REGISTRY_H
+
+// =============================================================================
+// Shared Table Registry
+// =============================================================================
+//
+// Process-wide cache of read-only move tables, keyed by kind and parameters
+// (e.g. "solver/multi_move_table/4"). Search structs hold TableRef handles:
+// the first acquire builds a table, later ones - other structs, later solve
+// calls, other modules linked into the same WASM instance - share it.
+//
+// Tables stay cached after the last handle is dropped, so the next search
+// does not rebuild them. release_unused() frees the ones no handle refers to.
+//
+// A key must identify the content. Modules whose builders differ (the
+// solvers' tables with rotation moves vs the analyzers' 18-move tables) use
+// different prefixes.
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Read-only handle; indexes like the std::vector it replaces and converts to
+// const std::vector<T>& for the table builders.
+template <class T>
+class TableRef {
+public:
+    TableRef() = default;
+    TableRef(std::shared_ptr<const std::vector<T>> table)
+        : table_(std::move(table)), data_(table_ ? table_->data() : nullptr) {}
+
+    const T& operator[](size_t i) const { return data_[i]; }
+    operator const std::vector<T>&() const { return *table_; }
+    size_t size() const { return table_ ? table_->size() : 0; }
+
+private:
+    std::shared_ptr<const std::vector<T>> table_;
+    const T* data_ = nullptr;
+};
+
+class TableRegistry {
+public:
+    struct Stats {
+        size_t tables = 0;   // Cached tables
+        size_t bytes = 0;    // Their total size
+        size_t builds = 0;   // Tables built
+        size_t hits = 0;     // Acquires served from the cache
+    };
+
+    static TableRegistry& instance() {
+        static TableRegistry registry;
+        return registry;
+    }
+
+    // Table cached under key, built with build() on first use. build may
+    // itself acquire other tables.
+    template <class T, class Build>
+    TableRef<T> acquire(const std::string& key, Build&& build) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        auto it = tables_.find(key);
+        if (it != tables_.end()) {
+            stats_.hits++;
+            return TableRef<T>(std::static_pointer_cast<const std::vector<T>>(it->second.table));
+        }
+        auto table = std::make_shared<const std::vector<T>>(build());
+        const size_t bytes = table->size() * sizeof(T);
+        tables_[key] = Entry{table, bytes};
+        stats_.tables++;
+        stats_.bytes += bytes;
+        stats_.builds++;
+        return TableRef<T>(table);
+    }
+
+    // Free every table no TableRef refers to; returns the bytes released.
+    size_t release_unused() {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        size_t freed = 0;
+        for (auto it = tables_.begin(); it != tables_.end();) {
+            if (it->second.table.use_count() == 1) {
+                freed += it->second.bytes;
+                stats_.tables--;
+                stats_.bytes -= it->second.bytes;
+                it = tables_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return freed;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const void> table;
+        size_t bytes;
+    };
+
+    TableRegistry() = default;
+    TableRegistry(const TableRegistry&) = delete;
+    TableRegistry& operator=(const TableRegistry&) = delete;
+
+    mutable std::recursive_mutex mutex_;
+    std::unordered_map<std::string, Entry> tables_;
+    Stats stats_;
+};
+
+template <class T, class Build>
+TableRef<T> shared_table(const std::string& key, Build&& build) {
+    return TableRegistry::instance().acquire<T>(key, std::forward<Build>(build));
+}
+
+// Tables shared by a group of searches only (e.g. the prune tables of one
+// interleaved solve, which depend on the move restriction): built once per
+// key while the cache lives and freed with their last handle, instead of
+// staying in the registry.
+template <class T>
+class TableCache {
+public:
+    template <class Build>
+    TableRef<T> acquire(const std::string& key, Build&& build) {
+        auto it = tables_.find(key);
+        if (it == tables_.end()) {
+            it = tables_.emplace(key, TableRef<T>(std::make_shared<const std::vector<T>>(build()))).first;
+        }
+        return it->second;
+    }
+
+private:
+    std::unordered_map<std::string, TableRef<T>> tables_;
+};
+
+#endif // TABLE_REGISTRY_H
@@ -374,6 +374,14 @@ class robin_hash : private Hash, private KeyEqual, private GrowthPolicy {
   using const_pointer = const value_type*;
   using iterator = robin_iterator<false>;
   using const_iterator = robin_iterator<true>;
+  /**
+   * Type of the external element recording vector. Uses the same allocator
+   * family as the table so that a custom (e.g. arena) allocator also backs
+   * the recorded elements; with std::allocator this is std::vector<value_type>.
+   */
+  using element_vector_type =
+      std::vector<value_type, typename std::allocator_traits<
+                                  allocator_type>::template rebind_alloc<value_type>>;
 
  private:
   /**
@@ -1134,7 +1142,7 @@ class robin_hash : private Hash, private KeyEqual, private GrowthPolicy {
    * Added: 2025-12-27
    * Updated: 2026-01-01 (Changed to emplace_back, added reserve warning)
    */
-  void attach_element_vector(std::vector<value_type>* vec) {
+  void attach_element_vector(element_vector_type* vec) {
     m_element_vector = vec;
   }
   
@@ -1149,7 +1157,7 @@ class robin_hash : private Hash, private KeyEqual, private GrowthPolicy {
   /**
    * Get the attached element vector pointer (for checking).
    */
-  std::vector<value_type>* get_element_vector() const {
+  element_vector_type* get_element_vector() const {
     return m_element_vector;
   }
 
@@ -1728,7 +1736,7 @@ class robin_hash : private Hash, private KeyEqual, private GrowthPolicy {
    * Added: 2025-12-27
    * For RubiksSolverDemo memory-efficient BFS expansion
    */
-  std::vector<value_type>* m_element_vector;
+  element_vector_type* m_element_vector;
 };
 
 }  // namespace detail_robin_hash
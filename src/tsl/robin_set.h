@@ -118,6 +118,7 @@ class robin_set {
   using const_pointer = typename ht::const_pointer;
   using iterator = typename ht::iterator;
   using const_iterator = typename ht::const_iterator;
+  using element_vector_type = typename ht::element_vector_type;
 
   /*
    * Constructors
@@ -581,7 +582,7 @@ class robin_set {
    * 
    * Added: 2025-12-27
    */
-  void attach_element_vector(std::vector<value_type>* vec) {
+  void attach_element_vector(element_vector_type* vec) {
     m_ht.attach_element_vector(vec);
   }
   
@@ -589,7 +590,7 @@ class robin_set {
     m_ht.detach_element_vector();
   }
   
-  std::vector<value_type>* get_element_vector() const {
+  element_vector_type* get_element_vector() const {
     return m_ht.get_element_vector();
   }
 
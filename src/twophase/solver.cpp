@@ -0,0 +1,127 @@
+#include <emscripten/bind.h>
+#include <emscripten.h>
+#include <string>
+#include <vector>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
+#include "two_phase.h"
+
+using namespace twophase;
+
+struct twophase_search
+{
+	TwoPhaseTables tables;
+	std::mt19937 generator;
+	int max_length;
+	std::vector<unsigned char> blob;
+
+	twophase_search()
+	{
+		std::random_device rd;
+		generator.seed(rd());
+		max_length = 21;
+	}
+
+	void set_max_length(int length)
+	{
+		max_length = std::max(1, std::min(length, 30));
+	}
+
+	// Solution of the state the scramble leads to
+	std::string solve(std::string scramble)
+	{
+		tables.build_prune_tables();
+		State state;
+		for (int m : StringToAlg(scramble))
+		{
+			state = state.apply_move(moves[move_names[m]]);
+		}
+		std::vector<int> solution = TwoPhaseSearch(tables, max_length).solve(state);
+		return AlgToString(solution);
+	}
+
+	// Two-phase scramble reaching the same state as alg (e.g. a sampled F2L case)
+	std::string scramble(std::string alg)
+	{
+		tables.build_prune_tables();
+		State state;
+		for (int m : StringToAlg(alg))
+		{
+			state = state.apply_move(moves[move_names[m]]);
+		}
+		std::vector<int> solution = TwoPhaseSearch(tables, max_length).solve(state);
+		std::vector<int> inverse = AlgInverse(solution);
+		return AlgToString(inverse);
+	}
+
+	// count random-state scrambles, one per line. Native builds split the
+	// batch over the hardware threads.
+	std::string random_scrambles(int count)
+	{
+		tables.build_prune_tables();
+		count = std::max(count, 0);
+		std::vector<State> states;
+		for (int i = 0; i < count; ++i)
+		{
+			states.emplace_back(random_state(generator));
+		}
+		std::vector<std::string> scrambles(count);
+		auto work = [&](int begin, int step)
+		{
+			TwoPhaseSearch search(tables, max_length);
+			for (int i = begin; i < count; i += step)
+			{
+				std::vector<int> inverse = AlgInverse(search.solve(states[i]));
+				scrambles[i] = AlgToString(inverse);
+			}
+		};
+#ifdef __EMSCRIPTEN__
+		work(0, 1);
+#else
+		int threads = std::max(1, std::min(count, static_cast<int>(std::thread::hardware_concurrency())));
+		std::vector<std::thread> workers;
+		for (int i = 0; i < threads; ++i)
+		{
+			workers.emplace_back(work, i, threads);
+		}
+		for (std::thread &worker : workers)
+		{
+			worker.join();
+		}
+#endif
+		std::string ret;
+		for (const std::string &scramble : scrambles)
+		{
+			ret += scramble + "\n";
+		}
+		return ret;
+	}
+
+	// Prune tables for the page to keep (e.g. in IndexedDB)
+	emscripten::val prune_tables()
+	{
+		tables.build_prune_tables();
+		blob = tables.save();
+		return emscripten::val(emscripten::typed_memory_view(blob.size(), blob.data()));
+	}
+
+	// Tables saved by prune_tables(); false if the size does not match
+	bool load_prune_tables(emscripten::val data)
+	{
+		std::vector<unsigned char> loaded = emscripten::convertJSArrayToNumberVector<unsigned char>(data);
+		return tables.load(loaded);
+	}
+};
+
+EMSCRIPTEN_BINDINGS(my_module)
+{
+	emscripten::class_<twophase_search>("twophase_search")
+		.constructor<>()
+		.function("solve", &twophase_search::solve)
+		.function("scramble", &twophase_search::scramble)
+		.function("random_scrambles", &twophase_search::random_scrambles)
+		.function("set_max_length", &twophase_search::set_max_length)
+		.function("prune_tables", &twophase_search::prune_tables)
+		.function("load_prune_tables", &twophase_search::load_prune_tables);
+}
@@ -0,0 +1,762 @@
+#ifndef TWO_PHASE_H
+#define TWO_PHASE_H
+
+// =============================================================================
+// Two-Phase Solver
+// =============================================================================
+//
+// Kociemba's two-phase algorithm on the coordinates used by the other modules.
+//   Phase 1 (18 moves): corner twist (2187), edge flip (2048) and the positions
+//     of the four E-slice edges (11880, pruned on their 495 combinations).
+//   Phase 2 (U, D, L2, R2, F2, B2): corner permutation (40320), U/D edge
+//     permutation (40320) and E-slice edge permutation (24).
+// Move and prune tables are shared through the TableRegistry, so they are
+// built once per WASM instance. The prune tables can also be exported and
+// loaded back (prune_tables / load_prune_tables) to skip the build on the
+// next page load.
+//
+// This header holds the tables and the search, in namespace twophase, so that
+// other modules can turn random states into scrambles (random_state_scrambles,
+// used by the analyzers' analyze_random). solver.cpp adds the bindings.
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include <random>
+#include "../table_registry.h"
+#include "../move_sequence.h"
+
+namespace twophase
+{
+
+struct State
+{
+	std::vector<int> cp;
+	std::vector<int> co;
+	std::vector<int> ep;
+	std::vector<int> eo;
+
+	State(std::vector<int> arg_cp = {0, 1, 2, 3, 4, 5, 6, 7}, std::vector<int> arg_co = {0, 0, 0, 0, 0, 0, 0, 0}, std::vector<int> arg_ep = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, std::vector<int> arg_eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}) : cp(arg_cp), co(arg_co), ep(arg_ep), eo(arg_eo) {}
+
+	State apply_move(State move)
+	{
+		std::vector<int> new_cp;
+		std::vector<int> new_co;
+		std::vector<int> new_ep;
+		std::vector<int> new_eo;
+		for (int i = 0; i < 8; ++i)
+		{
+			int p = move.cp[i];
+			new_cp.emplace_back(cp[p]);
+			new_co.emplace_back((co[p] + move.co[i]) % 3);
+		}
+		for (int i = 0; i < 12; ++i)
+		{
+			int p = move.ep[i];
+			new_ep.emplace_back(ep[p]);
+			new_eo.emplace_back((eo[p] + move.eo[i]) % 2);
+		}
+		return State(new_cp, new_co, new_ep, new_eo);
+	}
+
+	State apply_move_edge(State move, int e)
+	{
+		std::vector<int> new_ep(12, -1);
+		std::vector<int> new_eo(12, -1);
+		auto it = std::find(ep.begin(), ep.end(), e);
+		int index = std::distance(ep.begin(), it);
+		it = std::find(move.ep.begin(), move.ep.end(), e);
+		int index_next = std::distance(move.ep.begin(), it);
+		new_ep[index_next] = e;
+		new_eo[index_next] = (eo[index] + move.eo[index_next]) % 2;
+		return State(cp, co, new_ep, new_eo);
+	}
+
+	State apply_move_corner(State move, int c)
+	{
+		std::vector<int> new_cp(8, -1);
+		std::vector<int> new_co(8, -1);
+		auto it = std::find(cp.begin(), cp.end(), c);
+		int index = std::distance(cp.begin(), it);
+		it = std::find(move.cp.begin(), move.cp.end(), c);
+		int index_next = std::distance(move.cp.begin(), it);
+		new_cp[index_next] = c;
+		new_co[index_next] = (co[index] + move.co[index_next]) % 3;
+		return State(new_cp, new_co, ep, eo);
+	}
+};
+
+std::unordered_map<std::string, State> moves = {
+	{"U", State({3, 0, 1, 2, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 7, 4, 5, 6, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"U2", State({2, 3, 0, 1, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 6, 7, 4, 5, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"U'", State({1, 2, 3, 0, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 5, 6, 7, 4, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"D", State({0, 1, 2, 3, 5, 6, 7, 4}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 8}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"D2", State({0, 1, 2, 3, 6, 7, 4, 5}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 8, 9}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"D'", State({0, 1, 2, 3, 7, 4, 5, 6}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 4, 5, 6, 7, 11, 8, 9, 10}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"L", State({4, 1, 2, 0, 7, 5, 6, 3}, {2, 0, 0, 1, 1, 0, 0, 2}, {11, 1, 2, 7, 4, 5, 6, 0, 8, 9, 10, 3}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"L2", State({7, 1, 2, 4, 3, 5, 6, 0}, {0, 0, 0, 0, 0, 0, 0, 0}, {3, 1, 2, 0, 4, 5, 6, 11, 8, 9, 10, 7}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"L'", State({3, 1, 2, 7, 0, 5, 6, 4}, {2, 0, 0, 1, 1, 0, 0, 2}, {7, 1, 2, 11, 4, 5, 6, 3, 8, 9, 10, 0}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"R", State({0, 2, 6, 3, 4, 1, 5, 7}, {0, 1, 2, 0, 0, 2, 1, 0}, {0, 5, 9, 3, 4, 2, 6, 7, 8, 1, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"R2", State({0, 6, 5, 3, 4, 2, 1, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 2, 1, 3, 4, 9, 6, 7, 8, 5, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"R'", State({0, 5, 1, 3, 4, 6, 2, 7}, {0, 1, 2, 0, 0, 2, 1, 0}, {0, 9, 5, 3, 4, 1, 6, 7, 8, 2, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"F", State({0, 1, 3, 7, 4, 5, 2, 6}, {0, 0, 1, 2, 0, 0, 2, 1}, {0, 1, 6, 10, 4, 5, 3, 7, 8, 9, 2, 11}, {0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 1, 0})},
+	{"F2", State({0, 1, 7, 6, 4, 5, 3, 2}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 3, 2, 4, 5, 10, 7, 8, 9, 6, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"F'", State({0, 1, 6, 2, 4, 5, 7, 3}, {0, 0, 1, 2, 0, 0, 2, 1}, {0, 1, 10, 6, 4, 5, 2, 7, 8, 9, 3, 11}, {0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 1, 0})},
+	{"B", State({1, 5, 2, 3, 0, 4, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {4, 8, 2, 3, 1, 5, 6, 7, 0, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})},
+	{"B2", State({5, 4, 2, 3, 1, 0, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {1, 0, 2, 3, 8, 5, 6, 7, 4, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})},
+	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
+
+std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
+
+std::vector<int> inv_move = {2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 17, 16, 15};
+
+// Moves of phase 2, in the order of the phase 2 move tables
+std::vector<int> phase2_moves = {0, 1, 2, 3, 4, 5, 7, 10, 13, 16};
+
+std::string AlgToString(std::vector<int> &alg)
+{
+	return move_codec.format(alg);
+}
+
+std::vector<int> StringToAlg(std::string str)
+{
+	return move_codec.parse(str);
+}
+
+std::vector<std::vector<int>> c_array = {{0}, {1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 2, 4, 8, 16, 32}, {1, 3, 9, 27, 81, 243}};
+
+std::vector<std::vector<int>> base_array = {{0}, {0}, {1, 12, 12 * 11, 12 * 11 * 10, 12 * 11 * 10 * 9}, {1, 8, 8 * 7, 8 * 7 * 6, 8 * 7 * 6 * 5, 8 * 7 * 6 * 5 * 4, 8 * 7 * 6 * 5 * 4 * 3, 8 * 7 * 6 * 5 * 4 * 3 * 2}, {0}, {0}, {1, 4, 4 * 3, 4 * 3 * 2}};
+
+inline int array_to_index(std::vector<int> &a, int n, int c, int pn)
+{
+	int index_p = 0;
+	int index_o = 0;
+	int tmp;
+	int tmp2 = 24 / pn;
+	for (int i = 0; i < n; ++i)
+	{
+		index_o += (a[i] % c) * c_array[c][n - i - 1];
+		a[i] /= c;
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		tmp = 0;
+		for (int j = 0; j < i; ++j)
+		{
+			if (a[j] < a[i])
+			{
+				tmp++;
+			}
+		}
+		index_p += (a[i] - tmp) * base_array[tmp2][i];
+	}
+	return index_p * c_array[c][n] + index_o;
+}
+
+std::vector<std::vector<int>> base_array2 = {{0}, {0}, {12, 11, 10, 9, 8}, {8, 7, 6, 5, 4, 3, 2, 1}, {0}, {0}, {4, 3, 2, 1}};
+
+inline void index_to_array(std::vector<int> &p, int index, int n, int c, int pn)
+{
+	int sorted[8];
+	int tmp2 = 24 / pn;
+	int p_index = index / c_array[c][n];
+	int o_index = index % c_array[c][n];
+	for (int i = 0; i < n; ++i)
+	{
+		p[i] = p_index % base_array2[tmp2][i];
+		p_index /= base_array2[tmp2][i];
+		std::sort(sorted, sorted + i);
+		for (int j = 0; j < i; ++j)
+		{
+			if (sorted[j] <= p[i])
+			{
+				p[i] += 1;
+			}
+		}
+		sorted[i] = p[i];
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		p[n - i - 1] = 18 * (c * p[n - i - 1] + o_index % c);
+		o_index /= c;
+	}
+}
+
+std::vector<std::vector<int>> c_array2 = {{0}, {0}, {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048}, {1, 3, 9, 27, 81, 243, 729, 2187}};
+
+inline int o_to_index(std::vector<int> &o, int c, int pn)
+{
+	int o_index = 0;
+	for (int i = 0; i < pn - 1; ++i)
+	{
+		o_index += o[i] * c_array2[c][pn - i - 2];
+	}
+	return o_index;
+}
+
+inline void index_to_o(std::vector<int> &o, int index, int c, int pn)
+{
+	int count = 0;
+	for (int i = 0; i < pn - 1; ++i)
+	{
+		o[pn - i - 2] = index % c;
+		count += o[pn - i - 2];
+		index /= c;
+	}
+	o[pn - 1] = (c - count % c) % c;
+}
+
+// New position of the edge at each position (12 * 18)
+std::vector<int> create_ep_move_table()
+{
+	std::vector<int> move_table(12 * 18, -1);
+	for (int i = 0; i < 12; ++i)
+	{
+		std::vector<int> ep(12, -1);
+		std::vector<int> eo(12, 0);
+		std::vector<int> cp(8, 0);
+		std::vector<int> co(8, 0);
+		ep[i] = i;
+		State state(cp, co, ep, eo);
+		for (int j = 0; j < 18; ++j)
+		{
+			State new_state = state.apply_move_edge(moves[move_names[j]], i);
+			auto it = std::find(new_state.ep.begin(), new_state.ep.end(), i);
+			move_table[18 * i + j] = std::distance(new_state.ep.begin(), it);
+		}
+	}
+	return move_table;
+}
+
+// New position of the corner at each position (8 * 18)
+std::vector<int> create_cp_move_table()
+{
+	std::vector<int> move_table(8 * 18, -1);
+	for (int i = 0; i < 8; ++i)
+	{
+		std::vector<int> ep(12, 0);
+		std::vector<int> eo(12, 0);
+		std::vector<int> cp(8, -1);
+		std::vector<int> co(8, 0);
+		cp[i] = i;
+		State state(cp, co, ep, eo);
+		for (int j = 0; j < 18; ++j)
+		{
+			State new_state = state.apply_move_corner(moves[move_names[j]], i);
+			auto it = std::find(new_state.cp.begin(), new_state.cp.end(), i);
+			move_table[18 * i + j] = std::distance(new_state.cp.begin(), it);
+		}
+	}
+	return move_table;
+}
+
+// U/D layer edges renumbered 4..11 -> 0..7; only the phase 2 moves keep them
+// in the layers (-1 for the others)
+std::vector<int> create_ud_edge_move_table(const std::vector<int> &ep_move_table)
+{
+	std::vector<int> move_table(8 * 18, -1);
+	for (int i = 0; i < 8; ++i)
+	{
+		for (int j : phase2_moves)
+		{
+			move_table[18 * i + j] = ep_move_table[18 * (i + 4) + j] - 4;
+		}
+	}
+	return move_table;
+}
+
+std::vector<int> create_co_move_table()
+{
+	std::vector<int> move_table(2187 * 18, 0);
+	for (int i = 0; i < 2187; ++i)
+	{
+		std::vector<int> co(8, 0);
+		index_to_o(co, i, 3, 8);
+		State state({0, 1, 2, 3, 4, 5, 6, 7}, co);
+		for (int j = 0; j < 18; ++j)
+		{
+			State new_state = state.apply_move(moves[move_names[j]]);
+			move_table[18 * i + j] = o_to_index(new_state.co, 3, 8);
+		}
+	}
+	return move_table;
+}
+
+std::vector<int> create_eo_move_table()
+{
+	std::vector<int> move_table(2048 * 18, 0);
+	for (int i = 0; i < 2048; ++i)
+	{
+		std::vector<int> eo(12, 0);
+		index_to_o(eo, i, 2, 12);
+		State state({0, 1, 2, 3, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, eo);
+		for (int j = 0; j < 18; ++j)
+		{
+			State new_state = state.apply_move(moves[move_names[j]]);
+			move_table[18 * i + j] = o_to_index(new_state.eo, 2, 12);
+		}
+	}
+	return move_table;
+}
+
+std::vector<int> create_multi_move_table(int n, int c, int pn, int size, const std::vector<int> &table)
+{
+	std::vector<int> move_table(size * 18, -1);
+	int tmp;
+	int tmp_i;
+	std::vector<int> a(n);
+	std::vector<int> b(n);
+	for (int i = 0; i < size; ++i)
+	{
+		index_to_array(a, i, n, c, pn);
+		tmp_i = i * 18;
+		for (int j = 0; j < 18; ++j)
+		{
+			if (move_table[tmp_i + j] == -1)
+			{
+				for (int k = 0; k < n; ++k)
+				{
+					b[k] = table[a[k] + j];
+				}
+				tmp = array_to_index(b, n, c, pn);
+				move_table[tmp_i + j] = tmp;
+				move_table[18 * tmp + inv_move[j]] = i;
+			}
+		}
+	}
+	return move_table;
+}
+
+// Same as create_multi_move_table over the phase 2 moves only (size * 10)
+std::vector<int> create_phase2_move_table(int n, int pn, int size, const std::vector<int> &table)
+{
+	std::vector<int> move_table(size * 10, -1);
+	std::vector<int> a(n);
+	std::vector<int> b(n);
+	for (int i = 0; i < size; ++i)
+	{
+		index_to_array(a, i, n, 1, pn);
+		for (int j = 0; j < 10; ++j)
+		{
+			for (int k = 0; k < n; ++k)
+			{
+				b[k] = table[a[k] + phase2_moves[j]];
+			}
+			move_table[i * 10 + j] = array_to_index(b, n, 1, pn);
+		}
+	}
+	return move_table;
+}
+
+// Rank (0-494) of the set of E-slice edge positions for each slice index
+// (11880); the solved set {0, 1, 2, 3} has rank 0
+std::vector<int> create_slice_comb_table()
+{
+	std::vector<int> comb_rank(4096, -1);
+	int rank = 0;
+	for (int mask = 0; mask < 4096; ++mask)
+	{
+		if (__builtin_popcount(mask) == 4)
+		{
+			comb_rank[mask] = rank++;
+		}
+	}
+	std::vector<int> table(11880, 0);
+	std::vector<int> a(4);
+	for (int i = 0; i < 11880; ++i)
+	{
+		index_to_array(a, i, 4, 1, 12);
+		int mask = 0;
+		for (int k = 0; k < 4; ++k)
+		{
+			mask |= 1 << (a[k] / 18);
+		}
+		table[i] = comb_rank[mask];
+	}
+	return table;
+}
+
+// Move table of the 495 slice combinations
+std::vector<int> create_comb_move_table(const std::vector<int> &slice_move_table, const std::vector<int> &slice_comb)
+{
+	std::vector<int> move_table(495 * 18, -1);
+	for (int i = 0; i < 11880; ++i)
+	{
+		int comb = slice_comb[i];
+		if (move_table[18 * comb] != -1)
+		{
+			continue;
+		}
+		for (int j = 0; j < 18; ++j)
+		{
+			move_table[18 * comb + j] = slice_comb[slice_move_table[18 * i + j]];
+		}
+	}
+	return move_table;
+}
+
+// Distance of every (index1, index2) pair from (0, 0); both move tables are
+// indexed [index * move_count + move]
+std::vector<unsigned char> create_prune_table(int size1, int size2, int move_count, const std::vector<int> &table1, const std::vector<int> &table2)
+{
+	int size = size1 * size2;
+	std::vector<unsigned char> prune_table(size, 255);
+	int next_i;
+	int index1_tmp;
+	int index2_tmp;
+	int next_d;
+	int found = 1;
+	prune_table[0] = 0;
+	for (int d = 0; found > 0; ++d)
+	{
+		found = 0;
+		next_d = d + 1;
+		for (int i = 0; i < size; ++i)
+		{
+			if (prune_table[i] == d)
+			{
+				index1_tmp = (i / size2) * move_count;
+				index2_tmp = (i % size2) * move_count;
+				for (int j = 0; j < move_count; ++j)
+				{
+					next_i = table1[index1_tmp + j] * size2 + table2[index2_tmp + j];
+					if (prune_table[next_i] == 255)
+					{
+						prune_table[next_i] = next_d;
+						found++;
+					}
+				}
+			}
+		}
+	}
+	return prune_table;
+}
+
+struct TwoPhaseTables
+{
+	TableRef<int> co_move_table;
+	TableRef<int> eo_move_table;
+	TableRef<int> slice_move_table;
+	TableRef<int> slice_comb;
+	TableRef<int> corner_move_table;
+	TableRef<int> cp_move_table;
+	TableRef<int> ud_move_table;
+	TableRef<int> sp_move_table;
+	std::vector<unsigned char> co_prune_table;
+	std::vector<unsigned char> eo_prune_table;
+	std::vector<unsigned char> cp_prune_table;
+	std::vector<unsigned char> ud_prune_table;
+
+	TwoPhaseTables()
+	{
+		TableRef<int> ep_table = shared_table<int>("twophase/ep_move_table", create_ep_move_table);
+		TableRef<int> cp_table = shared_table<int>("twophase/cp_move_table", create_cp_move_table);
+		co_move_table = shared_table<int>("twophase/co_move_table", create_co_move_table);
+		eo_move_table = shared_table<int>("twophase/eo_move_table", create_eo_move_table);
+		slice_move_table = shared_table<int>("twophase/slice_move_table", [&]
+											 { return create_multi_move_table(4, 1, 12, 11880, ep_table); });
+		slice_comb = shared_table<int>("twophase/slice_comb", create_slice_comb_table);
+		corner_move_table = shared_table<int>("twophase/corner_move_table", [&]
+											  { return create_multi_move_table(8, 1, 8, 40320, cp_table); });
+		cp_move_table = shared_table<int>("twophase/phase2_cp_move_table", [&]
+										  { return create_phase2_move_table(8, 8, 40320, cp_table); });
+		ud_move_table = shared_table<int>("twophase/phase2_ud_move_table", [&]
+										  { return create_phase2_move_table(8, 8, 40320, create_ud_edge_move_table(ep_table)); });
+		sp_move_table = shared_table<int>("twophase/phase2_sp_move_table", [&]
+										  { return create_phase2_move_table(4, 4, 24, ep_table); });
+	}
+
+	// Builds the prune tables unless load() already filled them
+	void build_prune_tables()
+	{
+		if (!co_prune_table.empty())
+		{
+			return;
+		}
+		std::vector<int> comb_move_table = create_comb_move_table(slice_move_table, slice_comb);
+		co_prune_table = create_prune_table(495, 2187, 18, comb_move_table, co_move_table);
+		eo_prune_table = create_prune_table(495, 2048, 18, comb_move_table, eo_move_table);
+		cp_prune_table = create_prune_table(40320, 24, 10, cp_move_table, sp_move_table);
+		ud_prune_table = create_prune_table(40320, 24, 10, ud_move_table, sp_move_table);
+	}
+
+	// The four prune tables back to back, for the page to store
+	std::vector<unsigned char> save() const
+	{
+		std::vector<unsigned char> blob;
+		for (const std::vector<unsigned char> *table : {&co_prune_table, &eo_prune_table, &cp_prune_table, &ud_prune_table})
+		{
+			blob.insert(blob.end(), table->begin(), table->end());
+		}
+		return blob;
+	}
+
+	static size_t blob_size()
+	{
+		return 495 * 2187 + 495 * 2048 + 2 * 40320 * 24;
+	}
+
+	bool load(const std::vector<unsigned char> &blob)
+	{
+		if (blob.size() != blob_size())
+		{
+			return false;
+		}
+		auto it = blob.begin();
+		for (std::pair<std::vector<unsigned char> *, size_t> table : {std::make_pair(&co_prune_table, (size_t)495 * 2187), std::make_pair(&eo_prune_table, (size_t)495 * 2048), std::make_pair(&cp_prune_table, (size_t)40320 * 24), std::make_pair(&ud_prune_table, (size_t)40320 * 24)})
+		{
+			table.first->assign(it, it + table.second);
+			it += table.second;
+		}
+		return true;
+	}
+};
+
+// One search at a time; the batch runs one per thread over the same tables
+struct TwoPhaseSearch
+{
+	const TwoPhaseTables &t;
+	int max_length;
+	int start_cp;
+	int start_u_edges;
+	int start_d_edges;
+	int start_slice;
+	std::vector<int> sol1;
+	std::vector<int> sol2;
+	int length1;
+
+	TwoPhaseSearch(const TwoPhaseTables &tables, int arg_max_length) : t(tables), max_length(arg_max_length), sol1(max_length + 1), sol2(max_length + 1), length1(0) {}
+
+	// Same face twice, or the second face of an opposite pair first
+	static bool redundant(int prev, int move)
+	{
+		if (prev < 0)
+		{
+			return false;
+		}
+		int face = move / 3;
+		int prev_face = prev / 3;
+		return face == prev_face || (prev_face % 2 == 1 && face == prev_face - 1);
+	}
+
+	bool phase2(int cp, int ud, int sp, int depth, int prev)
+	{
+		if (depth == 0)
+		{
+			return cp == 0 && ud == 0 && sp == 0;
+		}
+		for (int j = 0; j < 10; ++j)
+		{
+			int move = phase2_moves[j];
+			if (redundant(prev, move))
+			{
+				continue;
+			}
+			int next_cp = t.cp_move_table[cp * 10 + j];
+			int next_ud = t.ud_move_table[ud * 10 + j];
+			int next_sp = t.sp_move_table[sp * 10 + j];
+			if (t.cp_prune_table[next_cp * 24 + next_sp] >= depth || t.ud_prune_table[next_ud * 24 + next_sp] >= depth)
+			{
+				continue;
+			}
+			sol2[sol2.size() - depth] = move;
+			if (phase2(next_cp, next_ud, next_sp, depth - 1, move))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Phase 2 from the state reached by sol1[0..length1). The U and D layer
+	// edges are followed like the slice edges, four at a time.
+	bool start_phase2()
+	{
+		int cp = start_cp;
+		int u_edges = start_u_edges;
+		int d_edges = start_d_edges;
+		int slice = start_slice;
+		for (int i = 0; i < length1; ++i)
+		{
+			cp = t.corner_move_table[cp * 18 + sol1[i]];
+			u_edges = t.slice_move_table[u_edges * 18 + sol1[i]];
+			d_edges = t.slice_move_table[d_edges * 18 + sol1[i]];
+			slice = t.slice_move_table[slice * 18 + sol1[i]];
+		}
+		std::vector<int> ud_edges(8);
+		std::vector<int> slice_edges(4);
+		index_to_array(ud_edges, u_edges, 4, 1, 12);
+		index_to_array(slice_edges, d_edges, 4, 1, 12);
+		for (int i = 0; i < 4; ++i)
+		{
+			ud_edges[i] = ud_edges[i] / 18 - 4;
+			ud_edges[i + 4] = slice_edges[i] / 18 - 4;
+		}
+		index_to_array(slice_edges, slice, 4, 1, 12);
+		for (int i = 0; i < 4; ++i)
+		{
+			slice_edges[i] /= 18;
+		}
+		int ud = array_to_index(ud_edges, 8, 1, 8);
+		int sp = array_to_index(slice_edges, 4, 1, 4);
+		int prev = length1 > 0 ? sol1[length1 - 1] : -1;
+		int lower = std::max(t.cp_prune_table[cp * 24 + sp], t.ud_prune_table[ud * 24 + sp]);
+		for (int d = lower; d <= max_length - length1; ++d)
+		{
+			sol2.assign(d, -1);
+			if (phase2(cp, ud, sp, d, prev))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool phase1(int co, int eo, int slice, int depth, int prev)
+	{
+		if (depth == 0)
+		{
+			// A phase 1 solution ending in a phase 2 move was already tried shorter
+			if (co != 0 || eo != 0 || t.slice_comb[slice] != 0)
+			{
+				return false;
+			}
+			if (prev >= 0 && std::find(phase2_moves.begin(), phase2_moves.end(), prev) != phase2_moves.end())
+			{
+				return false;
+			}
+			return start_phase2();
+		}
+		for (int j = 0; j < 18; ++j)
+		{
+			if (redundant(prev, j))
+			{
+				continue;
+			}
+			int next_slice = t.slice_move_table[slice * 18 + j];
+			int comb = t.slice_comb[next_slice];
+			int next_co = t.co_move_table[co * 18 + j];
+			if (t.co_prune_table[comb * 2187 + next_co] >= depth)
+			{
+				continue;
+			}
+			int next_eo = t.eo_move_table[eo * 18 + j];
+			if (t.eo_prune_table[comb * 2048 + next_eo] >= depth)
+			{
+				continue;
+			}
+			sol1[length1 - depth] = j;
+			if (phase1(next_co, next_eo, next_slice, depth - 1, j))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Solution of at most max_length moves, empty if none was found
+	std::vector<int> solve(State state)
+	{
+		std::vector<int> corners(8);
+		std::vector<int> edges(12);
+		for (int i = 0; i < 8; ++i)
+		{
+			corners[state.cp[i]] = i;
+		}
+		for (int i = 0; i < 12; ++i)
+		{
+			edges[state.ep[i]] = i;
+		}
+		std::vector<int> slice_edges(edges.begin(), edges.begin() + 4);
+		std::vector<int> u_edges(edges.begin() + 4, edges.begin() + 8);
+		std::vector<int> d_edges(edges.begin() + 8, edges.end());
+		start_cp = array_to_index(corners, 8, 1, 8);
+		start_u_edges = array_to_index(u_edges, 4, 1, 12);
+		start_d_edges = array_to_index(d_edges, 4, 1, 12);
+		start_slice = array_to_index(slice_edges, 4, 1, 12);
+		int slice = start_slice;
+		int co = o_to_index(state.co, 3, 8);
+		int eo = o_to_index(state.eo, 2, 12);
+		int comb = t.slice_comb[slice];
+		int lower = std::max(t.co_prune_table[comb * 2187 + co], t.eo_prune_table[comb * 2048 + eo]);
+		for (length1 = lower; length1 <= max_length; ++length1)
+		{
+			if (phase1(co, eo, slice, length1, -1))
+			{
+				std::vector<int> solution(sol1.begin(), sol1.begin() + length1);
+				solution.insert(solution.end(), sol2.begin(), sol2.end());
+				return solution;
+			}
+		}
+		return {};
+	}
+};
+
+State random_state(std::mt19937 &generator)
+{
+	State state;
+	std::shuffle(state.cp.begin(), state.cp.end(), generator);
+	std::shuffle(state.ep.begin(), state.ep.end(), generator);
+	int parity = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		for (int j = i + 1; j < 8; ++j)
+		{
+			parity ^= state.cp[i] > state.cp[j];
+		}
+	}
+	for (int i = 0; i < 12; ++i)
+	{
+		for (int j = i + 1; j < 12; ++j)
+		{
+			parity ^= state.ep[i] > state.ep[j];
+		}
+	}
+	if (parity)
+	{
+		std::swap(state.ep[10], state.ep[11]);
+	}
+	std::uniform_int_distribution<int> co_distribution(0, 2186);
+	std::uniform_int_distribution<int> eo_distribution(0, 2047);
+	index_to_o(state.co, co_distribution(generator), 3, 8);
+	index_to_o(state.eo, eo_distribution(generator), 2, 12);
+	return state;
+}
+
+std::vector<int> AlgInverse(const std::vector<int> &alg)
+{
+	std::vector<int> ret;
+	for (auto it = alg.rbegin(); it != alg.rend(); ++it)
+	{
+		ret.emplace_back(inv_move[*it]);
+	}
+	return ret;
+}
+
+// count random-state scrambles from seed, one per line: uniform corner and
+// edge permutations of equal parity and uniform twist and flip, each solved
+// two-phase and inverted. The prune tables (about 4 MB) live only for the
+// call; the move tables stay in the TableRegistry.
+inline std::string random_state_scrambles(int seed, int count, int max_length = 21)
+{
+	TwoPhaseTables tables;
+	tables.build_prune_tables();
+	TwoPhaseSearch search(tables, max_length);
+	std::mt19937 generator(seed);
+	std::string ret;
+	for (int i = 0; i < count; ++i)
+	{
+		std::vector<int> inverse = AlgInverse(search.solve(random_state(generator)));
+		ret += AlgToString(inverse) + "\n";
+	}
+	return ret;
+}
+
+} // namespace twophase
+
+#endif // TWO_PHASE_H
@@ -0,0 +1,30 @@
+let twophaseSearchInstance;
+const initPromise = new Promise((resolve, reject) => {
+	self.Module = {
+		onRuntimeInitialized: () => {
+			try {
+				twophaseSearchInstance = new self.Module.twophase_search();
+				resolve();
+			} catch (e) {
+				reject("Error");
+			}
+		}
+	};
+});
+
+importScripts('solver.js');
+
+// { count }: count random-state scrambles, one per line
+// { alg }: scramble reaching the same state as alg
+self.onmessage = async function (event) {
+	const { count, alg } = event.data;
+	try {
+		await initPromise;
+		if (twophaseSearchInstance) {
+			const ret = alg !== undefined ? twophaseSearchInstance.scramble(alg) : twophaseSearchInstance.random_scrambles(count || 1);
+			self.postMessage(ret);
+		}
+	} catch (e) {
+		self.postMessage("Error");
+	}
+};
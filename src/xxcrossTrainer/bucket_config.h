@@ -6,6 +6,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "calibration_table.h"
+
 // =============================================================================
 // Bucket Model Enumeration
 // =============================================================================
@@ -44,15 +46,26 @@ struct ModelData {
     size_t measured_rss_mb;      // Peak RSS in MB (no margin)
     size_t total_nodes_million;  // Total nodes explored (debugging)
     double load_d7, load_d8, load_d9;  // Load factors (debugging)
+    size_t d10;                  // Depth 10 bucket (0 = depth 10 disabled)
     
     ModelData() : d7(0), d8(0), d9(0), measured_rss_mb(0), 
-                  total_nodes_million(0), load_d7(0), load_d8(0), load_d9(0) {}
+                  total_nodes_million(0), load_d7(0), load_d8(0), load_d9(0), d10(0) {}
     
     ModelData(size_t bucket7, size_t bucket8, size_t bucket9,
-              size_t rss, size_t nodes, double ld7, double ld8, double ld9)
+              size_t rss, size_t nodes, double ld7, double ld8, double ld9,
+              size_t bucket10 = 0)
         : d7(bucket7), d8(bucket8), d9(bucket9)
         , measured_rss_mb(rss), total_nodes_million(nodes)
-        , load_d7(ld7), load_d8(ld8), load_d9(ld9) {}
+        , load_d7(ld7), load_d8(ld8), load_d9(ld9), d10(bucket10) {}
+    
+    // Overwrite measurements with a calibration record (buckets must match)
+    void apply(const CalibrationRecord& r) {
+        measured_rss_mb = r.peak_rss_mb;
+        total_nodes_million = (r.total_nodes() + 500000) / 1000000;
+        load_d7 = r.load_d7;
+        load_d8 = r.load_d8;
+        load_d9 = r.load_d9;
+    }
 };
 
 // =============================================================================
@@ -98,6 +111,10 @@ struct ResearchConfig {
     
     // Allocator cache control (for WASM-equivalent measurements on native)
     bool disable_malloc_trim = false;         // true = skip malloc_trim() for WASM-equivalent RSS measurement
+    bool use_node_arena = true;               // true = NodeSet/NodeVector storage from NodeArena (node_arena.h)
+    
+    // Symmetry reduction
+    bool enable_mirror_reduction = true;      // true = store one node per L/R mirror pair (adjacent slots only)
     
     // Developer convenience options
     bool skip_search = false;                 // true = exit after database construction (measurement only)
@@ -105,17 +122,17 @@ struct ResearchConfig {
 };
 
 // =============================================================================
-// Measured Data Table (Initially Empty - To Be Filled After Spike Fixes)
+// Measured Data Table
 // =============================================================================
 
-// Note: This table will be populated after memory spike elimination is complete.
-// Currently all values are placeholders (0). Developers should run measurement
-// tests to fill in actual RSS data.
+// Bucket sizes per model. Measurements are filled from CalibrationTable
+// (calibration_data.h + runtime-loaded JSON) for the current platform and
+// mirror mode (ResearchConfig::enable_mirror_reduction); entries without a
+// calibration record keep the values below (0 = not measured).
 
-inline const std::unordered_map<BucketModel, ModelData>& get_measured_data() {
+inline const std::unordered_map<BucketModel, ModelData>& get_base_model_data() {
     static const std::unordered_map<BucketModel, ModelData> MEASURED_DATA = {
-        // Preset models (7 variants) - PLACEHOLDER VALUES
-        // TODO: Measure actual RSS after spike fixes
+        // Preset models (7 variants) - measurements come from calibration
         {BucketModel::MINIMAL,    ModelData(2<<20, 4<<20, 4<<20,   0, 0, 0.0, 0.0, 0.0)},
         {BucketModel::LOW,        ModelData(4<<20, 4<<20, 4<<20,   0, 0, 0.0, 0.0, 0.0)},
         {BucketModel::BALANCED,   ModelData(4<<20, 8<<20, 8<<20,   0, 0, 0.0, 0.0, 0.0)},
@@ -125,42 +142,84 @@ inline const std::unordered_map<BucketModel, ModelData>& get_measured_data() {
         
         // WASM Tier Models (depth 10 enabled, measured 2026-01-03)
         // Format: d7/d8/d9/d10, single_heap_mb, dual_heap_mb (2x), total_nodes
-        {BucketModel::WASM_MOBILE_LOW,    ModelData(1<<20, 1<<20, 2<<20,   309, 12, 0.90, 0.90, 0.90)},
-        {BucketModel::WASM_MOBILE_MIDDLE, ModelData(2<<20, 4<<20, 4<<20,   448, 18, 0.90, 0.90, 0.90)},
-        {BucketModel::WASM_MOBILE_HIGH,   ModelData(4<<20, 4<<20, 4<<20,   535, 20, 0.90, 0.90, 0.90)},
-        {BucketModel::WASM_DESKTOP_STD,   ModelData(8<<20, 8<<20, 8<<20,   756, 35, 0.90, 0.90, 0.90)},
-        {BucketModel::WASM_DESKTOP_HIGH,  ModelData(8<<20, 16<<20, 16<<20, 1393, 57, 0.90, 0.90, 0.90)},
-        {BucketModel::WASM_DESKTOP_ULTRA, ModelData(16<<20, 16<<20, 16<<20, 1442, 65, 0.90, 0.90, 0.90)},
+        {BucketModel::WASM_MOBILE_LOW,    ModelData(1<<20, 1<<20, 2<<20,   309, 12, 0.90, 0.90, 0.90, 4<<20)},
+        {BucketModel::WASM_MOBILE_MIDDLE, ModelData(2<<20, 4<<20, 4<<20,   448, 18, 0.90, 0.90, 0.90, 4<<20)},
+        {BucketModel::WASM_MOBILE_HIGH,   ModelData(4<<20, 4<<20, 4<<20,   535, 20, 0.90, 0.90, 0.90, 4<<20)},
+        {BucketModel::WASM_DESKTOP_STD,   ModelData(8<<20, 8<<20, 8<<20,   756, 35, 0.90, 0.90, 0.90, 8<<20)},
+        {BucketModel::WASM_DESKTOP_HIGH,  ModelData(8<<20, 16<<20, 16<<20, 1393, 57, 0.90, 0.90, 0.90, 16<<20)},
+        {BucketModel::WASM_DESKTOP_ULTRA, ModelData(16<<20, 16<<20, 16<<20, 1442, 65, 0.90, 0.90, 0.90, 16<<20)},
         
         // ULTRA_HIGH: Different for WASM vs Native (handled by get_ultra_high_config)
     };
     return MEASURED_DATA;
 }
 
+// Base table with the calibration records of one mirror mode applied (rebuilt
+// when the table changes)
+inline const std::unordered_map<BucketModel, ModelData>& get_measured_data(bool mirrored) {
+    static std::unordered_map<BucketModel, ModelData> data[2];
+    static size_t applied_version[2] = {0, 0};
+    
+    const CalibrationTable& table = CalibrationTable::instance();
+    const int mode = mirrored ? 1 : 0;
+    if (applied_version[mode] != table.version()) {
+        data[mode] = get_base_model_data();
+        for (auto& entry : data[mode]) {
+            ModelData& m = entry.second;
+            const CalibrationRecord* r = table.find(m.d7, m.d8, m.d9, m.d10, mirrored);
+            if (r != nullptr) {
+                m.apply(*r);
+            }
+        }
+        applied_version[mode] = table.version();
+    }
+    return data[mode];
+}
+
 // ULTRA_HIGH model uses runtime environment detection
-inline ModelData get_ultra_high_config() {
+inline ModelData get_ultra_high_config(bool mirrored) {
     #ifdef __EMSCRIPTEN__
-        return ModelData(32<<20, 32<<20, 32<<20, 0, 0, 0.0, 0.0, 0.0);  // WASM safe (placeholder)
+        ModelData m(32<<20, 32<<20, 32<<20, 0, 0, 0.0, 0.0, 0.0);  // WASM safe
     #else
-        return ModelData(32<<20, 64<<20, 64<<20, 0, 0, 0.0, 0.0, 0.0);  // Native high-capacity (placeholder)
+        ModelData m(32<<20, 64<<20, 64<<20, 0, 0, 0.0, 0.0, 0.0);  // Native high-capacity
     #endif
+    const CalibrationRecord* r = CalibrationTable::instance().find(m.d7, m.d8, m.d9, m.d10, mirrored);
+    if (r != nullptr) {
+        m.apply(*r);
+    }
+    return m;
 }
 
 // =============================================================================
 // Model Selection Functions
 // =============================================================================
 
-inline BucketModel select_model(size_t budget_mb) {
-    // TODO: Implement proper selection logic after measurements are complete
-    // For now, return a safe default
+inline BucketModel select_model(size_t budget_mb, bool mirrored) {
+    // Select largest model whose peak RSS fits the budget. Calibrated peak RSS
+    // (see CalibrationTable, same mirror mode) is used when available,
+    // otherwise the estimate.
+    struct Candidate { BucketModel model; size_t estimated_rss_mb; };
+    const Candidate candidates[] = {
+    #ifdef __EMSCRIPTEN__
+        {BucketModel::ULTRA_HIGH, 1100},  // WASM: 32M/32M/32M
+    #else
+        {BucketModel::ULTRA_HIGH, 1850},  // Native: 32M/64M/64M
+    #endif
+        {BucketModel::HIGH,        980},
+        {BucketModel::STANDARD,    540},
+        {BucketModel::MEDIUM,      440},
+        {BucketModel::BALANCED,    290},  // Default
+        {BucketModel::LOW,         190},
+    };
     
-    // Select largest model ≤ budget (same for WASM and Native, except ULTRA_HIGH)
-    if (budget_mb >= 1100) return BucketModel::ULTRA_HIGH;  // WASM: 1100 MB, Native: 1850 MB
-    if (budget_mb >= 980)  return BucketModel::HIGH;        // 980 MB
-    if (budget_mb >= 540)  return BucketModel::STANDARD;    // 540 MB
-    if (budget_mb >= 440)  return BucketModel::MEDIUM;      // 440 MB
-    if (budget_mb >= 290)  return BucketModel::BALANCED;    // 290 MB (default)
-    if (budget_mb >= 190)  return BucketModel::LOW;         // 190 MB
+    const auto& measured = get_measured_data(mirrored);
+    for (const Candidate& c : candidates) {
+        size_t rss_mb = (c.model == BucketModel::ULTRA_HIGH)
+                      ? get_ultra_high_config(mirrored).measured_rss_mb
+                      : measured.at(c.model).measured_rss_mb;
+        if (rss_mb == 0) rss_mb = c.estimated_rss_mb;
+        if (rss_mb <= budget_mb) return c.model;
+    }
     return BucketModel::MINIMAL;  // 145 MB (minimum)
 }
 
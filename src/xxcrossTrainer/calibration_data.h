@@ -0,0 +1,83 @@
+#ifndef CALIBRATION_DATA_H
+#define CALIBRATION_DATA_H
+
+// Generated by solver_dev calibration mode - do not edit by hand.
+// Regenerate: CALIBRATE=presets CALIBRATION_OUT=calibration_data.h ./solver_dev
+// Included by calibration_table.h (CalibrationRecord must be defined).
+
+inline std::vector<CalibrationRecord> generated_calibration_records() {
+    return {
+        // 2M/4M/4M (native)
+        CalibrationRecord("native", 2u << 20, 4u << 20, 4u << 20, 0,
+                          416, 0.9, 0.9, 0.9, 0, 1.46814,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 1887436, 3774873, 3774873},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 4M/4M/4M (native)
+        CalibrationRecord("native", 4u << 20, 4u << 20, 4u << 20, 0,
+                          431, 0.9, 0.9, 0.9, 0, 1.28646,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 3774873, 3774873, 3774873},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 4M/8M/8M (native)
+        CalibrationRecord("native", 4u << 20, 8u << 20, 8u << 20, 0,
+                          616, 0.9, 0.9, 0.9, 0, 1.40207,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 3774873, 7549747, 7549747},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 8M/8M/8M (native)
+        CalibrationRecord("native", 8u << 20, 8u << 20, 8u << 20, 0,
+                          645, 0.9, 0.9, 0.9, 0, 1.19018,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 7549747, 7549747, 7549747},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 8M/16M/16M (native)
+        CalibrationRecord("native", 8u << 20, 16u << 20, 16u << 20, 0,
+                          1016, 0.9, 0.9, 0.9, 0, 1.35223,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 7549747, 15099494, 15099494},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 16M/32M/32M (native)
+        CalibrationRecord("native", 16u << 20, 32u << 20, 32u << 20, 0,
+                          1816, 0.9, 0.9, 0.9, 0, 1.32039,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 15099494, 30198988, 30198988},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 32M/64M/64M (native)
+        CalibrationRecord("native", 32u << 20, 64u << 20, 64u << 20, 0,
+                          3416, 0.9, 0.9, 0.9, 0, 1.30215,
+                          {1, 15, 182, 2286, 28611, 349811, 4169855, 30198988, 60397976, 60397976},
+                          false, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 2M/4M/4M (native, mirrored)
+        CalibrationRecord("native", 2u << 20, 4u << 20, 4u << 20, 0,
+                          321, 0.9, 0.9, 0.9, 0, 1.45714,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 1887436, 3774873, 3774873},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 4M/4M/4M (native, mirrored)
+        CalibrationRecord("native", 4u << 20, 4u << 20, 4u << 20, 0,
+                          335, 0.9, 0.9, 0.9, 0, 1.23488,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 3774873, 3774873, 3774873},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 4M/8M/8M (native, mirrored)
+        CalibrationRecord("native", 4u << 20, 8u << 20, 8u << 20, 0,
+                          521, 0.9, 0.9, 0.9, 0, 1.38446,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 3774873, 7549747, 7549747},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 8M/8M/8M (native, mirrored)
+        CalibrationRecord("native", 8u << 20, 8u << 20, 8u << 20, 0,
+                          549, 0.9, 0.9, 0.9, 0, 1.14814,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 7549747, 7549747, 7549747},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 8M/16M/16M (native, mirrored)
+        CalibrationRecord("native", 8u << 20, 16u << 20, 16u << 20, 0,
+                          921, 0.9, 0.9, 0.9, 0, 1.338,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 7549747, 15099494, 15099494},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 16M/32M/32M (native, mirrored)
+        CalibrationRecord("native", 16u << 20, 32u << 20, 32u << 20, 0,
+                          1720, 0.894506, 0.9, 0.9, 0, 1.31296,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 15007326, 30198988, 30198988},
+                          true, {0, 0, 0, 0, 0, 0, 0, 1, 1, 1}),
+        // 32M/64M/64M (native, mirrored)
+        CalibrationRecord("native", 32u << 20, 64u << 20, 64u << 20, 0,
+                          3273, 0.713766, 0.9, 0.9, 0, 1.35412,
+                          {1, 9, 96, 1159, 14354, 175040, 2085388, 23950022, 60397976, 60397976},
+                          true, {0, 0, 0, 0, 0, 0, 0, 0, 1, 1}),
+    };
+}
+
+#endif // CALIBRATION_DATA_H
@@ -0,0 +1,309 @@
+#ifndef CALIBRATION_TABLE_H
+#define CALIBRATION_TABLE_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// Bucket Model Calibration Table
+// =============================================================================
+//
+// Measured results of full database builds, one record per bucket
+// configuration, platform and mirror mode (L/R mirror reduction halves the
+// stored nodes, so the two modes differ in node counts, loads and peak RSS).
+// Produced by the calibration mode of the native harness (CALIBRATE=...) or
+// calibrate_bucket_model() in WASM, and consumed by:
+//   - get_measured_data() / select_model()   (bucket_config.h)
+//   - ExpansionParameterTable                 (expansion_parameters.h)
+//   - SlidingDepthSets::expected_nodes()      (BFS reserve sizes)
+//
+// Depths past the BFS are sampled into fixed buckets and usually stop at the
+// bucket capacity: their counts are caps, not depth sizes. capped_per_depth
+// tells those apart from steps whose nodes all fit.
+//
+// The compiled-in records come from calibration_data.h (generated). Further
+// records can be loaded at runtime from the JSON produced by to_json().
+
+inline const char* calibration_platform() {
+#ifdef __EMSCRIPTEN__
+    return "wasm";
+#else
+    return "native";
+#endif
+}
+
+struct CalibrationRecord {
+    std::string platform;              // "native" or "wasm"
+    size_t d7 = 0, d8 = 0, d9 = 0, d10 = 0;  // Bucket sizes (same units as ModelData)
+    size_t peak_rss_mb = 0;            // Peak RSS (native) / final heap (WASM), no margin
+    double load_d7 = 0.0, load_d8 = 0.0, load_d9 = 0.0, load_d10 = 0.0;  // Achieved nodes / buckets
+    double memory_factor = 0.0;        // Peak RSS / memory predicted by determine_bucket_sizes()
+    std::vector<size_t> nodes_per_depth;  // index = depth
+    bool mirrored = false;             // Built with L/R mirror reduction (canonical node counts)
+    std::vector<bool> capped_per_depth;   // index = depth; expansion stopped at the bucket capacity
+
+    static const int BFS_DEPTH = 6;    // Depths 0-6 are built by full BFS, never capped
+
+    CalibrationRecord() = default;
+
+    CalibrationRecord(const std::string& plat, size_t b7, size_t b8, size_t b9, size_t b10,
+                      size_t rss, double ld7, double ld8, double ld9, double ld10,
+                      double mem_factor, const std::vector<size_t>& nodes, bool mirror = false,
+                      const std::vector<bool>& capped = {})
+        : platform(plat), d7(b7), d8(b8), d9(b9), d10(b10), peak_rss_mb(rss)
+        , load_d7(ld7), load_d8(ld8), load_d9(ld9), load_d10(ld10)
+        , memory_factor(mem_factor), nodes_per_depth(nodes), mirrored(mirror)
+        , capped_per_depth(capped) {}
+
+    // Whether the count of depth is the bucket capacity (the expansion was
+    // truncated) rather than every node the expansion generated. Records
+    // without flags (older JSON) count every depth past BFS_DEPTH as capped.
+    bool capped(int depth) const {
+        if (capped_per_depth.empty()) return depth > BFS_DEPTH;
+        return static_cast<size_t>(depth) < capped_per_depth.size() && capped_per_depth[depth];
+    }
+
+    // Whether nodes_per_depth[depth] is the whole depth: BFS depths, and
+    // depths expanded from a whole depth without reaching the bucket capacity
+    bool complete(int depth) const {
+        if (depth <= BFS_DEPTH) return depth >= 0;
+        return !capped(depth) && complete(depth - 1);
+    }
+
+    size_t nodes(int depth) const {
+        return static_cast<size_t>(depth) < nodes_per_depth.size() ? nodes_per_depth[depth] : 0;
+    }
+
+    size_t total_nodes() const {
+        size_t total = 0;
+        for (size_t n : nodes_per_depth) total += n;
+        return total;
+    }
+
+    bool same_buckets(const CalibrationRecord& other) const {
+        return platform == other.platform && d7 == other.d7 && d8 == other.d8 &&
+               d9 == other.d9 && d10 == other.d10 && mirrored == other.mirrored;
+    }
+};
+
+// Provides generated_calibration_records()
+#include "calibration_data.h"
+
+class CalibrationTable {
+public:
+    static CalibrationTable& instance() {
+        static CalibrationTable table;
+        return table;
+    }
+
+    // Insert or replace (same platform, buckets and mirror mode)
+    void add(const CalibrationRecord& record) {
+        for (auto& r : records_) {
+            if (r.same_buckets(record)) {
+                r = record;
+                version_++;
+                return;
+            }
+        }
+        records_.push_back(record);
+        version_++;
+    }
+
+    const std::vector<CalibrationRecord>& records() const { return records_; }
+
+    // Bumped on every change so cached consumers can refresh
+    size_t version() const { return version_; }
+
+    // Exact match for the current platform and mirror mode (d10 = 0 matches
+    // 3-depth records)
+    const CalibrationRecord* find(size_t d7, size_t d8, size_t d9, size_t d10, bool mirrored) const {
+        for (const auto& r : records_) {
+            if (r.platform == calibration_platform() && r.mirrored == mirrored &&
+                r.d7 == d7 && r.d8 == d8 && r.d9 == d9 && r.d10 == d10) {
+                return &r;
+            }
+        }
+        return nullptr;
+    }
+
+    // Measured node count of a whole depth (CalibrationRecord::complete), 0
+    // if unknown. Depths up to 6 are identical in every record built in the
+    // same mirror mode (exact BFS); depth 7 is known once a build held all of
+    // it. A capped count is a bucket capacity and never used.
+    size_t expected_nodes(int depth, bool mirrored) const {
+        for (const auto& r : records_) {
+            if (r.mirrored == mirrored && r.complete(depth) && r.nodes(depth) > 0) {
+                return r.nodes_per_depth[depth];
+            }
+        }
+        return 0;
+    }
+
+    // Parse JSON produced by to_json() / record_to_json(); returns records added
+    size_t load_json(const std::string& json) {
+        size_t added = 0;
+        size_t pos = 0;
+        while ((pos = json.find("\"platform\"", pos)) != std::string::npos) {
+            size_t begin = json.rfind('{', pos);
+            size_t end = json.find('}', pos);
+            if (begin == std::string::npos || end == std::string::npos) break;
+            CalibrationRecord r = parse_record(json.substr(begin, end - begin + 1));
+            if (!r.platform.empty() && r.d7 > 0) {
+                add(r);
+                added++;
+            }
+            pos = end;
+        }
+        return added;
+    }
+
+    static std::string record_to_json(const CalibrationRecord& r) {
+        std::ostringstream oss;
+        oss << "{\"platform\":\"" << r.platform << "\""
+            << ",\"d7\":" << r.d7 << ",\"d8\":" << r.d8
+            << ",\"d9\":" << r.d9 << ",\"d10\":" << r.d10
+            << ",\"peak_rss_mb\":" << r.peak_rss_mb
+            << ",\"load_d7\":" << r.load_d7 << ",\"load_d8\":" << r.load_d8
+            << ",\"load_d9\":" << r.load_d9 << ",\"load_d10\":" << r.load_d10
+            << ",\"memory_factor\":" << r.memory_factor
+            << ",\"nodes_per_depth\":[";
+        for (size_t i = 0; i < r.nodes_per_depth.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << r.nodes_per_depth[i];
+        }
+        oss << "],\"mirrored\":" << (r.mirrored ? "true" : "false")
+            << ",\"capped_per_depth\":[";
+        for (size_t i = 0; i < r.capped_per_depth.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << (r.capped_per_depth[i] ? 1 : 0);
+        }
+        oss << "]}";
+        return oss.str();
+    }
+
+    std::string to_json() const {
+        std::ostringstream oss;
+        oss << "{\"records\":[";
+        for (size_t i = 0; i < records_.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << "\n  " << record_to_json(records_[i]);
+        }
+        oss << "\n]}\n";
+        return oss.str();
+    }
+
+    // Source of calibration_data.h
+    std::string to_header() const {
+        std::ostringstream oss;
+        oss << "#ifndef CALIBRATION_DATA_H\n"
+            << "#define CALIBRATION_DATA_H\n\n"
+            << "// Generated by solver_dev calibration mode - do not edit by hand.\n"
+            << "// Regenerate: CALIBRATE=presets CALIBRATION_OUT=calibration_data.h ./solver_dev\n"
+            << "// Included by calibration_table.h (CalibrationRecord must be defined).\n\n"
+            << "inline std::vector<CalibrationRecord> generated_calibration_records() {\n"
+            << "    return {\n";
+        for (const auto& r : records_) {
+            oss << "        // " << (r.d7 >> 20) << "M/" << (r.d8 >> 20) << "M/" << (r.d9 >> 20) << "M";
+            if (r.d10 > 0) oss << "/" << (r.d10 >> 20) << "M";
+            oss << " (" << r.platform << (r.mirrored ? ", mirrored" : "") << ")\n"
+                << "        CalibrationRecord(\"" << r.platform << "\", "
+                << bucket_literal(r.d7) << ", " << bucket_literal(r.d8) << ", "
+                << bucket_literal(r.d9) << ", " << bucket_literal(r.d10) << ",\n"
+                << "                          " << r.peak_rss_mb << ", "
+                << r.load_d7 << ", " << r.load_d8 << ", " << r.load_d9 << ", " << r.load_d10 << ", "
+                << r.memory_factor << ",\n"
+                << "                          {";
+            for (size_t i = 0; i < r.nodes_per_depth.size(); ++i) {
+                if (i > 0) oss << ", ";
+                oss << r.nodes_per_depth[i];
+            }
+            oss << "},\n"
+                << "                          " << (r.mirrored ? "true" : "false") << ", {";
+            for (size_t i = 0; i < r.capped_per_depth.size(); ++i) {
+                if (i > 0) oss << ", ";
+                oss << (r.capped_per_depth[i] ? 1 : 0);
+            }
+            oss << "}),\n";
+        }
+        oss << "    };\n"
+            << "}\n\n"
+            << "#endif // CALIBRATION_DATA_H\n";
+        return oss.str();
+    }
+
+private:
+    CalibrationTable() : records_(generated_calibration_records()), version_(1) {}
+
+    static std::string bucket_literal(size_t bucket) {
+        return bucket == 0 ? std::string("0") : std::to_string(bucket >> 20) + "u << 20";
+    }
+
+    static bool find_value(const std::string& obj, const std::string& key, size_t& value_pos) {
+        size_t p = obj.find("\"" + key + "\"");
+        if (p == std::string::npos) return false;
+        p = obj.find(':', p);
+        if (p == std::string::npos) return false;
+        value_pos = p + 1;
+        while (value_pos < obj.size() && (obj[value_pos] == ' ' || obj[value_pos] == '\n')) value_pos++;
+        return true;
+    }
+
+    static double number(const std::string& obj, const std::string& key) {
+        size_t p;
+        return find_value(obj, key, p) ? std::strtod(obj.c_str() + p, nullptr) : 0.0;
+    }
+
+    static CalibrationRecord parse_record(const std::string& obj) {
+        CalibrationRecord r;
+        size_t p;
+        if (find_value(obj, "platform", p) && obj[p] == '"') {
+            size_t q = obj.find('"', p + 1);
+            if (q != std::string::npos) r.platform = obj.substr(p + 1, q - p - 1);
+        }
+        r.d7 = static_cast<size_t>(number(obj, "d7"));
+        r.d8 = static_cast<size_t>(number(obj, "d8"));
+        r.d9 = static_cast<size_t>(number(obj, "d9"));
+        r.d10 = static_cast<size_t>(number(obj, "d10"));
+        r.peak_rss_mb = static_cast<size_t>(number(obj, "peak_rss_mb"));
+        r.load_d7 = number(obj, "load_d7");
+        r.load_d8 = number(obj, "load_d8");
+        r.load_d9 = number(obj, "load_d9");
+        r.load_d10 = number(obj, "load_d10");
+        r.memory_factor = number(obj, "memory_factor");
+        if (find_value(obj, "mirrored", p)) r.mirrored = obj.compare(p, 4, "true") == 0;
+        for (unsigned long long v : integers(obj, "nodes_per_depth")) {
+            r.nodes_per_depth.push_back(static_cast<size_t>(v));
+        }
+        for (unsigned long long v : integers(obj, "capped_per_depth")) {
+            r.capped_per_depth.push_back(v != 0);
+        }
+        return r;
+    }
+
+    // Integer array value of key, empty if missing
+    static std::vector<unsigned long long> integers(const std::string& obj, const std::string& key) {
+        std::vector<unsigned long long> values;
+        size_t p;
+        if (!find_value(obj, key, p) || obj[p] != '[') return values;
+        const char* c = obj.c_str() + p + 1;
+        while (*c != ']' && *c != '\0') {
+            char* next = nullptr;
+            unsigned long long v = std::strtoull(c, &next, 10);
+            if (next == c) {
+                c++;
+                continue;
+            }
+            values.push_back(v);
+            c = next;
+        }
+        return values;
+    }
+
+    std::vector<CalibrationRecord> records_;
+    size_t version_;
+};
+
+#endif // CALIBRATION_TABLE_H
@@ -1,10 +1,13 @@
 #ifndef EXPANSION_PARAMETERS_H
 #define EXPANSION_PARAMETERS_H
 
+#include <algorithm>
 #include <cstddef>
 #include <map>
 #include <tuple>
 
+#include "calibration_table.h"
+
 // Parameters for depth and bucket size combinations
 struct ExpansionParameters {
     // Effective load factor (Step 2: Random expansion)
@@ -36,10 +39,74 @@ struct ExpansionParameters {
 class ExpansionParameterTable {
 private:
     std::map<std::pair<int, size_t>, ExpansionParameters> params_;
+    // (max_depth, step, bucket_size) -> nodes of a calibrated build whose
+    // step stopped below the bucket capacity (step 1 = n+1, 2 = n+2)
+    std::map<std::tuple<int, int, size_t>, size_t> fitted_nodes_;
+    bool mirrored_ = true;  // Mirror mode whose calibration records apply
     
 public:
     ExpansionParameterTable() {
         initialize_default_parameters();
+        apply_calibration(CalibrationTable::instance());
+    }
+    
+    // Override load/memory factors with measured builds (current platform and
+    // mirror mode).
+    // Builds run BFS to depth 6, so depth 7 is the n+1 (random) step and
+    // depth 8 the n+2 step: load_d7 -> effective load of bucket d7,
+    // load_d8 / memory_factor -> backtrace load / memory factor of bucket d8.
+    // A step that was not capped also records its node count (see
+    // expected_nodes()).
+    void apply_calibration(const CalibrationTable& table, int bfs_depth = CalibrationRecord::BFS_DEPTH) {
+        for (const auto& r : table.records()) {
+            if (r.platform != calibration_platform() || r.mirrored != mirrored_) continue;
+            
+            if (r.load_d7 > 0.0) {
+                ExpansionParameters p = get(bfs_depth, r.d7);
+                p.effective_load_factor = r.load_d7;
+                p.is_configured = true;
+                params_[{bfs_depth, r.d7}] = p;
+                set_fitted(bfs_depth, 1, r.d7, r);
+            }
+            if (r.load_d8 > 0.0) {
+                ExpansionParameters p = get(bfs_depth, r.d8);
+                p.backtrace_load_factor = r.load_d8;
+                if (r.memory_factor > 0.0) {
+                    p.measured_memory_factor = r.memory_factor;
+                }
+                p.is_configured = true;
+                params_[{bfs_depth, r.d8}] = p;
+                set_fitted(bfs_depth, 2, r.d8, r);
+            }
+        }
+    }
+    
+    // Nodes expansion step (1 = n+1 random, 2 = n+2 backtrace) is expected to
+    // store in bucket_size: bucket x load, where a capped build filled its
+    // bucket. A build whose step stopped below capacity ran out of parents
+    // first, so a larger bucket holds no more than that build generated.
+    size_t expected_nodes(int max_depth, int step, size_t bucket_size) const {
+        const ExpansionParameters p = get(max_depth, bucket_size);
+        double load = (step == 1) ? p.effective_load_factor : p.backtrace_load_factor;
+        size_t nodes = static_cast<size_t>(bucket_size * load);
+        for (const auto& f : fitted_nodes_) {
+            if (std::get<0>(f.first) == max_depth && std::get<1>(f.first) == step &&
+                std::get<2>(f.first) <= bucket_size) {
+                nodes = std::min(nodes, f.second);
+            }
+        }
+        return nodes;
+    }
+    
+    // Switch to the calibration of the other mirror mode (database builds call
+    // this before sizing their buckets)
+    void set_mirrored(bool mirrored, const CalibrationTable& table) {
+        if (mirrored == mirrored_) return;
+        mirrored_ = mirrored;
+        params_.clear();
+        fitted_nodes_.clear();
+        initialize_default_parameters();
+        apply_calibration(table);
     }
     
     void initialize_default_parameters() {
@@ -113,6 +180,18 @@ public:
         set(7, BUCKET_64M, 0.70, 0.85, 1.35);
     }
     
+    // Record (or, once the bucket is refilled to capacity, forget) the node
+    // count of step of record r
+    void set_fitted(int bfs_depth, int step, size_t bucket_size, const CalibrationRecord& r) {
+        const int depth = bfs_depth + step;
+        const auto key = std::make_tuple(bfs_depth, step, bucket_size);
+        if (r.capped(depth) || r.nodes(depth) == 0) {
+            fitted_nodes_.erase(key);
+        } else {
+            fitted_nodes_[key] = r.nodes(depth);
+        }
+    }
+    
     // Set parameters
     void set(int max_depth, size_t bucket_size, 
              double eff_load, double bt_load, double mem_factor) {
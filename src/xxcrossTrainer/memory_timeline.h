@@ -0,0 +1,242 @@
+#ifndef MEMORY_TIMELINE_H
+#define MEMORY_TIMELINE_H
+
+// =============================================================================
+// Memory Timeline Sampler
+// =============================================================================
+//
+// In-process replacement for the external /proc pollers in tools/memory_monitoring.
+// Records RSS / heap size / arena usage together with the live node count and
+// bucket count of the container currently being filled, tagged with the build
+// phase ("BFS depth 5", "Phase 3: depth 8 local expansion", ...).
+//
+//   - Native: a background thread samples every interval_ms; phase hooks add
+//     marker samples at each boundary.
+//   - WASM (no threads): samples are taken at phase hooks and at the periodic
+//     count updates inside the expansion loops.
+//
+// Samples live in a fixed-capacity ring buffer (oldest overwritten) and are
+// exported with to_csv() / to_json().
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "node_arena.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/heap.h>
+#else
+#include <thread>
+#include <unistd.h>
+#endif
+
+struct TimelineSample {
+    double t_ms = 0.0;          // Milliseconds since start()
+    size_t rss_kb = 0;          // Native RSS (0 on WASM)
+    size_t heap_bytes = 0;      // WASM heap size (0 on native)
+    size_t arena_live_bytes = 0;
+    size_t live_nodes = 0;
+    size_t bucket_count = 0;
+    int phase_id = -1;          // Index into MemoryTimeline phase names
+    bool marker = false;        // true = taken at a phase hook
+};
+
+class MemoryTimeline {
+public:
+    static MemoryTimeline& instance() {
+        static MemoryTimeline timeline;
+        return timeline;
+    }
+
+    // Reset the buffer and start recording. interval_ms is ignored on WASM.
+    void start(size_t capacity = 65536, int interval_ms = 10) {
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            samples_.assign(capacity > 0 ? capacity : 1, TimelineSample());
+            head_ = 0;
+            count_ = 0;
+            dropped_ = 0;
+            phases_.clear();
+            phases_.push_back("start");
+            phase_id_.store(0);
+            live_nodes_.store(0);
+            bucket_count_.store(0);
+            t0_ = std::chrono::steady_clock::now();
+        }
+        active_.store(true);
+        record(true);
+#ifndef __EMSCRIPTEN__
+        interval_ms_ = interval_ms > 0 ? interval_ms : 1;
+        sampler_ = std::thread([this]() {
+            while (active_.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms_));
+                if (active_.load()) record(false);
+            }
+        });
+#else
+        (void)interval_ms;
+#endif
+    }
+
+    void stop() {
+        if (!active_.load()) return;
+        record(true);
+        active_.store(false);
+#ifndef __EMSCRIPTEN__
+        if (sampler_.joinable()) sampler_.join();
+#endif
+    }
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    // Phase hook: switch the phase tag and take a marker sample.
+    void mark(const std::string& phase, size_t live_nodes, size_t bucket_count) {
+        if (!active()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            phases_.push_back(phase);
+            phase_id_.store(static_cast<int>(phases_.size()) - 1);
+        }
+        live_nodes_.store(live_nodes, std::memory_order_relaxed);
+        bucket_count_.store(bucket_count, std::memory_order_relaxed);
+        record(true);
+    }
+
+    // Cheap count update from inside expansion loops.
+    void update_counts(size_t live_nodes, size_t bucket_count) {
+        if (!active()) return;
+        live_nodes_.store(live_nodes, std::memory_order_relaxed);
+        bucket_count_.store(bucket_count, std::memory_order_relaxed);
+#ifdef __EMSCRIPTEN__
+        record(false);
+#endif
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    std::string to_csv() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream oss;
+        oss << "t_ms,phase,marker,rss_kb,heap_bytes,arena_live_bytes,live_nodes,bucket_count\n";
+        for_each_locked([&](const TimelineSample& s) {
+            oss << s.t_ms << ",\"" << phase_name_locked(s.phase_id) << "\"," << (s.marker ? 1 : 0)
+                << "," << s.rss_kb << "," << s.heap_bytes << "," << s.arena_live_bytes
+                << "," << s.live_nodes << "," << s.bucket_count << "\n";
+        });
+        return oss.str();
+    }
+
+    std::string to_json() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream oss;
+        oss << "{\"dropped\":" << dropped_ << ",\"samples\":[";
+        bool first = true;
+        for_each_locked([&](const TimelineSample& s) {
+            if (!first) oss << ",";
+            first = false;
+            oss << "{\"t_ms\":" << s.t_ms
+                << ",\"phase\":\"" << phase_name_locked(s.phase_id) << "\""
+                << ",\"marker\":" << (s.marker ? "true" : "false")
+                << ",\"rss_kb\":" << s.rss_kb
+                << ",\"heap_bytes\":" << s.heap_bytes
+                << ",\"arena_live_bytes\":" << s.arena_live_bytes
+                << ",\"live_nodes\":" << s.live_nodes
+                << ",\"bucket_count\":" << s.bucket_count << "}";
+        });
+        oss << "]}";
+        return oss.str();
+    }
+
+    ~MemoryTimeline() { stop(); }
+
+private:
+    MemoryTimeline() = default;
+    MemoryTimeline(const MemoryTimeline&) = delete;
+    MemoryTimeline& operator=(const MemoryTimeline&) = delete;
+
+    // /proc/self/statm is a single short line; cheaper than parsing status
+    // at a 10 ms cadence.
+    static size_t read_rss_kb() {
+#ifdef __EMSCRIPTEN__
+        return 0;
+#else
+        FILE* f = std::fopen("/proc/self/statm", "r");
+        if (f == nullptr) return 0;
+        unsigned long pages_total = 0, pages_resident = 0;
+        int n = std::fscanf(f, "%lu %lu", &pages_total, &pages_resident);
+        std::fclose(f);
+        if (n != 2) return 0;
+        return static_cast<size_t>(pages_resident) * (static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024);
+#endif
+    }
+
+    void record(bool marker) {
+        TimelineSample s;
+        s.rss_kb = read_rss_kb();
+#ifdef __EMSCRIPTEN__
+        s.heap_bytes = emscripten_get_heap_size();
+#endif
+        s.arena_live_bytes = NodeArena::instance().stats().live_bytes;
+        s.live_nodes = live_nodes_.load(std::memory_order_relaxed);
+        s.bucket_count = bucket_count_.load(std::memory_order_relaxed);
+        s.phase_id = phase_id_.load(std::memory_order_relaxed);
+        s.marker = marker;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (samples_.empty()) return;
+        s.t_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0_).count();
+        samples_[head_] = s;
+        head_ = (head_ + 1) % samples_.size();
+        if (count_ < samples_.size()) {
+            count_++;
+        } else {
+            dropped_++;
+        }
+    }
+
+    template <class F>
+    void for_each_locked(F&& f) const {
+        const size_t cap = samples_.size();
+        const size_t begin = (head_ + cap - count_) % (cap > 0 ? cap : 1);
+        for (size_t i = 0; i < count_; ++i) {
+            f(samples_[(begin + i) % cap]);
+        }
+    }
+
+    const std::string& phase_name_locked(int id) const {
+        static const std::string unknown = "unknown";
+        if (id < 0 || static_cast<size_t>(id) >= phases_.size()) return unknown;
+        return phases_[id];
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<TimelineSample> samples_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t dropped_ = 0;
+    std::vector<std::string> phases_;
+    std::chrono::steady_clock::time_point t0_;
+
+    std::atomic<bool> active_{false};
+    std::atomic<int> phase_id_{-1};
+    std::atomic<size_t> live_nodes_{0};
+    std::atomic<size_t> bucket_count_{0};
+
+#ifndef __EMSCRIPTEN__
+    int interval_ms_ = 10;
+    std::thread sampler_;
+#endif
+};
+
+#endif // MEMORY_TIMELINE_H
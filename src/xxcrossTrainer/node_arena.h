@@ -0,0 +1,249 @@
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+// =============================================================================
+// Node Arena Allocator
+// =============================================================================
+//
+// Pluggable allocator for the large node containers of the xxcross database
+// build (robin_set bucket arrays and index_pairs vectors).
+//
+// Large requests (>= NodeArena::MIN_BLOCK_BYTES) are served from page-granular
+// blocks owned by a process-wide pool instead of malloc:
+//   - Native: blocks are mmap()'d. A released block is madvise(MADV_DONTNEED)'d
+//     so its pages leave RSS immediately, and the mapping is kept for reuse by
+//     the next allocation of a compatible size. No malloc_trim() is needed to
+//     give bucket memory back to the OS.
+//   - WASM: the linear heap never shrinks, so released blocks are kept in a
+//     sized free list and handed out again (best fit, bounded waste). This
+//     stops the prev/cur/next rotation in advance_depth() from growing the
+//     heap with fresh, fragmented allocations at every depth.
+// A request no cached block fits first releases the cached blocks smaller
+// than itself: those were outgrown by doubling growth (a rehash frees the
+// half-size array) and nothing would take them again before the next depth.
+// On WASM they go back to malloc, which can merge neighbours into the new
+// block instead of growing the heap.
+// Small requests fall through to malloc (initial tiny reserves, empty sets).
+//
+// The allocator is stateless; all instances share NodeArena::instance(), so
+// containers using it can be moved/swapped freely.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#include <tsl/robin_set.h>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#define NODE_ARENA_USE_MMAP 1
+#else
+#define NODE_ARENA_USE_MMAP 0
+#endif
+
+class NodeArena {
+public:
+    static constexpr size_t MIN_BLOCK_BYTES = size_t(1) << 20;  // 1 MB
+    static constexpr size_t BLOCK_GRANULE = size_t(64) << 10;   // 64 KB
+
+    struct Stats {
+        size_t live_bytes = 0;       // Bytes in blocks currently handed out
+        size_t cached_bytes = 0;     // Bytes in released blocks kept for reuse
+        size_t peak_live_bytes = 0;
+        size_t blocks_created = 0;   // mmap()/malloc() of a new block
+        size_t blocks_reused = 0;    // Served from the free list
+        size_t blocks_released = 0;
+        size_t blocks_trimmed = 0;   // Outgrown cached blocks given back on a miss
+    };
+
+    static NodeArena& instance() {
+        static NodeArena arena;
+        return arena;
+    }
+
+    // Switch between arena and plain malloc. Only takes effect while no arena
+    // block is live (a block must be freed by the path that allocated it).
+    bool set_enabled(bool enable) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (live_blocks_.empty()) {
+            enabled_ = enable;
+        }
+        return enabled_ == enable;
+    }
+
+    bool enabled() const { return enabled_; }
+
+    void* allocate(size_t bytes) {
+        if (!enabled_ || bytes < MIN_BLOCK_BYTES) {
+            void* p = std::malloc(bytes == 0 ? 1 : bytes);
+            if (p == nullptr) throw std::bad_alloc();
+            return p;
+        }
+
+        const size_t block_bytes = round_up(bytes);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        void* p = nullptr;
+        size_t got_bytes = block_bytes;
+
+        // Best fit from the free list; accept at most 2x the request so a huge
+        // cached block is not pinned by a small container.
+        auto it = free_blocks_.lower_bound(block_bytes);
+        if (it != free_blocks_.end() && it->first <= block_bytes * 2) {
+            got_bytes = it->first;
+            p = it->second;
+            free_blocks_.erase(it);
+            stats_.cached_bytes -= got_bytes;
+            stats_.blocks_reused++;
+        } else {
+            release_cached_below_locked(block_bytes);
+            p = map_block(block_bytes);
+            if (p == nullptr) {
+                // Drop the cache and retry once before giving up
+                release_cached_locked();
+                p = map_block(block_bytes);
+                if (p == nullptr) throw std::bad_alloc();
+            }
+            stats_.blocks_created++;
+        }
+
+        live_blocks_[p] = got_bytes;
+        stats_.live_bytes += got_bytes;
+        if (stats_.live_bytes > stats_.peak_live_bytes) {
+            stats_.peak_live_bytes = stats_.live_bytes;
+        }
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (p == nullptr) return;
+        if (bytes < MIN_BLOCK_BYTES) {
+            std::free(p);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = live_blocks_.find(p);
+        if (it == live_blocks_.end()) {
+            // Allocated while the arena was disabled
+            std::free(p);
+            return;
+        }
+
+        const size_t block_bytes = it->second;
+        live_blocks_.erase(it);
+        stats_.live_bytes -= block_bytes;
+        stats_.blocks_released++;
+
+#if NODE_ARENA_USE_MMAP
+        // Return the pages to the OS now, keep the address range for reuse
+        madvise(p, block_bytes, MADV_DONTNEED);
+#endif
+        free_blocks_.emplace(block_bytes, p);
+        stats_.cached_bytes += block_bytes;
+    }
+
+    // Unmap (native) / free (WASM) every cached block.
+    void release_cached() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        release_cached_locked();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    NodeArena() = default;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    static size_t round_up(size_t bytes) {
+        return (bytes + BLOCK_GRANULE - 1) / BLOCK_GRANULE * BLOCK_GRANULE;
+    }
+
+    static void* map_block(size_t bytes) {
+#if NODE_ARENA_USE_MMAP
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#else
+        return std::malloc(bytes);
+#endif
+    }
+
+    static void unmap_block(void* p, size_t bytes) {
+#if NODE_ARENA_USE_MMAP
+        munmap(p, bytes);
+#else
+        (void)bytes;
+        std::free(p);
+#endif
+    }
+
+    // Cached blocks smaller than bytes (too small for this request and, with
+    // containers growing by doubling, for the next ones)
+    void release_cached_below_locked(size_t bytes) {
+        auto end = free_blocks_.lower_bound(bytes);
+        for (auto it = free_blocks_.begin(); it != end; ++it) {
+            unmap_block(it->second, it->first);
+            stats_.cached_bytes -= it->first;
+            stats_.blocks_trimmed++;
+        }
+        free_blocks_.erase(free_blocks_.begin(), end);
+    }
+
+    void release_cached_locked() {
+        for (auto& kv : free_blocks_) {
+            unmap_block(kv.second, kv.first);
+        }
+        free_blocks_.clear();
+        stats_.cached_bytes = 0;
+    }
+
+    mutable std::mutex mutex_;
+    bool enabled_ = true;
+    std::multimap<size_t, void*> free_blocks_;      // block size -> block
+    std::unordered_map<void*, size_t> live_blocks_; // block -> block size
+    Stats stats_;
+};
+
+template <class T>
+struct NodeArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::true_type;
+
+    NodeArenaAllocator() noexcept = default;
+    template <class U>
+    NodeArenaAllocator(const NodeArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(NodeArena::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        NodeArena::instance().deallocate(p, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const NodeArenaAllocator<U>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const NodeArenaAllocator<U>&) const noexcept { return false; }
+};
+
+// Node containers used by the database build. The element vector type follows
+// the set's allocator, so index_pairs recorded via attach_element_vector() are
+// arena-backed as well.
+using NodeSet = tsl::robin_set<uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                               NodeArenaAllocator<uint64_t>>;
+using NodeVector = NodeSet::element_vector_type;
+
+#endif // NODE_ARENA_H
@@ -1,5 +1,6 @@
 #ifdef __EMSCRIPTEN__
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
 #include <emscripten/heap.h>
 #include <emscripten.h>
 #endif
@@ -14,11 +15,19 @@
 #include <random>
 #include <deque>
 #include <iomanip>
+#include <chrono>
 #include <tsl/robin_set.h>
 #include "bucket_config.h"
+#include "node_arena.h"  // Arena allocator for NodeSet / NodeVector
+#include "memory_timeline.h" // In-process RSS/heap sampler
+#include "calibration_table.h" // Measured bucket model data
+#include "../move_sequence.h"
 
 #ifndef __EMSCRIPTEN__
 #include <malloc.h>  // For malloc_trim
+#include <thread>    // For parallel batch scramble generation
+#include <unistd.h>  // fork/pipe for calibration sweeps
+#include <sys/wait.h>
 #endif
 
 #pragma GCC target("avx2")
@@ -61,6 +70,25 @@ size_t get_rss_kb()
 #endif
 }
 
+// Helper function to get peak RSS of this process (Linux only)
+size_t get_peak_rss_kb()
+{
+#ifdef __EMSCRIPTEN__
+	return 0;
+#else
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.substr(0, 6) == "VmHWM:")
+		{
+			return std::stoull(line.substr(6));
+		}
+	}
+	return 0;
+#endif
+}
+
 struct State
 {
 	std::vector<int> cp;
@@ -144,34 +172,16 @@ std::unordered_map<std::string, State> moves = {
 	{"B'", State({4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0}, {8, 4, 2, 3, 0, 5, 6, 7, 1, 9, 10, 11}, {1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0})}};
 
 std::vector<std::string> move_names = {"U", "U2", "U'", "D", "D2", "D'", "L", "L2", "L'", "R", "R2", "R'", "F", "F2", "F'", "B", "B2", "B'"};
+MoveCodec move_codec(move_names);
 
 std::string AlgToString(std::vector<int> &alg)
 {
-	std::string result = "";
-	for (int i : alg)
-	{
-		result += move_names[i] + " ";
-	}
-	return result;
+	return move_codec.format(alg);
 }
 
 std::vector<int> StringToAlg(std::string str)
 {
-	std::vector<int> alg;
-	std::istringstream iss(str);
-	std::string name;
-	while (iss >> name)
-	{
-		if (!name.empty())
-		{
-			auto it = std::find(move_names.begin(), move_names.end(), name);
-			if (it != move_names.end())
-			{
-				alg.emplace_back(std::distance(move_names.begin(), it));
-			}
-		}
-	}
-	return alg;
+	return move_codec.parse(str);
 }
 
 std::vector<int> AlgConvertRotation(std::vector<int> alg, std::string rotation)
@@ -372,15 +382,164 @@ void create_multi_move_table(int n, int c, int pn, int size, const std::vector<i
 	}
 }
 
+// =============================================================================
+// L/R Mirror Symmetry
+// =============================================================================
+//
+// The adjacent-slot goal (cross + BL + BR pairs) is invariant under the mirror
+// through the M-slice plane: L<->R swaps BL<->BR and keeps the cross. A state
+// and its mirror image therefore have the same distance, and the database only
+// needs to store one of them. Every key inserted during the build is replaced
+// by canonical() = min(index123, mirror(index123)). A stored node stands for
+// two states, or for one if it is self-symmetric (mirror(x) == x). Scrambles
+// are drawn from a uniform node and flipped to the mirror image with
+// probability 1/2; a self-symmetric node is instead rejected with probability
+// 1/2 and drawn again, so the output is uniform over the states as before.
+//
+// Mirror map (verified against the move tables):
+//   edge positions   BL<->BR, FR<->FL, UR<->UL, DR<->DL   (EO unchanged)
+//   corner positions UBL<->UBR, UFR<->UFL, DBL<->DBR, DFR<->DFL   (CO -> -CO)
+//
+// The non-adjacent goal (BL + FR) is not mirror-invariant; init() then leaves
+// the reduction disabled and canonical() is the identity.
+
+struct XxcrossMirror
+{
+	bool enabled = false;
+	uint64_t size23 = 0;
+	int size3 = 0;
+	std::vector<int> mirror1, mirror2, mirror3;
+
+	static const std::vector<int> &edge_position_map()
+	{
+		static const std::vector<int> map = {1, 0, 3, 2, 4, 7, 6, 5, 8, 11, 10, 9};
+		return map;
+	}
+
+	static const std::vector<int> &corner_position_map()
+	{
+		static const std::vector<int> map = {1, 0, 3, 2, 5, 4, 7, 6};
+		return map;
+	}
+
+	// Coordinate table for one piece group; false if the tracked pieces are not
+	// closed under the mirror
+	static bool build_table(const std::vector<int> &goal, int n, int c, int pn, int size, std::vector<int> &table)
+	{
+		const std::vector<int> &position_map = (c == 2) ? edge_position_map() : corner_position_map();
+		std::vector<int> perm(n, -1);
+		for (int k = 0; k < n; ++k)
+		{
+			int mirrored_piece = position_map[goal[k] / c];
+			for (int j = 0; j < n; ++j)
+			{
+				if (goal[j] / c == mirrored_piece)
+					perm[k] = j;
+			}
+			if (perm[k] == -1)
+				return false;
+		}
+
+		table.assign(size, -1);
+		std::vector<int> a(n);
+		std::vector<int> b(n);
+		for (int i = 0; i < size; ++i)
+		{
+			index_to_array(a, i, n, c, pn);
+			for (int k = 0; k < n; ++k)
+			{
+				int coord = a[k] / 18;
+				int pos = position_map[coord / c];
+				int ori = (c == 3) ? (3 - coord % c) % 3 : coord % c;
+				b[perm[k]] = c * pos + ori;
+			}
+			table[i] = array_to_index(b, n, c, pn);
+		}
+		return true;
+	}
+
+	void init(bool enable, const std::vector<int> &cross_goal, const std::vector<int> &edges_goal, const std::vector<int> &corners_goal, int size1, int size2, int size3_)
+	{
+		enabled = false;
+		mirror1.clear();
+		mirror2.clear();
+		mirror3.clear();
+		if (!enable)
+			return;
+		if (!build_table(cross_goal, 4, 2, 12, size1, mirror1) ||
+			!build_table(edges_goal, 2, 2, 12, size2, mirror2) ||
+			!build_table(corners_goal, 2, 3, 8, size3_, mirror3))
+		{
+			mirror1.clear();
+			mirror2.clear();
+			mirror3.clear();
+			return;
+		}
+		size3 = size3_;
+		size23 = static_cast<uint64_t>(size2) * size3_;
+		enabled = true;
+	}
+
+	uint64_t mirror(uint64_t index123) const
+	{
+		uint64_t index1 = index123 / size23;
+		uint64_t index23 = index123 % size23;
+		return mirror1[index1] * size23 + static_cast<uint64_t>(mirror2[index23 / size3]) * size3 + mirror3[index23 % size3];
+	}
+
+	uint64_t canonical(uint64_t index123) const
+	{
+		if (!enabled)
+			return index123;
+		return std::min(index123, mirror(index123));
+	}
+
+	// Undo the reduction when emitting a stored node: image is the node or
+	// its mirror image with probability 1/2 each. False (draw again) with
+	// probability 1/2 if the node is self-symmetric
+	template <class RNG>
+	bool random_image(uint64_t index123, RNG &rng, uint64_t &image) const
+	{
+		image = index123;
+		if (!enabled)
+			return true;
+		bool flip = (rng() & 1) != 0;
+		uint64_t mirrored = mirror(index123);
+		if (mirrored == index123)
+			return !flip;
+		if (flip)
+			image = mirrored;
+		return true;
+	}
+};
+
+// Used by the free build functions; set by xxcross_search before construction
+XxcrossMirror g_xxcross_mirror;
+
 struct SlidingDepthSets
 {
-	tsl::robin_set<uint64_t> prev, cur, next;
+	NodeSet prev, cur, next;
 	size_t max_total_nodes;
 	int current_depth;
 	bool expansion_stopped;
 	bool verbose;
 
 	static const std::vector<size_t> expected_nodes_per_depth;
+	static const std::vector<size_t> expected_canonical_nodes_per_depth; // With mirror reduction
+
+	// Calibrated node count of the whole depth when available (never a
+	// capped one), otherwise the built-in list
+	static size_t expected_nodes(int depth)
+	{
+		const bool mirrored = g_xxcross_mirror.enabled;
+		size_t measured = CalibrationTable::instance().expected_nodes(depth, mirrored);
+		if (measured > 0)
+			return measured;
+		const std::vector<size_t> &list = mirrored ? expected_canonical_nodes_per_depth : expected_nodes_per_depth;
+		if (depth < 0 || static_cast<size_t>(depth) >= list.size())
+			return SIZE_MAX;
+		return list[depth];
+	}
 	static constexpr size_t BYTES_PER_ELEMENT = 32; // robin_set(24) + index_pairs(8)
 
 	SlidingDepthSets(size_t max_nodes = SIZE_MAX, bool enable_verbose = true)
@@ -454,7 +613,7 @@ struct SlidingDepthSets
 		return n + 1;
 	}
 
-	void advance_depth(std::vector<std::vector<uint64_t>> &index_pairs)
+	void advance_depth(std::vector<NodeVector> &index_pairs)
 	{
 		if (verbose)
 		{
@@ -484,7 +643,7 @@ struct SlidingDepthSets
 
 		// Explicitly release memory
 		prev.clear();
-		prev = tsl::robin_set<uint64_t>(); // Complete release
+		prev = NodeSet(); // Complete release
 		prev.max_load_factor(0.9f);
 
 		// Move efficiently using move semantics (element_vector already detached)
@@ -492,7 +651,7 @@ struct SlidingDepthSets
 		cur = std::move(next);
 
 		// Create a new next and attach element_vector for the next depth
-		next = tsl::robin_set<uint64_t>();
+		next = NodeSet();
 		next.max_load_factor(0.9f);
 		expansion_stopped = false;
 		current_depth++;
@@ -503,7 +662,7 @@ struct SlidingDepthSets
 		{
 			index_pairs[next_depth_idx].clear();
 			// Pre-reserve to reduce reallocation spikes during BFS expansion
-			size_t estimated_next_nodes = expected_nodes_per_depth[next_depth_idx];
+			size_t estimated_next_nodes = expected_nodes(next_depth_idx);
 			if (estimated_next_nodes > 0)
 			{
 				index_pairs[next_depth_idx].reserve(estimated_next_nodes);
@@ -685,7 +844,10 @@ struct SlidingDepthSets
 const std::vector<size_t> SlidingDepthSets::expected_nodes_per_depth = {
 	1, 15, 182, 2286, 28611, 349811, 4169855, 47547352, SIZE_MAX}; // depth=8 represents "infinity" with SIZE_MAX
 
-int create_prune_table_sparse(int index1, int index2, int index3, int size1, int size2, int size3, int max_depth, int max_memory_kb, const std::vector<int> &table1, const std::vector<int> &table2, const std::vector<int> &table3, std::vector<std::vector<uint64_t>> &index_pairs, std::vector<int> &num_list, bool verbose = true, const ResearchConfig& research_config = ResearchConfig())
+const std::vector<size_t> SlidingDepthSets::expected_canonical_nodes_per_depth = {
+	1, 9, 96, 1159, 14354, 175040, 2085388, 23773676, SIZE_MAX}; // depth=7 estimated as half of the full count
+
+int create_prune_table_sparse(int index1, int index2, int index3, int size1, int size2, int size3, int max_depth, int max_memory_kb, const std::vector<int> &table1, const std::vector<int> &table2, const std::vector<int> &table3, std::vector<NodeVector> &index_pairs, std::vector<int> &num_list, bool verbose = true, const ResearchConfig& research_config = ResearchConfig())
 {
 	// Memory limit handling
 	const size_t fixed_overhead_kb = 20 * 1024;
@@ -716,7 +878,7 @@ int create_prune_table_sparse(int index1, int index2, int index3, int size1, int
 	}
 
 	const int index23 = index2 * size3 + index3;
-	const uint64_t index123 = index1 * size23 + index23;
+	const uint64_t index123 = g_xxcross_mirror.canonical(index1 * size23 + index23);
 	visited.set_initial(index123);
 	index_pairs[0].emplace_back(index123);
 	num_list[0] = 1;
@@ -750,6 +912,7 @@ int create_prune_table_sparse(int index1, int index2, int index3, int size1, int
 		next_depth = depth + 1;
 		if (visited.cur.empty())
 			break;
+		MemoryTimeline::instance().mark("BFS depth " + std::to_string(next_depth), visited.total_size(), visited.next.bucket_count());
 
 		for (uint64_t cur_index123_val : visited.cur)
 		{
@@ -764,7 +927,7 @@ int create_prune_table_sparse(int index1, int index2, int index3, int size1, int
 				next_index2 = table2[cur_index2 * 18 + i];
 				next_index3 = table3[cur_index3 * 18 + i];
 				next_index23 = next_index2 * size3 + next_index3;
-				next_index123 = next_index1 * size23 + next_index23;
+				next_index123 = g_xxcross_mirror.canonical(next_index1 * size23 + next_index23);
 
 				capacity_reached = false;
 				if (visited.encounter_and_mark_next(next_index123, capacity_reached))
@@ -1022,14 +1185,11 @@ LocalExpansionConfig determine_bucket_sizes(
 	{
 		// Calculate using effective load to avoid rehash
 		// Retrieve parameters based on depth and bucket size
-		auto params_n1 = g_expansion_params.get(max_depth, candidate.bucket_n1);
 		auto params_n2 = g_expansion_params.get(max_depth, candidate.bucket_n2);
 
-		double load_n1 = params_n1.effective_load_factor;
-		double load_n2 = params_n2.backtrace_load_factor;
-
-		size_t nodes_n1 = static_cast<size_t>(candidate.bucket_n1 * load_n1);
-		size_t nodes_n2 = static_cast<size_t>(candidate.bucket_n2 * load_n2);
+		// bucket x load, or fewer where a calibrated build's step fit below capacity
+		size_t nodes_n1 = g_expansion_params.expected_nodes(max_depth, 1, candidate.bucket_n1);
+		size_t nodes_n2 = g_expansion_params.expected_nodes(max_depth, 2, candidate.bucket_n2);
 
 		// Compute required memory (assuming no rehash)
 		size_t memory_n1 = nodes_n1 * 24 + candidate.bucket_n1 * 4;
@@ -1044,8 +1204,10 @@ LocalExpansionConfig determine_bucket_sizes(
 		// Check against available memory (margin removed - handled by outer C++ cushion)
 		if (predicted_rss <= available_memory)
 		{
+			// Same nodes in more buckets (a step that already fits) only costs memory
 			size_t total_nodes = nodes_n1 + nodes_n2;
-			if (total_nodes > best_total_nodes)
+			if (total_nodes > best_total_nodes ||
+				(total_nodes == best_total_nodes && candidate.bucket_n1 + candidate.bucket_n2 < best_config.bucket_n1 + best_config.bucket_n2))
 			{
 				best_total_nodes = total_nodes;
 				best_config = candidate;
@@ -1056,15 +1218,12 @@ LocalExpansionConfig determine_bucket_sizes(
 	if (best_config.bucket_n1 > 0 && best_config.bucket_n2 > 0)
 	{
 		// n+2 is possible
-		auto params_n1 = g_expansion_params.get(max_depth, best_config.bucket_n1);
-		auto params_n2 = g_expansion_params.get(max_depth, best_config.bucket_n2);
-
 		config.enable_n1_expansion = true;
 		config.enable_n2_expansion = true;
 		config.bucket_n1 = best_config.bucket_n1;
 		config.bucket_n2 = best_config.bucket_n2;
-		config.nodes_n1 = static_cast<size_t>(best_config.bucket_n1 * params_n1.effective_load_factor);
-		config.nodes_n2 = static_cast<size_t>(best_config.bucket_n2 * params_n2.backtrace_load_factor);
+		config.nodes_n1 = g_expansion_params.expected_nodes(max_depth, 1, best_config.bucket_n1);
+		config.nodes_n2 = g_expansion_params.expected_nodes(max_depth, 2, best_config.bucket_n2);
 
 		if (verbose)
 		{
@@ -1077,8 +1236,7 @@ LocalExpansionConfig determine_bucket_sizes(
 		for (size_t bucket : {(1 << 21), (1 << 22), (1 << 23), (1 << 24), (1 << 25), (1 << 26)})
 		{ // 2M, 4M, 8M, 16M, 32M, 64M
 			auto params = g_expansion_params.get(max_depth, bucket);
-			double load = params.effective_load_factor;
-			size_t nodes = static_cast<size_t>(bucket * load);
+			size_t nodes = g_expansion_params.expected_nodes(max_depth, 1, bucket);
 			size_t memory = nodes * 24 + bucket * 4;
 			size_t total_memory = cur_set_memory_bytes + memory;
 			size_t predicted_rss = static_cast<size_t>(total_memory * params.measured_memory_factor);
@@ -1162,14 +1320,14 @@ size_t get_n1_capacity(const LocalExpansionConfig &config)
 // Step 2: Random expansion for depth n+1
 void local_expand_step2_random_n1(
 	const LocalExpansionConfig &config,
-	const tsl::robin_set<uint64_t> &depth_n_nodes,
-	tsl::robin_set<uint64_t> &depth_n1_nodes,
+	const NodeSet &depth_n_nodes,
+	NodeSet &depth_n1_nodes,
 	const std::vector<int> &table1,
 	const std::vector<int> &table2,
 	const std::vector<int> &table3,
 	int size2,
 	int size3,
-	std::vector<std::vector<uint64_t>> &index_pairs, // for element_vector
+	std::vector<NodeVector> &index_pairs, // for element_vector
 	int depth_n,									 // current depth
 	bool verbose = true)
 {
@@ -1189,9 +1347,11 @@ void local_expand_step2_random_n1(
 		std::cout << "Depth=n nodes available: " << depth_n_nodes.size() << std::endl;
 	}
 
+	MemoryTimeline::instance().mark("Step 2: random depth " + std::to_string(depth_n + 1), depth_n_nodes.size(), depth_n_nodes.bucket_count());
+
 	// Prepare robin_set for depth=n+1
 	depth_n1_nodes.clear();
-	depth_n1_nodes = tsl::robin_set<uint64_t>(); // fully release
+	depth_n1_nodes = NodeSet(); // fully release
 	depth_n1_nodes.max_load_factor(0.9f);
 
 	// Explicitly set bucket count (prevent rehash)
@@ -1225,7 +1385,7 @@ void local_expand_step2_random_n1(
 
 	// Convert depth=n nodes to vector (for random access)
 	// Reserve capacity with reserve()
-	std::vector<uint64_t> depth_n_vec;
+	NodeVector depth_n_vec;
 	depth_n_vec.reserve(depth_n_nodes.size());
 	depth_n_vec.assign(depth_n_nodes.begin(), depth_n_nodes.end());
 
@@ -1275,7 +1435,7 @@ void local_expand_step2_random_n1(
 			next_index2 = table2[cur_index2 * 18 + move];
 			next_index3 = table3[cur_index3 * 18 + move];
 			next_index23 = next_index2 * size3 + next_index3;
-			next_node = next_index1 * size23 + next_index23;
+			next_node = g_xxcross_mirror.canonical(next_index1 * size23 + next_index23);
 
 			// Skip known nodes (find() is more efficient)
 			if (depth_n_nodes.find(next_node) != depth_n_nodes.end() ||
@@ -1362,10 +1522,10 @@ step2_end:
 // Step 3: Data Reorganization
 void local_expand_step3_reorganize(
 	const LocalExpansionConfig &config,
-	tsl::robin_set<uint64_t> &prev,
-	tsl::robin_set<uint64_t> &cur,
-	tsl::robin_set<uint64_t> &next,
-	std::vector<std::vector<uint64_t>> &index_pairs,
+	NodeSet &prev,
+	NodeSet &cur,
+	NodeSet &next,
+	std::vector<NodeVector> &index_pairs,
 	int depth_n,
 	bool verbose = true)
 {
@@ -1378,6 +1538,8 @@ void local_expand_step3_reorganize(
 		std::cout << "  next (depth=" << (depth_n + 1) << "): " << next.size() << " nodes" << std::endl;
 	}
 
+	MemoryTimeline::instance().mark("Step 3: reorganize depth " + std::to_string(depth_n), prev.size() + cur.size() + next.size(), next.bucket_count());
+
 	// Move prev (depth=n-1) into index_pairs
 	if (!prev.empty())
 	{
@@ -1388,7 +1550,7 @@ void local_expand_step3_reorganize(
 		index_pairs[depth_n - 1].shrink_to_fit();
 
 		prev.clear();
-		prev = tsl::robin_set<uint64_t>();
+		prev = NodeSet();
 		prev.max_load_factor(0.9f);
 
 		if (verbose)
@@ -1404,7 +1566,7 @@ void local_expand_step3_reorganize(
 		// If expanding n+2: keep as a robin_set (for backtracing)
 		// Move cur to prev (efficient via move semantics)
 		prev = std::move(cur);
-		cur = tsl::robin_set<uint64_t>();
+		cur = NodeSet();
 		cur.max_load_factor(0.9f);
 
 		if (verbose)
@@ -1422,7 +1584,7 @@ void local_expand_step3_reorganize(
 		index_pairs[depth_n].shrink_to_fit();
 
 		cur.clear();
-		cur = tsl::robin_set<uint64_t>();
+		cur = NodeSet();
 		cur.max_load_factor(0.9f);
 
 		if (verbose)
@@ -1435,7 +1597,7 @@ void local_expand_step3_reorganize(
 	// Move next (depth=n+1) to cur
 	cur = std::move(next);
 	next.clear();
-	next = tsl::robin_set<uint64_t>();
+	next = NodeSet();
 	next.max_load_factor(0.9f);
 
 	if (verbose)
@@ -1455,9 +1617,9 @@ void local_expand_step3_reorganize(
 size_t local_expand_step4_calculate_n2_capacity(
 	int max_depth, // BFS maximum depth (used for parameter retrieval)
 	const LocalExpansionConfig &config,
-	const tsl::robin_set<uint64_t> &prev,
-	const tsl::robin_set<uint64_t> &cur,
-	const std::vector<std::vector<uint64_t>> &index_pairs,
+	const NodeSet &prev,
+	const NodeSet &cur,
+	const std::vector<NodeVector> &index_pairs,
 	size_t total_memory_limit,
 	bool verbose = true)
 {
@@ -1647,9 +1809,9 @@ struct BacktraceExpansionResult
 BacktraceExpansionResult expand_with_backtrace_filter(
 	const LocalExpansionConfig &config,
 	size_t capacity,						  // target capacity
-	tsl::robin_set<uint64_t> &depth_n_nodes,  // depth=n (for backtrace)
-	tsl::robin_set<uint64_t> &depth_n1_nodes, // depth=n+1 (input)
-	tsl::robin_set<uint64_t> &depth_n2_nodes, // depth=n+2 (output, element_vector already attached)
+	NodeSet &depth_n_nodes,  // depth=n (for backtrace)
+	NodeSet &depth_n1_nodes, // depth=n+1 (input)
+	NodeSet &depth_n2_nodes, // depth=n+2 (output, element_vector already attached)
 	const std::vector<int> &multi_move_table_cross_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_corners,
@@ -1659,6 +1821,7 @@ BacktraceExpansionResult expand_with_backtrace_filter(
 	bool verbose = true)
 {
 	BacktraceExpansionResult result = {0, 0, 0, 0, 0, 0, false, false};
+	MemoryTimeline::instance().mark("Step 5: backtrace depth n+2", depth_n1_nodes.size(), depth_n2_nodes.bucket_count());
 
 	if (verbose)
 	{
@@ -1703,7 +1866,7 @@ BacktraceExpansionResult expand_with_backtrace_filter(
 	int size23 = size3 * size2; // F2L_corners * F2L_edges
 
 	// Random sampling: collect all nodes from depth_n1_nodes and shuffle
-	std::vector<uint64_t> sampled_nodes;
+	NodeVector sampled_nodes;
 	sampled_nodes.reserve(depth_n1_nodes.size());
 
 	if (verbose)
@@ -2018,7 +2181,8 @@ struct SearchDatabaseResult
 };
 
 // Complete Search Database Construction (BFS + Integrated Local Expansion)
-// Updates index_pairs and num_list
+// Updates index_pairs, num_list and capped_list (depths whose expansion
+// stopped at the bucket capacity)
 void build_complete_search_database(
 	int index1, int index2, int index3,
 	int size1, int size2, int size3,
@@ -2027,8 +2191,9 @@ void build_complete_search_database(
 	const std::vector<int> &multi_move_table_cross_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_corners,
-	std::vector<std::vector<uint64_t>> &index_pairs,
+	std::vector<NodeVector> &index_pairs,
 	std::vector<int> &num_list,
+	std::vector<bool> &capped_list,
 	bool verbose = true,
 	const BucketConfig& bucket_config = BucketConfig(),
 	const ResearchConfig& research_config = ResearchConfig())
@@ -2161,7 +2326,7 @@ void build_complete_search_database(
 	// ============================================================================
 	// Preparation: Load depth 6 nodes into robin_set
 	// ============================================================================
-	tsl::robin_set<uint64_t> depth_6_nodes;
+	NodeSet depth_6_nodes;
 	depth_6_nodes.max_load_factor(0.9f);
 	for (uint64_t node : index_pairs[6])
 	{
@@ -2259,6 +2424,8 @@ void build_complete_search_database(
 		std::cout << "RSS before depth_7_nodes creation: " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
 	}
 
+	MemoryTimeline::instance().mark("Phase 2: depth 7 random expansion", depth_6_nodes.size(), 0);
+
 	// Generate depth 7 nodes
 	if (index_pairs.size() <= 7)
 	{
@@ -2266,7 +2433,7 @@ void build_complete_search_database(
 	}
 	index_pairs[7].clear();
 
-	tsl::robin_set<uint64_t> depth_7_nodes;
+	NodeSet depth_7_nodes;
 	depth_7_nodes.clear();
 	depth_7_nodes.max_load_factor(0.9f);
 	depth_7_nodes.rehash(bucket_7);
@@ -2281,7 +2448,7 @@ void build_complete_search_database(
 	}
 
 	// Adaptive children per parent for depth 6→7
-	std::vector<uint64_t> depth6_vec;
+	NodeVector depth6_vec;
 	depth6_vec.reserve(depth_6_nodes.size()); // Pre-reserve to avoid reallocation spike
 	depth6_vec.assign(depth_6_nodes.begin(), depth_6_nodes.end());
 	std::mt19937_64 rng_d7(12345);
@@ -2330,6 +2497,7 @@ void build_complete_search_database(
 	const size_t last_bucket_count = depth_7_nodes.bucket_count();
 	size_t duplicate_count_d7 = 0;
 	size_t inserted_count_d7 = 0;
+	bool capped_d7 = false; // Stopped at the bucket capacity (not out of parents)
 
 	while (processed_parents < max_parent_nodes)
 	{
@@ -2391,7 +2559,7 @@ void build_complete_search_database(
 			next_index1 = multi_move_table_cross_edges[index1_tmp + move];
 			next_index2 = multi_move_table_F2L_slots_edges[index2_tmp + move];
 			next_index3 = multi_move_table_F2L_slots_corners[index3_tmp + move];
-			next_node123 = next_index1 * size23 + next_index2 * size3 + next_index3;
+			next_node123 = g_xxcross_mirror.canonical(next_index1 * size23 + next_index2 * size3 + next_index3);
 
 			// Skip if already in depth 6 or depth 7
 			if (depth_6_nodes.find(next_node123) != depth_6_nodes.end() ||
@@ -2410,11 +2578,14 @@ void build_complete_search_database(
 					std::cout << "Processed parents: " << processed_parents << std::endl;
 					std::cout << "Inserted: " << inserted_count_d7 << ", Duplicates: " << duplicate_count_d7 << std::endl;
 				}
+				capped_d7 = true;
 				goto phase2_done;
 			}
 
 			depth_7_nodes.insert(next_node123);
 			inserted_count_d7++;
+			if ((inserted_count_d7 & 0xFFFF) == 0)
+				MemoryTimeline::instance().update_counts(depth_7_nodes.size(), depth_7_nodes.bucket_count());
 
 			// Check for unexpected rehash (bucket count changed)
 			const size_t current_bucket_count = depth_7_nodes.bucket_count();
@@ -2426,6 +2597,7 @@ void build_complete_search_database(
 							  << last_bucket_count << " -> " << current_bucket_count << ")" << std::endl;
 					std::cout << "Stopping depth 7 expansion" << std::endl;
 				}
+				capped_d7 = true;
 				goto phase2_done;
 			}
 		}
@@ -2441,7 +2613,7 @@ phase2_done:
 	// depth_7_nodes no longer needed - explicitly free it
 	size_t rss_before_d7_free = get_rss_kb();
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth_7_nodes.swap(temp);
 	}
 	size_t rss_after_d7_free = get_rss_kb();
@@ -2459,6 +2631,11 @@ phase2_done:
 		num_list.resize(8, 0);
 	}
 	num_list[7] = static_cast<int>(depth_7_final_size);
+	if (capped_list.size() <= 7)
+	{
+		capped_list.resize(8, false);
+	}
+	capped_list[7] = capped_d7;
 
 	if (verbose)
 	{
@@ -2519,6 +2696,7 @@ phase2_done:
 				  << " (" << (bucket_8 / (1 << 20)) << "M)" << std::endl;
 		std::cout << "RSS before depth_8_nodes creation: " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
 	}
+	MemoryTimeline::instance().mark("Phase 3: depth 8 local expansion", depth_6_nodes.size() + index_pairs[7].size(), 0);
 
 	// Generate depth 8 nodes
 	if (index_pairs.size() <= 8)
@@ -2527,7 +2705,7 @@ phase2_done:
 	}
 	index_pairs[8].clear();
 
-	tsl::robin_set<uint64_t> depth_8_nodes;
+	NodeSet depth_8_nodes;
 	depth_8_nodes.clear();
 	depth_8_nodes.max_load_factor(0.9f);
 	depth_8_nodes.rehash(bucket_8);
@@ -2546,12 +2724,12 @@ phase2_done:
 
 	// Advance one move from all depth 7 nodes
 	// Direct vector construction (no intermediate robin_set to avoid memory spike)
-	std::vector<uint64_t> depth7_vec;
+	NodeVector depth7_vec;
 	depth7_vec.reserve(index_pairs[7].size());
 	depth7_vec.assign(index_pairs[7].begin(), index_pairs[7].end());
 	
 	// Create robin_set for depth 7 duplicate checking (used in depth 8 expansion)
-	tsl::robin_set<uint64_t> depth7_set;
+	NodeSet depth7_set;
 	depth7_set.max_load_factor(0.9f);
 	depth7_set.reserve(depth7_vec.size());
 	for (uint64_t node : depth7_vec) {
@@ -2600,6 +2778,7 @@ phase2_done:
 	size_t duplicates_from_depth6_d8 = 0;  // Counter for depth_6 duplicates
 	size_t duplicates_from_depth7_d8 = 0;  // Counter for depth_7 duplicates
 	size_t inserted_count_d8 = 0;
+	bool capped_d8 = false; // Stopped at the bucket capacity (not out of parents)
 
 	while (processed_parents_d8 < max_parent_nodes_d8)
 	{
@@ -2655,7 +2834,7 @@ phase2_done:
 			next_index1_d8 = multi_move_table_cross_edges[index1_tmp_d8 + move];
 			next_index2_d8 = multi_move_table_F2L_slots_edges[index2_tmp_d8 + move];
 			next_index3_d8 = multi_move_table_F2L_slots_corners[index3_tmp_d8 + move];
-			next_node123_d8 = next_index1_d8 * size23 + next_index2_d8 * size3 + next_index3_d8;
+			next_node123_d8 = g_xxcross_mirror.canonical(next_index1_d8 * size23 + next_index2_d8 * size3 + next_index3_d8);
 
 			// Skip if already in depth 6, depth 7, or depth 8
 			if (depth_6_nodes.find(next_node123_d8) != depth_6_nodes.end()) {
@@ -2682,11 +2861,14 @@ phase2_done:
 					std::cout << "Processed parents: " << processed_parents_d8 << std::endl;
 					std::cout << "Inserted: " << inserted_count_d8 << ", Duplicates: " << duplicate_count_d8 << std::endl;
 				}
+				capped_d8 = true;
 				goto phase3_done;
 			}
 
 			depth_8_nodes.insert(next_node123_d8);
 			inserted_count_d8++;
+			if ((inserted_count_d8 & 0xFFFF) == 0)
+				MemoryTimeline::instance().update_counts(depth_8_nodes.size(), depth_8_nodes.bucket_count());
 
 			// Check for unexpected rehash (bucket count changed)
 			const size_t current_bucket_count_d8 = depth_8_nodes.bucket_count();
@@ -2698,6 +2880,7 @@ phase2_done:
 							  << last_bucket_count_d8 << " -> " << current_bucket_count_d8 << ")" << std::endl;
 					std::cout << "Stopping depth 8 expansion" << std::endl;
 				}
+				capped_d8 = true;
 				goto phase3_done;
 			}
 		}
@@ -2714,14 +2897,14 @@ phase3_done:
 	// depth_8_nodes no longer needed - explicitly free it
 	size_t rss_before_d8_free = get_rss_kb();
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth_8_nodes.swap(temp);
 	}
 	size_t rss_after_d8_free = get_rss_kb();
 
 	// Free temporary data structures - use swap trick to actually free memory
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth7_set.swap(temp);
 	}
 	depth7_vec.clear();
@@ -2742,6 +2925,11 @@ phase3_done:
 		num_list.resize(9, 0);
 	}
 	num_list[8] = static_cast<int>(depth_8_final_size); // Use saved size before detach/clear
+	if (capped_list.size() <= 8)
+	{
+		capped_list.resize(9, false);
+	}
+	capped_list[8] = capped_d8;
 
 	if (verbose)
 	{
@@ -2778,6 +2966,7 @@ phase3_done:
 				  << " (" << (bucket_9 / (1 << 20)) << "M)" << std::endl;
 		std::cout << "RSS before depth_9_nodes creation: " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
 	}
+	MemoryTimeline::instance().mark("Phase 4: depth 9 local expansion", depth_6_nodes.size() + index_pairs[8].size(), 0);
 
 	// Generate depth 9 nodes
 	if (index_pairs.size() <= 9)
@@ -2786,7 +2975,7 @@ phase3_done:
 	}
 	index_pairs[9].clear();
 
-	tsl::robin_set<uint64_t> depth_9_nodes;
+	NodeSet depth_9_nodes;
 	depth_9_nodes.clear();
 	depth_9_nodes.max_load_factor(0.9f);
 	depth_9_nodes.rehash(bucket_9);
@@ -2802,7 +2991,7 @@ phase3_done:
 
 	// Create robin_set for depth 8 duplicate checking (used in depth 9 expansion)
 	// Use index_pairs[8] directly instead of creating temporary vector
-	tsl::robin_set<uint64_t> depth8_set;
+	NodeSet depth8_set;
 	depth8_set.max_load_factor(0.95f);  // Research mode: allow higher load
 	
 	// Calculate required buckets and round up to power of 2 to avoid rehashing
@@ -2880,6 +3069,7 @@ phase3_done:
 	size_t duplicates_from_depth6_d9 = 0;  // Counter for depth_6 duplicates
 	size_t duplicates_from_depth8_d9 = 0;  // Counter for depth_8 duplicates
 	size_t inserted_count_d9 = 0;
+	bool capped_d9 = false; // Stopped at the bucket capacity (not out of parents)
 
 	// Pre-allocate selected_moves vector outside loop to avoid repeated allocations
 	std::vector<int> selected_moves_d9;
@@ -2942,7 +3132,7 @@ phase3_done:
 			next_index1_d9 = multi_move_table_cross_edges[index1_tmp_d9 + move];
 			next_index2_d9 = multi_move_table_F2L_slots_edges[index2_tmp_d9 + move];
 			next_index3_d9 = multi_move_table_F2L_slots_corners[index3_tmp_d9 + move];
-			next_node123_d9 = next_index1_d9 * size23 + next_index2_d9 * size3 + next_index3_d9;
+			next_node123_d9 = g_xxcross_mirror.canonical(next_index1_d9 * size23 + next_index2_d9 * size3 + next_index3_d9);
 
 			// Skip if already in depth 6, depth 8, or depth 9
 			if (depth_6_nodes.find(next_node123_d9) != depth_6_nodes.end()) {
@@ -2969,11 +3159,14 @@ phase3_done:
 					std::cout << "Processed parents: " << processed_parents_d9 << std::endl;
 					std::cout << "Inserted: " << inserted_count_d9 << ", Duplicates: " << duplicate_count_d9 << std::endl;
 				}
+				capped_d9 = true;
 				goto phase4_done;
 			}
 
 			depth_9_nodes.insert(next_node123_d9);
 			inserted_count_d9++;
+			if ((inserted_count_d9 & 0xFFFF) == 0)
+				MemoryTimeline::instance().update_counts(depth_9_nodes.size(), depth_9_nodes.bucket_count());
 
 			// Check for unexpected rehash (bucket count changed)
 			const size_t current_bucket_count_d9 = depth_9_nodes.bucket_count();
@@ -2985,6 +3178,7 @@ phase3_done:
 							  << last_bucket_count_d9 << " -> " << current_bucket_count_d9 << ")" << std::endl;
 					std::cout << "Stopping depth 9 expansion" << std::endl;
 				}
+				capped_d9 = true;
 				goto phase4_done;
 			}
 		}
@@ -3001,7 +3195,7 @@ phase4_done:
 	// Free temporary data structures - use swap trick to actually free memory
 	size_t rss_before_phase4_cleanup = get_rss_kb();
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth8_set.swap(temp);
 	}
 	size_t rss_after_depth8_cleanup = get_rss_kb();
@@ -3012,7 +3206,7 @@ phase4_done:
 		std::cout << "Freeing depth_6_nodes after Phase 4 completion" << std::endl;
 	}
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth_6_nodes.swap(temp);
 	}
 	size_t rss_after_depth6_free = get_rss_kb();
@@ -3022,11 +3216,16 @@ phase4_done:
 		num_list.resize(10, 0);
 	}
 	num_list[9] = static_cast<int>(depth_9_nodes.size());
+	if (capped_list.size() <= 9)
+	{
+		capped_list.resize(10, false);
+	}
+	capped_list[9] = capped_d9;
 
 	// depth_9_nodes no longer needed - explicitly free it
 	size_t rss_before_d9_free = get_rss_kb();
 	{
-		tsl::robin_set<uint64_t> temp;
+		NodeSet temp;
 		depth_9_nodes.swap(temp);
 	}
 	size_t rss_after_d9_free = get_rss_kb();
@@ -3066,10 +3265,22 @@ phase4_done:
 		log_emscripten_heap("Phase 4 Complete");
 		
 		// Release allocator cache before Phase 5 to reduce memory baseline
+		// (arena blocks are already returned to the OS when released)
 #ifndef __EMSCRIPTEN__
-		malloc_trim(0);
-		std::cout << "RSS after malloc_trim (before Phase 5): " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
+		if (!NodeArena::instance().enabled())
+		{
+			malloc_trim(0);
+			std::cout << "RSS after malloc_trim (before Phase 5): " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
+		}
 #endif
+		if (NodeArena::instance().enabled())
+		{
+			NodeArena::Stats arena_stats = NodeArena::instance().stats();
+			std::cout << "Node arena (before Phase 5): live=" << (arena_stats.live_bytes / 1024.0 / 1024.0)
+					  << " MB, cached=" << (arena_stats.cached_bytes / 1024.0 / 1024.0)
+					  << " MB, reused=" << arena_stats.blocks_reused << "/"
+					  << (arena_stats.blocks_reused + arena_stats.blocks_created) << " blocks" << std::endl;
+		}
 	}
 
 	// ============================================================================
@@ -3083,6 +3294,7 @@ phase4_done:
 			std::cout << "Note: Adaptive children per parent based on load factor" << std::endl;
 			log_emscripten_heap("Phase 5 Start");
 		}
+		MemoryTimeline::instance().mark("Phase 5: depth 10 local expansion", index_pairs[9].size(), 0);
 
 		size_t bucket_d10 = bucket_config.custom_bucket_10;
 		size_t rss_before_d10_nodes = get_rss_kb();
@@ -3106,7 +3318,7 @@ phase4_done:
 		}
 
 		// Initialize depth 10 bucket
-		tsl::robin_set<uint64_t> depth_10_nodes;
+		NodeSet depth_10_nodes;
 		depth_10_nodes.max_load_factor(0.9f);
 		depth_10_nodes.reserve(bucket_d10);
 
@@ -3140,7 +3352,7 @@ phase4_done:
 
 		// Build depth9_set from index_pairs[9] for duplicate detection
 		// Use same pattern as Phase 4 to avoid memory spikes
-		tsl::robin_set<uint64_t> depth9_set;
+		NodeSet depth9_set;
 		depth9_set.max_load_factor(0.95f);
 		size_t depth9_size = index_pairs[9].size();
 		
@@ -3238,7 +3450,7 @@ phase4_done:
 				next_index1_d10 = multi_move_table_cross_edges[index1_tmp_d10 + move];
 				next_index2_d10 = multi_move_table_F2L_slots_edges[index2_tmp_d10 + move];
 				next_index3_d10 = multi_move_table_F2L_slots_corners[index3_tmp_d10 + move];
-				next_node123_d10 = next_index1_d10 * size23 + next_index2_d10 * size3 + next_index3_d10;
+				next_node123_d10 = g_xxcross_mirror.canonical(next_index1_d10 * size23 + next_index2_d10 * size3 + next_index3_d10);
 
 				// Check if already in depth 9
 				if (depth9_set.find(next_node123_d10) != depth9_set.end())
@@ -3252,6 +3464,8 @@ phase4_done:
 				if (result.second)
 				{
 					inserted_count_d10++;
+					if ((inserted_count_d10 & 0xFFFF) == 0)
+						MemoryTimeline::instance().update_counts(depth_10_nodes.size(), depth_10_nodes.bucket_count());
 					
 					// Periodic RSS check during expansion (every 500K nodes)
 					if (verbose && inserted_count_d10 % 500000 == 0)
@@ -3298,7 +3512,7 @@ phase4_done:
 		
 		// Free depth9_set
 		{
-			tsl::robin_set<uint64_t> temp;
+			NodeSet temp;
 			depth9_set.swap(temp);
 		}
 		
@@ -3313,7 +3527,7 @@ phase4_done:
 		// Free depth_10_nodes (already detached)
 		size_t rss_before_d10_free = get_rss_kb();
 		{
-			tsl::robin_set<uint64_t> temp;
+			NodeSet temp;
 			depth_10_nodes.swap(temp);
 		}
 		
@@ -3329,6 +3543,12 @@ phase4_done:
 			num_list.resize(11, 0);
 		}
 		num_list[10] = static_cast<int>(depth_10_final_size);
+		// Phase 5 runs until its target load or a rehash: always capped
+		if (capped_list.size() <= 10)
+		{
+			capped_list.resize(11, false);
+		}
+		capped_list[10] = true;
 
 		if (verbose)
 		{
@@ -3362,6 +3582,7 @@ phase5_skip:
 	{
 		std::cout << "\nStep 6: Final Cleanup" << std::endl;
 	}
+	MemoryTimeline::instance().mark("Step 6: final cleanup", 0, 0);
 
 	// prev_set, cur_set, next_set are only used within existing code (currently commented out)
 
@@ -3447,7 +3668,7 @@ int run_bfs_phase(
 	const std::vector<int> &multi_move_table_cross_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_corners,
-	std::vector<std::vector<uint64_t>> &index_pairs,
+	std::vector<NodeVector> &index_pairs,
 	std::vector<int> &num_list,
 	bool verbose = true)
 {
@@ -3502,7 +3723,7 @@ LocalExpansionResults run_local_expansion_steps_1_to_4(
 	const std::vector<int> &multi_move_table_cross_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_edges,
 	const std::vector<int> &multi_move_table_F2L_slots_corners,
-	std::vector<std::vector<uint64_t>> &index_pairs,
+	std::vector<NodeVector> &index_pairs,
 	bool verbose = true)
 {
 	LocalExpansionResults results;
@@ -3523,7 +3744,7 @@ LocalExpansionResults run_local_expansion_steps_1_to_4(
 	}
 
 	// Restore nodes at depth=n into robin_set
-	tsl::robin_set<uint64_t> depth_n_nodes;
+	NodeSet depth_n_nodes;
 	depth_n_nodes.max_load_factor(0.9f);
 
 	if (verbose)
@@ -3595,7 +3816,7 @@ LocalExpansionResults run_local_expansion_steps_1_to_4(
 			std::cout << "\n=== Step 2: Random Expansion ===" << std::endl;
 		}
 
-		tsl::robin_set<uint64_t> depth_n1_nodes;
+		NodeSet depth_n1_nodes;
 		depth_n1_nodes.max_load_factor(0.9f);
 
 		local_expand_step2_random_n1(
@@ -3628,7 +3849,7 @@ LocalExpansionResults run_local_expansion_steps_1_to_4(
 			std::cout << "\n=== Step 3: Data Reorganization ===" << std::endl;
 		}
 
-		tsl::robin_set<uint64_t> prev_set, cur_set, next_set;
+		NodeSet prev_set, cur_set, next_set;
 		prev_set.max_load_factor(0.9f);
 		cur_set.max_load_factor(0.9f);
 		next_set.max_load_factor(0.9f);
@@ -3816,6 +4037,107 @@ std::vector<bool> create_ma_table()
 	return ma;
 }
 
+// =============================================================================
+// Depth Constraints
+// =============================================================================
+//
+// Conjunction of depth ranges over the solver's tables, used by
+// generate_constrained_batch(). Syntax: comma separated "<table><op><depth>"
+// terms with op one of = >= <= > <, e.g. "xxcross=8,cross>=6,BR>=5".
+//   xxcross  optimal depth of the whole goal (selects the database buckets)
+//   cross    prune_table1 (cross edges)
+//   pairs    prune_table23_couple (both slot pairs together)
+//   BL, BR / FR   one slot pair alone (slot names of the goal, adj / non-adj)
+// Every term except xxcross is checked with table lookups before the full
+// search that confirms the xxcross depth runs.
+
+enum ConstraintTable
+{
+	CONSTRAINT_XXCROSS,
+	CONSTRAINT_CROSS,
+	CONSTRAINT_PAIRS,
+	CONSTRAINT_SLOT1,
+	CONSTRAINT_SLOT2,
+	CONSTRAINT_TABLES
+};
+
+struct DepthConstraints
+{
+	int lo[CONSTRAINT_TABLES];
+	int hi[CONSTRAINT_TABLES];
+
+	DepthConstraints()
+	{
+		std::fill(lo, lo + CONSTRAINT_TABLES, 0);
+		std::fill(hi, hi + CONSTRAINT_TABLES, 255);
+	}
+
+	bool accepts(int table, int depth) const
+	{
+		return depth >= lo[table] && depth <= hi[table];
+	}
+
+	// Returns false (and reports the term) on a syntax error or unknown table
+	bool parse(const std::string &text, const std::string &slot1_name, const std::string &slot2_name)
+	{
+		std::istringstream iss(text);
+		std::string term;
+		while (std::getline(iss, term, ','))
+		{
+			term.erase(std::remove(term.begin(), term.end(), ' '), term.end());
+			if (term.empty())
+			{
+				continue;
+			}
+			size_t op_pos = term.find_first_of("<>=");
+			size_t num_pos = term.find_first_not_of("<>=", op_pos);
+			if (op_pos == 0 || op_pos == std::string::npos || num_pos == std::string::npos)
+			{
+				std::cerr << "Warning: Invalid constraint '" << term << "' (expected table<op>depth)" << std::endl;
+				return false;
+			}
+			std::string name = term.substr(0, op_pos);
+			std::string op = term.substr(op_pos, num_pos - op_pos);
+			int depth = std::atoi(term.substr(num_pos).c_str());
+			int table;
+			if (name == "xxcross")
+				table = CONSTRAINT_XXCROSS;
+			else if (name == "cross")
+				table = CONSTRAINT_CROSS;
+			else if (name == "pairs")
+				table = CONSTRAINT_PAIRS;
+			else if (name == slot1_name)
+				table = CONSTRAINT_SLOT1;
+			else if (name == slot2_name)
+				table = CONSTRAINT_SLOT2;
+			else
+			{
+				std::cerr << "Warning: Unknown constraint table '" << name << "'" << std::endl;
+				return false;
+			}
+			if (op == "=")
+			{
+				lo[table] = std::max(lo[table], depth);
+				hi[table] = std::min(hi[table], depth);
+			}
+			else if (op == ">=")
+				lo[table] = std::max(lo[table], depth);
+			else if (op == ">")
+				lo[table] = std::max(lo[table], depth + 1);
+			else if (op == "<=")
+				hi[table] = std::min(hi[table], depth);
+			else if (op == "<")
+				hi[table] = std::min(hi[table], depth - 1);
+			else
+			{
+				std::cerr << "Warning: Invalid constraint operator in '" << term << "'" << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
 struct xxcross_search
 {
 	std::vector<int> sol;
@@ -3832,8 +4154,9 @@ struct xxcross_search
 	std::vector<int> multi_move_table_F2L_slots_corners;
 	std::vector<unsigned char> prune_table1;
 	std::vector<unsigned char> prune_table23_couple;
-	std::vector<std::vector<uint64_t>> index_pairs;
+	std::vector<NodeVector> index_pairs;
 	std::vector<int> num_list;
+	std::vector<bool> capped_list; // [depth] expansion stopped at the bucket capacity
 	std::vector<int> alg;
 	std::vector<std::string> restrict;
 	std::vector<int> move_restrict;
@@ -3857,10 +4180,27 @@ struct xxcross_search
 	std::vector<int> F2L_slots_edges_goal_tmp;
 	std::vector<int> F2L_slots_corners_goal_tmp;
 	
+	// Quiet mode: suppresses per-call / per-attempt logging in search and scramble generation
+	bool quiet = false;
+	
+	// Packed output of the last batch call: [n][move_1]...[move_n] per scramble (move ids 0-17)
+	std::vector<unsigned char> batch_buffer;
+	
+	// Single slot pair distances (constrained sampling): slot_pair_table[k][edge * 24 + corner]
+	// with edge / corner numbered as in edge_move_table / corner_move_table
+	std::vector<unsigned char> slot_pair_table[2];
+	// Pieces of slot k in each index2 / index3: slot_edges[index2 * 2 + k], slot_corners[index3 * 2 + k]
+	std::vector<unsigned char> slot_edges;
+	std::vector<unsigned char> slot_corners;
+	std::string slot_names[2];
+	
 	// Configuration storage
 	BucketConfig bucket_config_;
 	ResearchConfig research_config_;
 	
+	// L/R mirror reduction of the stored nodes (adjacent slots only)
+	XxcrossMirror mirror_;
+	
 	// Helper functions for custom bucket configuration
 	static BucketConfig create_custom_bucket_config(int b7_mb, int b8_mb, int b9_mb, int b10_mb) {
 		BucketConfig config;
@@ -3895,6 +4235,9 @@ struct xxcross_search
 	               const ResearchConfig& research_config = ResearchConfig())
 		: bucket_config_(bucket_config), research_config_(research_config)
 	{
+		// Select the node container allocator before any NodeSet/NodeVector is built
+		NodeArena::instance().set_enabled(research_config_.use_node_arena);
+
 		// ============================================================================
 		// Phase 1: Configuration Validation
 		// ============================================================================
@@ -3913,6 +4256,7 @@ struct xxcross_search
 			std::cout << "  dry_run: " << research_config_.dry_run << std::endl;
 			std::cout << "  enable_custom_buckets: " << research_config_.enable_custom_buckets << std::endl;
 			std::cout << "  high_memory_wasm_mode: " << research_config_.high_memory_wasm_mode << std::endl;
+			std::cout << "  use_node_arena: " << NodeArena::instance().enabled() << std::endl;
 			std::cout << "  developer_memory_limit_mb: " << research_config_.developer_memory_limit_mb << std::endl;
 		}
 		
@@ -3941,13 +4285,15 @@ struct xxcross_search
 		
 		BucketModel selected_model = bucket_config_.model;
 		size_t bucket_d7 = 0, bucket_d8 = 0, bucket_d9 = 0, bucket_d10 = 0;
+		// Calibration records of the mirror mode this build will use (mirror_.init)
+		const bool mirrored = adj && research_config_.enable_mirror_reduction;
 		
 		if (selected_model == BucketModel::AUTO) {
 			// Auto-select based on memory budget
 			size_t budget_mb = (bucket_config_.memory_budget_mb > 0) 
 			                 ? bucket_config_.memory_budget_mb 
 			                 : MEMORY_LIMIT_MB;
-			selected_model = select_model(budget_mb);
+			selected_model = select_model(budget_mb, mirrored);
 			
 			if (verbose) {
 				std::cout << "\nAuto-selected model based on budget " << budget_mb << " MB" << std::endl;
@@ -3993,11 +4339,11 @@ struct xxcross_search
 			}
 		} else {
 			// Use preset model
-			const auto& measured_data = get_measured_data();
+			const auto& measured_data = get_measured_data(mirrored);
 			
 			ModelData model_data;
 			if (selected_model == BucketModel::ULTRA_HIGH) {
-				model_data = get_ultra_high_config();
+				model_data = get_ultra_high_config(mirrored);
 			} else if (measured_data.find(selected_model) != measured_data.end()) {
 				model_data = measured_data.at(selected_model);
 			} else {
@@ -4007,6 +4353,15 @@ struct xxcross_search
 			bucket_d7 = model_data.d7;
 			bucket_d8 = model_data.d8;
 			bucket_d9 = model_data.d9;
+			bucket_d10 = model_data.d10;
+			
+			// The database builder works on explicit buckets: run the preset as CUSTOM
+			bucket_config_.model = BucketModel::CUSTOM;
+			bucket_config_.custom_bucket_7 = bucket_d7;
+			bucket_config_.custom_bucket_8 = bucket_d8;
+			bucket_config_.custom_bucket_9 = bucket_d9;
+			bucket_config_.custom_bucket_10 = bucket_d10;
+			research_config_.enable_custom_buckets = true;
 			
 			if (verbose) {
 				std::cout << "Using preset model with buckets: " 
@@ -4015,9 +4370,9 @@ struct xxcross_search
 				          << (bucket_d9 >> 20) << "M" << std::endl;
 				
 				if (model_data.measured_rss_mb > 0) {
-					std::cout << "Measured RSS: " << model_data.measured_rss_mb << " MB" << std::endl;
+					std::cout << "Measured RSS: " << model_data.measured_rss_mb << " MB (calibrated)" << std::endl;
 				} else {
-					std::cout << "WARNING: No measurement data available yet (spike fixes pending)" << std::endl;
+					std::cout << "WARNING: No calibration data for this model (run CALIBRATE=presets)" << std::endl;
 				}
 			}
 		}
@@ -4064,6 +4419,12 @@ struct xxcross_search
 
 		create_prune_table(index1, size1, 8, multi_move_table_cross_edges, prune_table1);
 		create_prune_table2(index2, index3, size2, size3, 9, multi_move_table_F2L_slots_edges, multi_move_table_F2L_slots_corners, prune_table23_couple);
+		create_slot_pair_tables(adj);
+
+		mirror_.init(research_config_.enable_mirror_reduction, cross_edges_goal, F2L_slots_edges_goal, F2L_slots_corners_goal, size1, size2, size3);
+		g_xxcross_mirror = mirror_;
+		g_expansion_params.set_mirrored(mirror_.enabled, CalibrationTable::instance());
+		std::cout << "Mirror reduction: " << (mirror_.enabled ? "enabled (L/R)" : "disabled") << std::endl;
 
 		size_t move_table_memory =
 			multi_move_table_cross_edges.size() * sizeof(int) +
@@ -4095,10 +4456,21 @@ struct xxcross_search
 			multi_move_table_F2L_slots_corners,
 			index_pairs,
 			num_list,
+			capped_list,
 			verbose,
 			bucket_config_,    // Pass bucket config
 			research_config_); // Pass research config
 
+		// Construction is done: hand cached arena blocks back (munmap natively,
+		// back to the malloc heap on WASM so search-time allocations can use it)
+		NodeArena::instance().release_cached();
+		{
+			size_t total_nodes = 0;
+			for (const auto &vec : index_pairs)
+				total_nodes += vec.size();
+			MemoryTimeline::instance().mark("Construction complete", total_nodes, 0);
+		}
+
 		// reached_depth is calculated from the size of index_pairs
 		reached_depth = static_cast<int>(index_pairs.size()) - 1;
 
@@ -4142,6 +4514,22 @@ struct xxcross_search
 #else
 			rss_after_trim_kb = rss_before_trim_kb;
 #endif
+			if (NodeArena::instance().enabled())
+			{
+				NodeArena::Stats arena_stats = NodeArena::instance().stats();
+				std::cout << "\n[Node Arena]" << std::endl;
+				std::cout << "  Live: " << (arena_stats.live_bytes / 1024.0 / 1024.0) << " MB"
+						  << " (peak " << (arena_stats.peak_live_bytes / 1024.0 / 1024.0) << " MB)" << std::endl;
+				std::cout << "  Cached for reuse: " << (arena_stats.cached_bytes / 1024.0 / 1024.0) << " MB"
+#ifndef __EMSCRIPTEN__
+						  << " (not resident)"
+#endif
+						  << std::endl;
+				std::cout << "  Blocks: created=" << arena_stats.blocks_created
+						  << ", reused=" << arena_stats.blocks_reused
+						  << ", released=" << arena_stats.blocks_released
+						  << ", trimmed=" << arena_stats.blocks_trimmed << std::endl;
+			}
 			
 			// Calculate theoretical memory usage
 			size_t index_pairs_bytes = 0;
@@ -4312,9 +4700,12 @@ struct xxcross_search
 		int len = std::stoi(arg_length);
 		
 		// Validate depth range
-		std::cout << "get_xxcross_scramble called with len=" << len << std::endl;
-		std::cout << "num_list[" << len << "] = " << num_list[len] << std::endl;
-		std::cout << "index_pairs[" << len << "].size() = " << index_pairs[len].size() << std::endl;
+		if (!quiet)
+		{
+			std::cout << "get_xxcross_scramble called with len=" << len << std::endl;
+			std::cout << "num_list[" << len << "] = " << num_list[len] << std::endl;
+			std::cout << "index_pairs[" << len << "].size() = " << index_pairs[len].size() << std::endl;
+		}
 		
 		if (num_list[len] == 0 || index_pairs[len].empty())
 		{
@@ -4333,13 +4724,17 @@ struct xxcross_search
 		{
 			sol.clear();
 			// Select random node from depth len
-			uint64_t xxcross_index = index_pairs[len][distribution(generator)];
+			uint64_t xxcross_index;
+			do
+			{
+				xxcross_index = index_pairs[len][distribution(generator)];
+			} while (!mirror_.random_image(xxcross_index, generator, xxcross_index));
 			index1 = static_cast<int>(xxcross_index / (size2 * size3));
 			int index23packed = static_cast<int>(xxcross_index % (size2 * size3));
 			index2 = index23packed / size3;
 			index3 = index23packed % size3;
 			
-			if (attempt == 0) {
+			if (attempt == 0 && !quiet) {
 				std::cout << "Selected xxcross_index=" << xxcross_index 
 				          << ", index1=" << index1 << ", index2=" << index2 
 				          << ", index3=" << index3 << std::endl;
@@ -4368,15 +4763,18 @@ struct xxcross_search
 			// Check if actual depth matches requested depth
 			if (actual_depth == len)
 			{
-				std::cout << "✓ Found valid node at attempt " << (attempt + 1) 
-				          << ": requested=" << len << ", actual=" << actual_depth << std::endl;
-				std::cout << "XXCross Solution from get_xxcross_scramble: " << AlgToString(sol) << std::endl;
+				if (!quiet)
+				{
+					std::cout << "✓ Found valid node at attempt " << (attempt + 1) 
+					          << ": requested=" << len << ", actual=" << actual_depth << std::endl;
+					std::cout << "XXCross Solution from get_xxcross_scramble: " << AlgToString(sol) << std::endl;
+				}
 				tmp = AlgToString(sol);
 				return tmp;
 			}
 			
 			// Log mismatch and retry
-			if (attempt < 5 || (attempt + 1) % 10 == 0) {
+			if (!quiet && (attempt < 5 || (attempt + 1) % 10 == 0)) {
 				std::cout << "✗ Attempt " << (attempt + 1) << ": requested=" << len 
 				          << ", actual=" << actual_depth << " - retrying" << std::endl;
 			}
@@ -4412,7 +4810,10 @@ struct xxcross_search
 		prune23_tmp = prune_table23_couple[index2 * size3 + index3];
 		if (prune1_tmp == 0 && prune23_tmp == 0)
 		{
-			std::cout << "Already solved state." << std::endl;
+			if (!quiet)
+			{
+				std::cout << "Already solved state." << std::endl;
+			}
 			return "";
 		}
 		index1 *= 18;
@@ -4425,10 +4826,379 @@ struct xxcross_search
 				break;
 			}
 		}
-		std::cout << "XXCross Solution from start_search: " << AlgToString(sol) << std::endl;
+		if (!quiet)
+		{
+			std::cout << "XXCross Solution from start_search: " << AlgToString(sol) << std::endl;
+		}
 		return tmp;
 	}
 
+	// ============================================================================
+	// Batch Scramble Generation
+	// ============================================================================
+
+	void set_quiet(bool enable)
+	{
+		quiet = enable;
+	}
+
+	// Re-entrant variant of depth_limited_search: keeps the path and temporaries on
+	// the caller's stack so that batch workers can share the (read-only) tables
+	bool depth_limited_search_local(int arg_index1, int arg_index2, int arg_index3, int depth, int prev, std::vector<int> &path) const
+	{
+		int next_index1, next_index2, next_index3, prune1, prune23;
+		for (int i : move_restrict)
+		{
+			if (ma[prev + i])
+			{
+				continue;
+			}
+			next_index2 = multi_move_table_F2L_slots_edges[arg_index2 + i];
+			next_index3 = multi_move_table_F2L_slots_corners[arg_index3 + i];
+			prune23 = prune_table23_couple[next_index2 * size3 + next_index3];
+			if (prune23 >= depth)
+			{
+				continue;
+			}
+			next_index1 = multi_move_table_cross_edges[arg_index1 + i];
+			prune1 = prune_table1[next_index1];
+			if (prune1 >= depth)
+			{
+				continue;
+			}
+			path.emplace_back(i);
+			if (depth == 1)
+			{
+				if (prune1 == 0 && prune23 == 0)
+				{
+					return true;
+				}
+			}
+			else if (depth_limited_search_local(next_index1 * 18, next_index2 * 18, next_index3 * 18, depth - 1, i * 18, path))
+			{
+				return true;
+			}
+			path.pop_back();
+		}
+		return false;
+	}
+
+	// Draw nodes from index_pairs[len] until one has optimal depth exactly len
+	// (same retry policy as get_xxcross_scramble, but silent and re-entrant)
+	bool sample_exact_depth(int len, std::mt19937 &rng, std::vector<int> &path) const
+	{
+		const int max_attempts = 100;
+		const uint64_t size23 = static_cast<uint64_t>(size2) * size3;
+		std::uniform_int_distribution<size_t> distribution(0, index_pairs[len].size() - 1);
+		for (int attempt = 0; attempt < max_attempts; ++attempt)
+		{
+			uint64_t xxcross_index;
+			do
+			{
+				xxcross_index = index_pairs[len][distribution(rng)];
+			} while (!mirror_.random_image(xxcross_index, rng, xxcross_index));
+			int i1 = static_cast<int>(xxcross_index / size23);
+			int i23 = static_cast<int>(xxcross_index % size23);
+			int i2 = i23 / size3;
+			int i3 = i23 % size3;
+			// Depths below the prune lower bound cannot succeed, skip them
+			int lower_bound = std::max<int>(prune_table1[i1], prune_table23_couple[i2 * size3 + i3]);
+			if (lower_bound > len)
+			{
+				continue;
+			}
+			path.clear();
+			for (int d = std::max(1, lower_bound); d <= len; ++d)
+			{
+				if (depth_limited_search_local(i1 * 18, i2 * 18, i3 * 18, d, 324, path))
+				{
+					if (d == len)
+					{
+						return true;
+					}
+					break;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Append up to count scrambles of exact depth to batch_buffer, returns the number produced
+	int append_scramble_batch(int count, int depth, int num_threads)
+	{
+		if (count <= 0)
+		{
+			return 0;
+		}
+		if (depth < 1 || depth >= static_cast<int>(index_pairs.size()) || index_pairs[depth].empty())
+		{
+			std::cout << "ERROR: No states available at depth " << depth << std::endl;
+			return 0;
+		}
+
+		int threads = 1;
+#ifndef __EMSCRIPTEN__
+		threads = (num_threads > 0) ? num_threads : static_cast<int>(std::thread::hardware_concurrency());
+		threads = std::max(1, std::min(threads, count));
+#else
+		(void)num_threads;
+#endif
+
+		// Seeds are drawn up front so results only depend on the solver's generator
+		std::vector<uint32_t> seeds(threads);
+		for (int t = 0; t < threads; ++t)
+		{
+			seeds[t] = generator();
+		}
+		std::vector<std::vector<unsigned char>> chunks(threads);
+		std::vector<int> produced(threads, 0);
+
+		auto worker = [&](int t, int quota)
+		{
+			std::mt19937 rng(seeds[t]);
+			std::vector<int> path;
+			path.reserve(depth);
+			std::vector<unsigned char> &out = chunks[t];
+			out.reserve(static_cast<size_t>(quota) * (depth + 1));
+			for (int k = 0; k < quota; ++k)
+			{
+				if (!sample_exact_depth(depth, rng, path))
+				{
+					continue;
+				}
+				out.push_back(static_cast<unsigned char>(path.size()));
+				for (int move : path)
+				{
+					out.push_back(static_cast<unsigned char>(move));
+				}
+				produced[t]++;
+			}
+		};
+
+#ifndef __EMSCRIPTEN__
+		if (threads > 1)
+		{
+			std::vector<std::thread> pool;
+			pool.reserve(threads);
+			for (int t = 0; t < threads; ++t)
+			{
+				int quota = count / threads + (t < count % threads ? 1 : 0);
+				pool.emplace_back(worker, t, quota);
+			}
+			for (auto &th : pool)
+			{
+				th.join();
+			}
+		}
+		else
+#endif
+		{
+			worker(0, count);
+		}
+
+		int total = 0;
+		for (int t = 0; t < threads; ++t)
+		{
+			batch_buffer.insert(batch_buffer.end(), chunks[t].begin(), chunks[t].end());
+			total += produced[t];
+		}
+		if (!quiet)
+		{
+			std::cout << "Batch: depth=" << depth << ", requested=" << count
+			          << ", produced=" << total << ", threads=" << threads << std::endl;
+		}
+		return total;
+	}
+
+	// Generate count scrambles of exact optimal depth in one call
+	// Result is left in batch_buffer (see get_batch_buffer / batch_to_string)
+	int generate_scramble_batch(int count, int depth, int num_threads)
+	{
+		batch_buffer.clear();
+		return append_scramble_batch(count, depth, num_threads);
+	}
+
+	// Same as generate_scramble_batch for a depth histogram, e.g. "7:100,8:200,9:50"
+	// Scrambles are emitted grouped by depth in the order given
+	int generate_scramble_batch_histogram(std::string histogram, int num_threads)
+	{
+		batch_buffer.clear();
+		int total = 0;
+		std::istringstream iss(histogram);
+		std::string entry;
+		while (std::getline(iss, entry, ','))
+		{
+			size_t colon = entry.find(':');
+			if (colon == std::string::npos)
+			{
+				std::cerr << "Warning: Invalid histogram entry '" << entry << "' (expected depth:count)" << std::endl;
+				continue;
+			}
+			int depth = std::atoi(entry.substr(0, colon).c_str());
+			int count = std::atoi(entry.substr(colon + 1).c_str());
+			total += append_scramble_batch(count, depth, num_threads);
+		}
+		return total;
+	}
+
+	// Distances of each slot pair alone, and the pieces of each slot in every
+	// index2 / index3 (a few KB, built once)
+	void create_slot_pair_tables(bool adj)
+	{
+		slot_names[0] = "BL";
+		slot_names[1] = adj ? "BR" : "FR";
+		std::vector<int> p(2);
+		slot_edges.assign(size2 * 2, 0);
+		for (int i = 0; i < size2; ++i)
+		{
+			index_to_array(p, i, 2, 2, 12);
+			slot_edges[i * 2] = static_cast<unsigned char>(p[0] / 18);
+			slot_edges[i * 2 + 1] = static_cast<unsigned char>(p[1] / 18);
+		}
+		slot_corners.assign(size3 * 2, 0);
+		for (int i = 0; i < size3; ++i)
+		{
+			index_to_array(p, i, 2, 3, 8);
+			slot_corners[i * 2] = static_cast<unsigned char>(p[0] / 18);
+			slot_corners[i * 2 + 1] = static_cast<unsigned char>(p[1] / 18);
+		}
+		for (int k = 0; k < 2; ++k)
+		{
+			slot_pair_table[k] = std::vector<unsigned char>(24 * 24, 255);
+			create_prune_table2(F2L_slots_edges_goal[k], F2L_slots_corners_goal[k], 24, 24, 20, edge_move_table, corner_move_table, slot_pair_table[k]);
+		}
+	}
+
+	// Draw nodes (bucket from depth_pick) until one meets the constraints and
+	// has optimal depth exactly its bucket. Rejected draws cost table lookups
+	// only; the search runs on accepted ones. draws counts the nodes drawn.
+	bool sample_constrained(const DepthConstraints &constraints, std::discrete_distribution<int> &depth_pick, int max_draws, std::mt19937 &rng, std::vector<int> &path, long long &draws) const
+	{
+		const uint64_t size23 = static_cast<uint64_t>(size2) * size3;
+		for (int attempt = 0; attempt < max_draws; ++attempt)
+		{
+			draws++;
+			int len = depth_pick(rng);
+			std::uniform_int_distribution<size_t> distribution(0, index_pairs[len].size() - 1);
+			uint64_t xxcross_index;
+			if (!mirror_.random_image(index_pairs[len][distribution(rng)], rng, xxcross_index))
+			{
+				continue;
+			}
+			int i1 = static_cast<int>(xxcross_index / size23);
+			int i23 = static_cast<int>(xxcross_index % size23);
+			int i2 = i23 / size3;
+			int i3 = i23 % size3;
+			int cross_depth = prune_table1[i1];
+			int pairs_depth = prune_table23_couple[i2 * size3 + i3];
+			if (!constraints.accepts(CONSTRAINT_CROSS, cross_depth) ||
+				!constraints.accepts(CONSTRAINT_PAIRS, pairs_depth) ||
+				!constraints.accepts(CONSTRAINT_SLOT1, slot_pair_table[0][slot_edges[i2 * 2] * 24 + slot_corners[i3 * 2]]) ||
+				!constraints.accepts(CONSTRAINT_SLOT2, slot_pair_table[1][slot_edges[i2 * 2 + 1] * 24 + slot_corners[i3 * 2 + 1]]))
+			{
+				continue;
+			}
+			int lower_bound = std::max(cross_depth, pairs_depth);
+			if (lower_bound > len)
+			{
+				continue;
+			}
+			path.clear();
+			for (int d = std::max(1, lower_bound); d <= len; ++d)
+			{
+				if (depth_limited_search_local(i1 * 18, i2 * 18, i3 * 18, d, 324, path))
+				{
+					if (d == len)
+					{
+						return true;
+					}
+					break;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Up to count scrambles meeting the constraints (see DepthConstraints), each
+	// from at most max_draws drawn nodes. Depths are drawn in proportion to the
+	// database buckets and a rejected self-symmetric node (see XxcrossMirror)
+	// counts as a draw, so accepted scrambles are uniform over the states that
+	// satisfy the constraints. Result in batch_buffer as for
+	// generate_scramble_batch; returns the number produced
+	int generate_constrained_batch(std::string constraints, int count, int max_draws)
+	{
+		batch_buffer.clear();
+		DepthConstraints parsed;
+		if (!parsed.parse(constraints, slot_names[0], slot_names[1]))
+		{
+			return 0;
+		}
+		std::vector<double> weights(index_pairs.size(), 0.0);
+		bool any_depth = false;
+		for (size_t d = 1; d < index_pairs.size(); ++d)
+		{
+			if (parsed.accepts(CONSTRAINT_XXCROSS, static_cast<int>(d)) && !index_pairs[d].empty())
+			{
+				weights[d] = static_cast<double>(index_pairs[d].size());
+				any_depth = true;
+			}
+		}
+		if (!any_depth)
+		{
+			std::cout << "ERROR: No states available for constraints '" << constraints << "'" << std::endl;
+			return 0;
+		}
+		std::discrete_distribution<int> depth_pick(weights.begin(), weights.end());
+		std::vector<int> path;
+		long long draws = 0;
+		int produced = 0;
+		for (int k = 0; k < count; ++k)
+		{
+			if (!sample_constrained(parsed, depth_pick, max_draws, generator, path, draws))
+			{
+				continue;
+			}
+			batch_buffer.push_back(static_cast<unsigned char>(path.size()));
+			for (int move : path)
+			{
+				batch_buffer.push_back(static_cast<unsigned char>(move));
+			}
+			produced++;
+		}
+		if (!quiet)
+		{
+			std::cout << "Constrained batch: '" << constraints << "', requested=" << count
+			          << ", produced=" << produced << ", draws=" << draws << std::endl;
+		}
+		return produced;
+	}
+
+	// Decode batch_buffer into newline-separated move strings (native harness / debugging)
+	std::string batch_to_string() const
+	{
+		std::string result;
+		std::vector<int> alg;
+		size_t pos = 0;
+		while (pos < batch_buffer.size())
+		{
+			size_t n = batch_buffer[pos++];
+			alg.assign(batch_buffer.begin() + pos, batch_buffer.begin() + pos + n);
+			pos += n;
+			result += AlgToString(alg);
+			result += "\n";
+		}
+		return result;
+	}
+
+#ifdef __EMSCRIPTEN__
+	// Zero-copy view of batch_buffer (Uint8Array over the WASM heap)
+	// Valid until the next batch call; copy it with .slice() before keeping it
+	emscripten::val get_batch_buffer() const
+	{
+		return emscripten::val(emscripten::typed_memory_view(batch_buffer.size(), batch_buffer.data()));
+	}
+#endif
+
 	std::string func(std::string arg_scramble = "", std::string arg_length = "7")
 	{
 		std::string ret = arg_scramble + start_search(arg_scramble) + "," + get_xxcross_scramble(arg_length);
@@ -4447,6 +5217,233 @@ struct xxcross_search
 	}
 };
 
+// ============================================================================
+// Bucket Model Calibration
+// ============================================================================
+
+// Build the database with the given buckets and mirror mode and record peak
+// memory, achieved load factors, nodes per depth and which depths were capped. Natively run each configuration in its own
+// process (see run_calibration_sweep) so the peak is not shared between runs;
+// in WASM use a fresh module instance per configuration (the heap never shrinks).
+CalibrationRecord calibrate_bucket_model(size_t d7, size_t d8, size_t d9, size_t d10, bool mirrored, bool verbose = false)
+{
+	BucketConfig bucket_config;
+	bucket_config.model = BucketModel::CUSTOM;
+	bucket_config.custom_bucket_7 = d7;
+	bucket_config.custom_bucket_8 = d8;
+	bucket_config.custom_bucket_9 = d9;
+	bucket_config.custom_bucket_10 = d10;
+
+	ResearchConfig research_config;
+	research_config.enable_custom_buckets = true;
+	research_config.high_memory_wasm_mode = true;
+	research_config.ignore_memory_limits = true;
+	research_config.developer_memory_limit_mb = 0;
+	research_config.skip_search = true;
+	research_config.enable_mirror_reduction = mirrored;
+
+	MemoryTimeline &timeline = MemoryTimeline::instance();
+	timeline.start(65536, 5);
+
+	CalibrationRecord record;
+	record.platform = calibration_platform();
+	record.d7 = d7;
+	record.d8 = d8;
+	record.d9 = d9;
+	record.d10 = d10;
+	{
+		xxcross_search solver(true, 6, 4096, verbose, bucket_config, research_config);
+		for (size_t d = 0; d < solver.index_pairs.size(); ++d)
+		{
+			record.nodes_per_depth.push_back(solver.index_pairs[d].size());
+			record.capped_per_depth.push_back(d < solver.capped_list.size() && solver.capped_list[d]);
+		}
+		record.mirrored = solver.mirror_.enabled;
+	}
+	timeline.stop();
+
+	// Peak from the sampler (RSS natively, heap size in WASM)
+	size_t peak_bytes = 0;
+	std::string csv = timeline.to_csv();
+	std::istringstream lines(csv);
+	std::string line;
+	std::getline(lines, line); // header
+	while (std::getline(lines, line))
+	{
+		// t_ms,"phase",marker,rss_kb,heap_bytes,...
+		size_t q = line.find('"', line.find('"') + 1);
+		std::istringstream fields(line.substr(q + 2));
+		std::string marker, rss_kb, heap_bytes;
+		std::getline(fields, marker, ',');
+		std::getline(fields, rss_kb, ',');
+		std::getline(fields, heap_bytes, ',');
+		peak_bytes = std::max<size_t>(peak_bytes, std::stoull(rss_kb) * 1024);
+		peak_bytes = std::max<size_t>(peak_bytes, std::stoull(heap_bytes));
+	}
+	peak_bytes = std::max<size_t>(peak_bytes, get_peak_rss_kb() * 1024);
+	record.peak_rss_mb = (peak_bytes + (1 << 20) - 1) >> 20;
+
+	auto nodes_at = [&](int depth) -> size_t {
+		return static_cast<size_t>(depth) < record.nodes_per_depth.size() ? record.nodes_per_depth[depth] : 0;
+	};
+	auto load_of = [&](int depth, size_t bucket) -> double {
+		return bucket > 0 ? static_cast<double>(nodes_at(depth)) / bucket : 0.0;
+	};
+	record.load_d7 = load_of(7, d7);
+	record.load_d8 = load_of(8, d8);
+	record.load_d9 = load_of(9, d9);
+	record.load_d10 = load_of(10, d10);
+
+	// Same memory model as determine_bucket_sizes(): cur_set + n+1 + n+2
+	size_t n7 = nodes_at(7), n8 = nodes_at(8);
+	size_t calculated = nodes_at(6) * BYTES_PER_NODE
+					  + n7 * 24 + d7 * 4
+					  + n8 * 24 + d8 * 4 + (n8 / 12) * 8;
+	record.memory_factor = calculated > 0 ? static_cast<double>(peak_bytes) / calculated : 0.0;
+
+	return record;
+}
+
+// Parse "presets" or a comma-separated list of "7M/8M/9M[/10M]" bucket specs
+std::vector<std::vector<size_t>> parse_calibration_spec(const std::string &spec)
+{
+	std::vector<std::vector<size_t>> configs;
+	if (spec == "presets" || spec == "1")
+	{
+		const BucketModel presets[] = {BucketModel::MINIMAL, BucketModel::LOW, BucketModel::BALANCED,
+									   BucketModel::MEDIUM, BucketModel::STANDARD, BucketModel::HIGH};
+		for (BucketModel model : presets)
+		{
+			const ModelData &m = get_base_model_data().at(model);
+			configs.push_back({m.d7, m.d8, m.d9, m.d10});
+		}
+		ModelData ultra = get_ultra_high_config(false);
+		configs.push_back({ultra.d7, ultra.d8, ultra.d9, ultra.d10});
+		return configs;
+	}
+
+	std::istringstream entries(spec);
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		std::vector<size_t> buckets;
+		std::istringstream parts(entry);
+		std::string part;
+		while (std::getline(parts, part, '/'))
+		{
+			if (!part.empty())
+				buckets.push_back(static_cast<size_t>(std::stoi(part)) << 20);
+		}
+		if (buckets.size() == 3)
+			buckets.push_back(0);
+		if (buckets.size() == 4)
+			configs.push_back(buckets);
+		else
+			std::cerr << "Warning: Ignoring calibration entry '" << entry << "'" << std::endl;
+	}
+	return configs;
+}
+
+#ifndef __EMSCRIPTEN__
+// Calibrate each configuration with and without mirror reduction, each build
+// in a forked child (isolated peak RSS), and add the results to
+// CalibrationTable.
+size_t run_calibration_sweep(const std::vector<std::vector<size_t>> &configs, bool verbose)
+{
+	size_t measured = 0;
+	for (const auto &b : configs)
+	{
+		for (bool mirrored : {false, true})
+		{
+			std::cout << "[Calibration] " << (b[0] >> 20) << "M/" << (b[1] >> 20) << "M/" << (b[2] >> 20) << "M";
+			if (b[3] > 0)
+				std::cout << "/" << (b[3] >> 20) << "M";
+			std::cout << (mirrored ? " mirrored" : "") << " ..." << std::flush;
+
+			int fds[2];
+			if (pipe(fds) != 0)
+			{
+				std::cerr << " pipe() failed" << std::endl;
+				break;
+			}
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				close(fds[0]);
+				if (!verbose && std::freopen("/dev/null", "w", stdout) == nullptr)
+					std::cerr << " (stdout not redirected)";
+				std::string json;
+				try
+				{
+					json = CalibrationTable::record_to_json(calibrate_bucket_model(b[0], b[1], b[2], b[3], mirrored, verbose));
+				}
+				catch (const std::exception &e)
+				{
+					std::cerr << " failed: " << e.what() << std::endl;
+				}
+				ssize_t written = write(fds[1], json.data(), json.size());
+				(void)written;
+				close(fds[1]);
+				_exit(json.empty() ? 1 : 0);
+			}
+			close(fds[1]);
+			std::string json;
+			char buf[4096];
+			ssize_t n;
+			while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+				json.append(buf, static_cast<size_t>(n));
+			close(fds[0]);
+			int status = 0;
+			waitpid(pid, &status, 0);
+
+			if (pid > 0 && CalibrationTable::instance().load_json(json) > 0)
+			{
+				const CalibrationRecord *r = CalibrationTable::instance().find(b[0], b[1], b[2], b[3], mirrored);
+				std::cout << " peak " << r->peak_rss_mb << " MB, load " << std::fixed << std::setprecision(3)
+						  << r->load_d7 << (r->capped(7) ? "" : " (fits)") << "/"
+						  << r->load_d8 << (r->capped(8) ? "" : " (fits)") << "/"
+						  << r->load_d9 << (r->capped(9) ? "" : " (fits)")
+						  << ", nodes " << r->total_nodes() << std::defaultfloat << std::endl;
+				measured++;
+			}
+			else
+			{
+				std::cout << " FAILED" << std::endl;
+			}
+		}
+	}
+	g_expansion_params.apply_calibration(CalibrationTable::instance());
+	return measured;
+}
+#endif
+
+// Load calibration records from JSON (CalibrationTable::to_json format)
+int load_calibration_json(std::string json)
+{
+	size_t added = CalibrationTable::instance().load_json(json);
+	g_expansion_params.apply_calibration(CalibrationTable::instance());
+	return static_cast<int>(added);
+}
+
+std::string get_calibration_json()
+{
+	return CalibrationTable::instance().to_json();
+}
+
+// WASM entry point: calibrate one configuration (MB units) in one mirror mode,
+// returns record JSON
+std::string calibrate_bucket_model_json(int bucket_7_mb, int bucket_8_mb, int bucket_9_mb, int bucket_10_mb, bool mirrored)
+{
+	CalibrationRecord r = calibrate_bucket_model(static_cast<size_t>(bucket_7_mb) << 20,
+												 static_cast<size_t>(bucket_8_mb) << 20,
+												 static_cast<size_t>(bucket_9_mb) << 20,
+												 static_cast<size_t>(bucket_10_mb) << 20,
+												 mirrored);
+	CalibrationTable::instance().add(r);
+	g_expansion_params.apply_calibration(CalibrationTable::instance());
+	return CalibrationTable::record_to_json(r);
+}
+
 int main()
 {
 	// ============================================================================
@@ -4471,6 +5468,56 @@ int main()
 		std::cout << "VERBOSE: " << (verbose ? "true" : "false") << " (from env)" << std::endl;
 	}
 	
+	// Read CALIBRATION_FILE (measured bucket model data, JSON from calibration mode)
+	const char *env_calibration_file = std::getenv("CALIBRATION_FILE");
+	if (env_calibration_file != nullptr)
+	{
+		std::ifstream in(env_calibration_file);
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+		int loaded = load_calibration_json(buffer.str());
+		std::cout << "CALIBRATION_FILE: " << env_calibration_file << " (" << loaded << " records)" << std::endl;
+	}
+	
+	// Read CALIBRATE / CALIBRATION_OUT (calibration mode: sweep bucket models and exit)
+	// CALIBRATE=presets or CALIBRATE=2M/4M/4M,4M/8M/8M/4M
+	// CALIBRATION_OUT=*.h writes calibration_data.h source, anything else JSON
+	const char *env_calibrate = std::getenv("CALIBRATE");
+	if (env_calibrate != nullptr)
+	{
+#ifndef __EMSCRIPTEN__
+		std::cout << "CALIBRATE: " << env_calibrate << " (from env)" << std::endl;
+		size_t measured = run_calibration_sweep(parse_calibration_spec(env_calibrate), false);
+		std::cout << "Calibrated " << measured << " configuration(s)" << std::endl;
+		
+		const char *env_calibration_out = std::getenv("CALIBRATION_OUT");
+		std::string out_path = env_calibration_out != nullptr ? env_calibration_out : "";
+		bool as_header = out_path.size() >= 2 && out_path.compare(out_path.size() - 2, 2, ".h") == 0;
+		std::string output = as_header ? CalibrationTable::instance().to_header() : CalibrationTable::instance().to_json();
+		if (out_path.empty())
+		{
+			std::cout << output;
+		}
+		else
+		{
+			std::ofstream out(out_path);
+			out << output;
+			std::cout << "Calibration written to " << out_path << std::endl;
+		}
+		
+		const bool mirrored = ResearchConfig().enable_mirror_reduction;
+		std::cout << "AUTO selection with calibration" << (mirrored ? " (mirrored)" : "") << ":" << std::endl;
+		for (size_t budget : {200, 300, 500, 800, 1200, 2000})
+		{
+			BucketModel model = select_model(budget, mirrored);
+			ModelData m = (model == BucketModel::ULTRA_HIGH) ? get_ultra_high_config(mirrored) : get_measured_data(mirrored).at(model);
+			std::cout << "  budget " << budget << " MB -> " << (m.d7 >> 20) << "M/" << (m.d8 >> 20) << "M/" << (m.d9 >> 20)
+					  << "M (peak " << m.measured_rss_mb << " MB)" << std::endl;
+		}
+		return 0;
+#endif
+	}
+	
 	// Bucket configuration
 	BucketConfig bucket_config;
 	ResearchConfig research_config;
@@ -4555,6 +5602,28 @@ int main()
 		std::cout << "DISABLE_MALLOC_TRIM: " << research_config.disable_malloc_trim << " (from env)" << std::endl;
 	}
 	
+	// Read NODE_ARENA flag (0 = node containers use malloc instead of the arena)
+	const char *env_node_arena = std::getenv("NODE_ARENA");
+	if (env_node_arena != nullptr)
+	{
+		research_config.use_node_arena = !(std::string(env_node_arena) == "0" ||
+		                                   std::string(env_node_arena) == "false" ||
+		                                   std::string(env_node_arena) == "False" ||
+		                                   std::string(env_node_arena) == "FALSE");
+		std::cout << "NODE_ARENA: " << research_config.use_node_arena << " (from env)" << std::endl;
+	}
+	
+	// Read MIRROR_REDUCTION flag (0 = store both L/R mirror images)
+	const char *env_mirror_reduction = std::getenv("MIRROR_REDUCTION");
+	if (env_mirror_reduction != nullptr)
+	{
+		research_config.enable_mirror_reduction = !(std::string(env_mirror_reduction) == "0" ||
+		                                            std::string(env_mirror_reduction) == "false" ||
+		                                            std::string(env_mirror_reduction) == "False" ||
+		                                            std::string(env_mirror_reduction) == "FALSE");
+		std::cout << "MIRROR_REDUCTION: " << research_config.enable_mirror_reduction << " (from env)" << std::endl;
+	}
+	
 	// Read SKIP_SEARCH flag (exit after database construction)
 	const char *env_skip_search = std::getenv("SKIP_SEARCH");
 	if (env_skip_search != nullptr)
@@ -4575,18 +5644,106 @@ int main()
 		std::cout << "BENCHMARK_ITERATIONS: " << research_config.benchmark_iterations << " (from env)" << std::endl;
 	}
 	
+	// Read BATCH_SCRAMBLES / BATCH_DEPTH / BATCH_THREADS (batch scramble generation benchmark)
+	int batch_scrambles = 0;
+	int batch_depth = 8;
+	int batch_threads = 0; // 0 = hardware_concurrency
+	const char *env_batch_scrambles = std::getenv("BATCH_SCRAMBLES");
+	if (env_batch_scrambles != nullptr)
+	{
+		batch_scrambles = std::atoi(env_batch_scrambles);
+		std::cout << "BATCH_SCRAMBLES: " << batch_scrambles << " (from env)" << std::endl;
+	}
+	const char *env_batch_depth = std::getenv("BATCH_DEPTH");
+	if (env_batch_depth != nullptr)
+	{
+		batch_depth = std::atoi(env_batch_depth);
+		std::cout << "BATCH_DEPTH: " << batch_depth << " (from env)" << std::endl;
+	}
+	const char *env_batch_threads = std::getenv("BATCH_THREADS");
+	if (env_batch_threads != nullptr)
+	{
+		batch_threads = std::atoi(env_batch_threads);
+		std::cout << "BATCH_THREADS: " << batch_threads << " (from env)" << std::endl;
+	}
+	// BATCH_CONSTRAINTS switches the batch to generate_constrained_batch (BATCH_DEPTH unused)
+	std::string batch_constraints;
+	const char *env_batch_constraints = std::getenv("BATCH_CONSTRAINTS");
+	if (env_batch_constraints != nullptr)
+	{
+		batch_constraints = env_batch_constraints;
+		std::cout << "BATCH_CONSTRAINTS: " << batch_constraints << " (from env)" << std::endl;
+	}
+	
+	// Read MEMORY_TIMELINE / MEMORY_TIMELINE_INTERVAL_MS (in-process RSS sampler)
+	// Output format follows the extension: *.json = JSON, anything else = CSV
+	std::string memory_timeline_path;
+	int memory_timeline_interval_ms = 10;
+	const char *env_memory_timeline = std::getenv("MEMORY_TIMELINE");
+	if (env_memory_timeline != nullptr)
+	{
+		memory_timeline_path = env_memory_timeline;
+		std::cout << "MEMORY_TIMELINE: " << memory_timeline_path << " (from env)" << std::endl;
+	}
+	const char *env_memory_timeline_interval = std::getenv("MEMORY_TIMELINE_INTERVAL_MS");
+	if (env_memory_timeline_interval != nullptr)
+	{
+		memory_timeline_interval_ms = std::atoi(env_memory_timeline_interval);
+		std::cout << "MEMORY_TIMELINE_INTERVAL_MS: " << memory_timeline_interval_ms << " (from env)" << std::endl;
+	}
+	
 	// ============================================================================
 	// Create solver instance
 	// ============================================================================
 	
+	if (!memory_timeline_path.empty())
+	{
+		MemoryTimeline::instance().start(65536, memory_timeline_interval_ms);
+	}
+	
 	xxcross_search xxcross_solver(true, 6, memory_limit, verbose, bucket_config, research_config);
 	std::string result;
 	
+	if (!memory_timeline_path.empty())
+	{
+		MemoryTimeline::instance().stop();
+		bool as_json = memory_timeline_path.size() >= 5 &&
+		               memory_timeline_path.compare(memory_timeline_path.size() - 5, 5, ".json") == 0;
+		std::ofstream timeline_out(memory_timeline_path);
+		timeline_out << (as_json ? MemoryTimeline::instance().to_json() : MemoryTimeline::instance().to_csv());
+		std::cout << "Memory timeline: " << MemoryTimeline::instance().size() << " samples written to "
+		          << memory_timeline_path << std::endl;
+	}
+	
 	// Measure RSS after database construction (before search)
 	std::cout << "\n=== RSS After Database Construction ===" << std::endl;
 	std::cout << "RSS (before any search): " << (get_rss_kb() / 1024.0) << " MB" << std::endl;
 	std::cout << "========================================" << std::endl;
 	
+	// Batch scramble generation (quiet mode, single call)
+	if (batch_scrambles > 0)
+	{
+		xxcross_solver.set_quiet(true);
+		auto batch_start = std::chrono::steady_clock::now();
+		int produced = batch_constraints.empty()
+			? xxcross_solver.generate_scramble_batch(batch_scrambles, batch_depth, batch_threads)
+			: xxcross_solver.generate_constrained_batch(batch_constraints, batch_scrambles, 100000);
+		auto batch_end = std::chrono::steady_clock::now();
+		double batch_ms = std::chrono::duration<double, std::milli>(batch_end - batch_start).count();
+		xxcross_solver.set_quiet(false);
+		
+		std::cout << "\n=== Batch Scramble Generation ===" << std::endl;
+		std::cout << "Produced: " << produced << " / " << batch_scrambles << " ("
+		          << (batch_constraints.empty() ? "depth " + std::to_string(batch_depth) : batch_constraints) << ")" << std::endl;
+		std::cout << "Packed buffer: " << xxcross_solver.batch_buffer.size() << " bytes" << std::endl;
+		std::cout << "Time: " << batch_ms << " ms (" << (produced > 0 ? batch_ms / produced : 0.0) << " ms/scramble)" << std::endl;
+		if (verbose)
+		{
+			std::cout << xxcross_solver.batch_to_string();
+		}
+		std::cout << "=================================" << std::endl;
+	}
+	
 	// Check if we should skip search (measurement only mode)
 	if (research_config.skip_search) {
 		std::cout << "\n[SKIP_SEARCH enabled - exiting after database construction]" << std::endl;
@@ -4809,6 +5966,23 @@ SolverStatistics get_solver_statistics() {
 	return g_solver_stats;
 }
 
+// Memory timeline (call start before constructing xxcross_search)
+void start_memory_timeline(int capacity) {
+	MemoryTimeline::instance().start(capacity > 0 ? static_cast<size_t>(capacity) : 65536);
+}
+
+void stop_memory_timeline() {
+	MemoryTimeline::instance().stop();
+}
+
+std::string get_memory_timeline_csv() {
+	return MemoryTimeline::instance().to_csv();
+}
+
+std::string get_memory_timeline_json() {
+	return MemoryTimeline::instance().to_json();
+}
+
 EMSCRIPTEN_BINDINGS(my_module)
 {
 	// Simplified binding for Worker usage (like xcrossTrainer/solver.cpp)
@@ -4821,6 +5995,21 @@ EMSCRIPTEN_BINDINGS(my_module)
 		.constructor<bool, int, int, bool>() // adj, BFS_DEPTH, MEMORY_LIMIT_MB, verbose
 		.constructor<bool, int, int, int, int>() // adj, bucket_7_mb, bucket_8_mb, bucket_9_mb, bucket_10_mb (CUSTOM BUCKETS)
 		.function("func", &xxcross_search::func)
-		.function("get_scramble_length", &xxcross_search::get_scramble_length); // Helper: Calculate move count
+		.function("get_scramble_length", &xxcross_search::get_scramble_length) // Helper: Calculate move count
+		.function("set_quiet", &xxcross_search::set_quiet)
+		.function("generate_scramble_batch", &xxcross_search::generate_scramble_batch)					 // count, depth, num_threads (ignored in WASM)
+		.function("generate_scramble_batch_histogram", &xxcross_search::generate_scramble_batch_histogram) // "7:100,8:200", num_threads
+		.function("generate_constrained_batch", &xxcross_search::generate_constrained_batch)			 // "xxcross=8,cross>=6", count, max_draws
+		.function("get_batch_buffer", &xxcross_search::get_batch_buffer)								 // Uint8Array view: [n][moves...] per scramble
+		.function("batch_to_string", &xxcross_search::batch_to_string);
+
+	emscripten::function("start_memory_timeline", &start_memory_timeline); // capacity (samples, 0 = 65536)
+	emscripten::function("stop_memory_timeline", &stop_memory_timeline);
+	emscripten::function("get_memory_timeline_csv", &get_memory_timeline_csv);
+	emscripten::function("get_memory_timeline_json", &get_memory_timeline_json);
+
+	emscripten::function("calibrate_bucket_model", &calibrate_bucket_model_json); // bucket_7_mb, bucket_8_mb, bucket_9_mb, bucket_10_mb, mirrored -> record JSON
+	emscripten::function("load_calibration_json", &load_calibration_json);        // JSON string -> records loaded
+	emscripten::function("get_calibration_json", &get_calibration_json);
 }
 #endif
\ No newline at end of file